@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    BusyPollBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Busy-poll Receive Benchmark
+ * @author  Satoh
+ * @note    ループバック上の小メッセージ往復遅延を、ブロッキング受信と
+ *          ビジーポーリング受信で比較し p50 / p99 / p99.9 を表示する。
+ *          ビジーポーリングは 1 スレッドにつき 1 コアを占有するため、
+ *          2 コア以上の環境で実行すること
+ *
+ *          g++ -std=c++17 -O2 -I../include BusyPollBench.cpp -o BusyPollBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "SBDPSocket.h"
+
+namespace {
+
+    constexpr unsigned short k_unBasePort   = 39200;
+    constexpr std::size_t    k_unWarmup     = 2000;
+    constexpr std::size_t    k_unRoundTrips = 50000;
+    constexpr uint64_t       k_unSpinBudgetUs = 200;
+
+    /******************************************************************************
+     * @brief   パーセンタイル値（マイクロ秒）の取得
+     * @arg     vecSortedNs (in) 昇順に並べた計測値（ナノ秒）
+     * @arg     unPerMille  (in) パーセンタイル（千分率）
+     * @return  マイクロ秒
+     * @note
+     *****************************************************************************/
+    sbdp::float64_t Percentile(const std::vector<int64_t>& vecSortedNs, std::size_t unPerMille) {
+        std::size_t unIndex = std::min(vecSortedNs.size() - 1, vecSortedNs.size() * unPerMille / 1000);
+        return static_cast<sbdp::float64_t>(vecSortedNs[unIndex]) / 1000.0;
+    }
+
+    /******************************************************************************
+     * @brief   1 モードの計測
+     * @arg     pszName   (in) モード名
+     * @arg     bBusyPoll (in) true:ビジーポーリング受信
+     * @arg     unPort    (in) 使用するポート
+     * @return  なし
+     * @note    クライアント・サーバーとも同じ受信モードを使い、
+     *          2 コア以上あればそれぞれ別コアへ固定する
+     *****************************************************************************/
+    void RunMode(const char* pszName, bool bBusyPoll, unsigned short unPort) {
+        const bool bPin = (std::thread::hardware_concurrency() >= 2);
+        sbdp::SocketOptions stOptions = sbdp::SocketOptions::LowLatency();
+        stOptions.bReuseAddress = true;
+        sbdp::Socket cListener;
+        if (!cListener.Create(stOptions) || !cListener.Bind(unPort) || !cListener.Listen()) {
+            std::printf("%s: listen failed\n", pszName);
+            return;
+        }
+
+        std::thread thrServer([&cListener, bBusyPoll, bPin]() {
+            if (bPin) {
+                sbdp::PinCurrentThread(1);
+            }
+            sbdp::Socket cPeer = cListener.Accept();
+            if (bBusyPoll) {
+                cPeer.SetBusyPoll(k_unSpinBudgetUs);
+            }
+            std::vector<uint8_t> vecFrame;
+            for (std::size_t unIndex = 0; unIndex < k_unWarmup + k_unRoundTrips; ++unIndex) {
+                cPeer.RecvFrame(vecFrame);
+                cPeer.SendAll(vecFrame.data(), vecFrame.size());
+            }
+        });
+
+        if (bPin) {
+            sbdp::PinCurrentThread(0);
+        }
+        sbdp::Socket cClient;
+        if (!cClient.Create(stOptions) || !cClient.Connect("127.0.0.1", unPort)) {
+            std::printf("%s: connect failed\n", pszName);
+            thrServer.detach();
+            return;
+        }
+        if (bBusyPoll) {
+            cClient.SetBusyPoll(k_unSpinBudgetUs);
+        }
+
+        sbdp::Message msgOrder;
+        msgOrder["px"] = static_cast<int64_t>(1012500);
+        msgOrder["qty"] = static_cast<uint64_t>(100);
+        msgOrder["sym"] = std::string("7203");
+        sbdp::SharedFrame cOrder = sbdp::SharedFrame::Encode(msgOrder);
+        std::vector<uint8_t> vecReply;
+        std::vector<int64_t> vecLatencyNs;
+        vecLatencyNs.reserve(k_unRoundTrips);
+        for (std::size_t unIndex = 0; unIndex < k_unWarmup + k_unRoundTrips; ++unIndex) {
+            auto tpBegin = std::chrono::steady_clock::now();
+            cClient.SendFrame(cOrder);
+            cClient.RecvFrame(vecReply);
+            if (unIndex >= k_unWarmup) {
+                vecLatencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - tpBegin).count());
+            }
+        }
+        thrServer.join();
+        std::sort(vecLatencyNs.begin(), vecLatencyNs.end());
+        std::printf("%-10s rtt p50 %7.2f us  p99 %7.2f us  p99.9 %7.2f us%s\n", pszName,
+                    Percentile(vecLatencyNs, 500), Percentile(vecLatencyNs, 990),
+                    Percentile(vecLatencyNs, 999), bPin ? "" : "  (single core, not pinned)");
+    }
+
+} // namespace
+
+int main() {
+    RunMode("blocking", false, k_unBasePort);
+    RunMode("busy-poll", true, k_unBasePort + 1);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    ConnectBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Connect Benchmark
+ * @author  Satoh
+ * @note    短命クライアント（接続→1 往復→切断）の初回応答までの時間を、
+ *          従来の Connect・並列試行の Connect・TCP Fast Open で比較する。
+ *          TFO はループバックでも 1 往復分（SYN→SYN/ACK 待ち）が省かれる。
+ *          サーバー側 TFO には net.ipv4.tcp_fastopen=3（クライアント 1 + サーバー 2）が必要
+ *
+ *          g++ -std=c++17 -O2 -I../include ConnectBench.cpp -o ConnectBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPSocket.h"
+
+namespace {
+
+    constexpr unsigned short k_unPort        = 39200;
+    constexpr std::size_t    k_unConnections = 2000;
+
+    // 接続方法
+    enum class ConnectMode : uint8_t {
+        Plain = 0,      // Create + Connect(host, port) + SendFrame
+        Staggered,      // Connect(host, port, ConnectOptions)
+        FastOpen,       // Connect(host, port, ConnectOptions{bFastOpen = true})
+    };
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName (in) 方式名
+     * @arg     eMode   (in) 接続方法
+     * @arg     cFrame  (in) 要求フレーム
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunMode(const char* pszName, ConnectMode eMode, const sbdp::SharedFrame& cFrame) {
+        std::vector<int64_t> vecLatencyNs;
+        vecLatencyNs.reserve(k_unConnections);
+        for (std::size_t unIndex = 0; unIndex < k_unConnections; ++unIndex) {
+            auto tpBegin = std::chrono::steady_clock::now();
+            sbdp::Socket cClient;
+            bool bConnected = false;
+            if (eMode == ConnectMode::Plain) {
+                bConnected = cClient.Create() && cClient.Connect("127.0.0.1", k_unPort);
+                if (bConnected) {
+                    cClient.SendFrame(cFrame);
+                }
+            }
+            else {
+                sbdp::ConnectOptions stConnect;
+                stConnect.unTimeoutMs = 1000;
+                stConnect.bFastOpen = (eMode == ConnectMode::FastOpen);
+                stConnect.cFirstFrame = cFrame;
+                bConnected = cClient.Connect("127.0.0.1", k_unPort, stConnect);
+            }
+            if (!bConnected) {
+                std::printf("%s: connect failed\n", pszName);
+                return;
+            }
+            std::vector<uint8_t> vecReply;
+            cClient.RecvFrame(vecReply, 1000);
+            vecLatencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - tpBegin).count());
+        }
+        std::sort(vecLatencyNs.begin(), vecLatencyNs.end());
+        std::printf("%-12s first response p50 %7.1f us  p99 %7.1f us\n", pszName,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() / 2]) / 1000.0,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() * 99 / 100]) / 1000.0);
+    }
+
+} // namespace
+
+int main() {
+    sbdp::SocketOptions stListenOptions;
+    stListenOptions.bReuseAddress = true;
+    stListenOptions.snFastOpenQueue = 256;
+    sbdp::Socket cListener;
+    if (!cListener.Create(stListenOptions) || !cListener.Bind(k_unPort) || !cListener.Listen()) {
+        std::printf("listen failed\n");
+        return 1;
+    }
+    if (cListener.GetEffectiveOptions().snFastOpenQueue.value_or(0) == 0) {
+        std::printf("note: TCP Fast Open is not enabled on the listener\n");
+    }
+
+    // サーバー側：受け入れた接続ごとに 1 フレームをエコーして閉じる
+    std::atomic<bool> bStop(false);
+    std::thread thrServer([&cListener, &bStop]() {
+        std::vector<uint8_t> vecFrame;
+        while (!bStop.load()) {
+            try {
+                sbdp::Socket cPeer = cListener.Accept();
+                if (cPeer.RecvFrame(vecFrame, 1000)) {
+                    cPeer.SendAll(vecFrame.data(), vecFrame.size());
+                }
+            }
+            catch (const std::exception&) {
+                break;
+            }
+        }
+    });
+
+    sbdp::Message msgRequest;
+    msgRequest["op"] = std::string("get");
+    msgRequest["key"] = std::string("user:1001");
+    sbdp::SharedFrame cRequest = sbdp::SharedFrame::Encode(msgRequest);
+    RunMode("plain", ConnectMode::Plain, cRequest);
+    RunMode("staggered", ConnectMode::Staggered, cRequest);
+    RunMode("fast-open", ConnectMode::FastOpen, cRequest);
+
+    bStop.store(true);
+    cListener.Shutdown();
+    thrServer.join();
+    return 0;
+}
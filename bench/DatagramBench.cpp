@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    DatagramBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Datagram Benchmark
+ * @author  Satoh
+ * @note    ループバック上で小さなメトリクスメッセージを UDP で送り、
+ *          1 データグラムずつの送信と sendmmsg / recvmmsg でのまとめ送受信の
+ *          メッセージレートとシステムコール数を比較する。
+ *          UDP のため受信側が追いつかない分は破棄される（loss として表示）
+ *
+ *          g++ -std=c++17 -O2 -I../include DatagramBench.cpp -o DatagramBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPDatagram.h"
+
+namespace {
+
+    constexpr unsigned short k_unBasePort = 39300;
+    constexpr std::size_t    k_unMessages = 2000000;
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName  (in) 方式名
+     * @arg     bBatched (in) true:EnqueueFrame + Flush false:SendFrame
+     * @arg     unPort   (in) 使用するポート
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunMode(const char* pszName, bool bBatched, unsigned short unPort) {
+        sbdp::SocketOptions stOptions;
+        stOptions.snRecvBufferBytes = 8 * 1024 * 1024;
+        stOptions.snSendBufferBytes = 8 * 1024 * 1024;
+        sbdp::DatagramSocket cReceiver;
+        sbdp::DatagramSocket cSender;
+        if (!cReceiver.Create(stOptions) || !cReceiver.Bind("127.0.0.1", unPort) ||
+            !cSender.Create(stOptions) || !cSender.Connect("127.0.0.1", unPort)) {
+            std::printf("%s: socket setup failed\n", pszName);
+            return;
+        }
+
+        // 受信側：送信完了後、100 ms 何も届かなくなるまで受信する
+        std::atomic<bool> bSenderDone(false);
+        uint64_t unReceived = 0;
+        std::chrono::steady_clock::time_point tpLastReceive;
+        std::thread thrReceiver([&]() {
+            std::vector<std::vector<uint8_t>> vecFrames;
+            for (;;) {
+                std::size_t unCount = cReceiver.ReceiveBatch(vecFrames, 100);
+                if (unCount == 0) {
+                    if (bSenderDone.load()) {
+                        break;
+                    }
+                    continue;
+                }
+                unReceived += unCount;
+                tpLastReceive = std::chrono::steady_clock::now();
+            }
+        });
+
+        sbdp::Message msgMetric;
+        msgMetric["name"] = std::string("rpc.latency_us");
+        msgMetric["host"] = std::string("app-01");
+        msgMetric["value"] = static_cast<uint64_t>(123);
+        sbdp::SharedFrame cFrame = sbdp::SharedFrame::Encode(msgMetric);
+
+        auto tpBegin = std::chrono::steady_clock::now();
+        for (std::size_t unIndex = 0; unIndex < k_unMessages; ++unIndex) {
+            if (bBatched) {
+                cSender.EnqueueFrame(cFrame);
+            }
+            else {
+                cSender.SendFrame(cFrame);
+            }
+        }
+        cSender.Flush();
+        std::chrono::duration<sbdp::float64_t> durSend = std::chrono::steady_clock::now() - tpBegin;
+        bSenderDone.store(true);
+        thrReceiver.join();
+        std::chrono::duration<sbdp::float64_t> durReceive = tpLastReceive - tpBegin;
+
+        const sbdp::DatagramStats& stSendStats = cSender.GetStats();
+        const sbdp::DatagramStats& stRecvStats = cReceiver.GetStats();
+        std::printf("%-10s send %6.2f Mmsg/s (%8llu calls)  recv %6.2f Mmsg/s (%8llu calls)  loss %5.1f%%\n",
+                    pszName,
+                    static_cast<sbdp::float64_t>(stSendStats.unSent) / durSend.count() / 1e6,
+                    static_cast<unsigned long long>(stSendStats.unSendCalls),
+                    static_cast<sbdp::float64_t>(unReceived) / durReceive.count() / 1e6,
+                    static_cast<unsigned long long>(stRecvStats.unRecvCalls),
+                    100.0 * static_cast<sbdp::float64_t>(k_unMessages - unReceived) /
+                        static_cast<sbdp::float64_t>(k_unMessages));
+    }
+
+} // namespace
+
+int main() {
+    RunMode("single", false, k_unBasePort);
+    RunMode("batched", true, k_unBasePort + 1);
+    return 0;
+}
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    HedgingBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Request Hedging Benchmark
+ * @author  Satoh
+ * @note    ループバック上の 3 台のバックエンドが、まれに（1%）10 ms 遅れて応答する
+ *          状況で、ヘッジなしとヘッジあり（p95 遅延後に別のバックエンドへ重ねて送る）の
+ *          要求遅延のパーセンタイルとヘッジの割合を比較する。
+ *          要求は 0.5 ms 間隔で 1 件ずつ送る
+ *
+ *          g++ -std=c++17 -O2 -I../include HedgingBench.cpp -o HedgingBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPRequest.h"
+
+namespace {
+
+    constexpr unsigned short k_unBasePort   = 39600;
+    constexpr std::size_t    k_unBackends   = 3;
+    constexpr std::size_t    k_unRequests   = 10000;
+    constexpr uint32_t       k_unSlowPerMil = 10;
+    constexpr int64_t        k_snSlowMs     = 10;
+    constexpr int64_t        k_snIntervalUs = 500;
+
+    /******************************************************************************
+     * @brief   バックエンド（1 接続ずつ受け、"$rid" を付けて応答する）
+     * @arg     cListener (in) リスナー
+     * @arg     unSeed    (in) 遅延発生の乱数シード
+     * @return  なし
+     * @note    取り消し要求は読み捨てる。切断されたら次の接続を待つ
+     *****************************************************************************/
+    void RunBackend(sbdp::Socket& cListener, uint32_t unSeed) {
+        std::mt19937 cRandom(unSeed);
+        std::uniform_int_distribution<uint32_t> cPerMil(0, 999);
+        for (;;) {
+            sbdp::Socket cPeer;
+            try {
+                cPeer = cListener.Accept();
+            }
+            catch (const std::exception&) {
+                return;
+            }
+            std::vector<uint8_t> vecFrame;
+            try {
+                while (cPeer.RecvFrame(vecFrame)) {
+                    uint64_t unRequestId = 0;
+                    if (sbdp::IsCancelRequest(vecFrame) || !sbdp::GetRequestId(vecFrame, unRequestId)) {
+                        continue;
+                    }
+                    if (cPerMil(cRandom) < k_unSlowPerMil) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(k_snSlowMs));
+                    }
+                    sbdp::Message msgResponse;
+                    msgResponse[sbdp::k_pszRequestIdKey] = unRequestId;
+                    msgResponse["value"] = std::string("ok");
+                    cPeer.SendMessage(msgResponse);
+                }
+            }
+            catch (const std::exception&) {
+            }
+        }
+    }
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName  (in) 方式名
+     * @arg     stConfig (in) ヘッジング設定
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunMode(const char* pszName, const sbdp::HedgingConfig& stConfig) {
+        sbdp::SocketOptions stOptions;
+        stOptions.bNoDelay = true;
+        std::vector<sbdp::Socket> vecSockets(k_unBackends);
+        sbdp::HedgingClient cClient(stConfig);
+        for (std::size_t unIndex = 0; unIndex < k_unBackends; ++unIndex) {
+            if (!vecSockets[unIndex].Create(stOptions) ||
+                !vecSockets[unIndex].Connect("127.0.0.1", static_cast<unsigned short>(k_unBasePort + unIndex))) {
+                std::printf("%s: connect failed\n", pszName);
+                return;
+            }
+            cClient.AddEndpoint(vecSockets[unIndex]);
+        }
+
+        sbdp::Message msgRequest;
+        msgRequest["op"] = std::string("get");
+        msgRequest["key"] = std::string("user:1001");
+        sbdp::Message msgResponse;
+        std::vector<int64_t> vecLatencyUs;
+        vecLatencyUs.reserve(k_unRequests);
+        auto tpNext = std::chrono::steady_clock::now();
+        for (std::size_t unIndex = 0; unIndex < k_unRequests; ++unIndex) {
+            std::this_thread::sleep_until(tpNext);
+            tpNext += std::chrono::microseconds(k_snIntervalUs);
+            auto tpBegin = std::chrono::steady_clock::now();
+            if (!cClient.Call(msgRequest, msgResponse)) {
+                std::printf("%s: request failed\n", pszName);
+                return;
+            }
+            vecLatencyUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - tpBegin).count());
+        }
+        std::sort(vecLatencyUs.begin(), vecLatencyUs.end());
+        const sbdp::HedgingStats& stStats = cClient.GetStats();
+        std::printf("%-8s p50 %7.0f us  p99 %7.0f us  p99.9 %7.0f us  hedged %5.2f%% (won %llu, denied %llu)\n",
+                    pszName,
+                    static_cast<sbdp::float64_t>(vecLatencyUs[vecLatencyUs.size() / 2]),
+                    static_cast<sbdp::float64_t>(vecLatencyUs[vecLatencyUs.size() * 99 / 100]),
+                    static_cast<sbdp::float64_t>(vecLatencyUs[vecLatencyUs.size() * 999 / 1000]),
+                    100.0 * static_cast<sbdp::float64_t>(stStats.unHedges) / static_cast<sbdp::float64_t>(stStats.unRequests),
+                    static_cast<unsigned long long>(stStats.unHedgeWins),
+                    static_cast<unsigned long long>(stStats.unBudgetDenied));
+    }
+
+} // namespace
+
+int main() {
+    sbdp::SocketOptions stListenOptions;
+    stListenOptions.bReuseAddress = true;
+    stListenOptions.bNoDelay = true;
+    std::vector<sbdp::Socket> vecListeners(k_unBackends);
+    std::vector<std::thread> vecBackends;
+    for (std::size_t unIndex = 0; unIndex < k_unBackends; ++unIndex) {
+        if (!vecListeners[unIndex].Create(stListenOptions) ||
+            !vecListeners[unIndex].Bind(static_cast<unsigned short>(k_unBasePort + unIndex)) ||
+            !vecListeners[unIndex].Listen()) {
+            std::printf("listen failed\n");
+            return 1;
+        }
+    }
+    for (std::size_t unIndex = 0; unIndex < k_unBackends; ++unIndex) {
+        vecBackends.emplace_back(RunBackend, std::ref(vecListeners[unIndex]), static_cast<uint32_t>(unIndex + 1));
+    }
+
+    sbdp::HedgingConfig stNoHedge;
+    stNoHedge.dbMaxHedgeRatio = 0.0;
+    stNoHedge.dbMaxHedgeBurst = 0.0;
+    RunMode("none", stNoHedge);
+    RunMode("hedged", sbdp::HedgingConfig());
+
+    for (sbdp::Socket& cListener : vecListeners) {
+        cListener.Shutdown();
+    }
+    for (std::thread& thrBackend : vecBackends) {
+        thrBackend.join();
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    PriorityBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Send Priority Benchmark
+ * @author  Satoh
+ * @note    ループバック上で 1 MiB のフレームを送信キューに積み続けながら、1 ms ごとに
+ *          小さな制御メッセージを送り、その片道遅延（送信キュー投入から受信側で
+ *          取り出すまで）を、制御を大きなフレームと同じ Bulk で送る場合（到着順）と
+ *          Urgent で送る場合で比較する。
+ *          カーネルの送信バッファに入った分は追い越せないため、送信バッファは小さくする
+ *
+ *          g++ -std=c++17 -O2 -I../include PriorityBench.cpp -o PriorityBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include "SBDPFieldView.h"
+#include "SBDPSocket.h"
+
+namespace {
+
+    constexpr unsigned short k_unBasePort     = 39500;
+    constexpr std::size_t    k_unBulkFrames   = 256;
+    constexpr std::size_t    k_unBulkPayload  = 1024 * 1024;
+    constexpr int64_t        k_snPingPeriodNs = 1000000;
+
+    /******************************************************************************
+     * @brief   現在時刻（ナノ秒）の取得
+     * @arg     なし
+     * @return  steady_clock のナノ秒
+     * @note
+     *****************************************************************************/
+    int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName   (in) 方式名
+     * @arg     ePriority (in) 制御メッセージの送信優先度
+     * @arg     unPort    (in) 使用するポート
+     * @return  なし
+     * @note    送受信とも 1 スレッドで poll により駆動する
+     *****************************************************************************/
+    void RunMode(const char* pszName, sbdp::SendPriority ePriority, unsigned short unPort) {
+        sbdp::SocketOptions stListenOptions;
+        stListenOptions.bReuseAddress = true;
+        sbdp::Socket cListener;
+        sbdp::SocketOptions stClientOptions;
+        stClientOptions.snSendBufferBytes = 256 * 1024;
+        sbdp::Socket cClient;
+        if (!cListener.Create(stListenOptions) || !cListener.Bind(unPort) || !cListener.Listen() ||
+            !cClient.Create(stClientOptions) || !cClient.Connect("127.0.0.1", unPort)) {
+            std::printf("%s: socket setup failed\n", pszName);
+            return;
+        }
+        sbdp::Socket cServer = cListener.Accept();
+        cClient.SetNonBlocking(true);
+        cServer.SetNonBlocking(true);
+
+        sbdp::Message msgBulk;
+        msgBulk["blob"] = std::vector<uint8_t>(k_unBulkPayload, 0x5A);
+        sbdp::SharedFrame cBulk = sbdp::SharedFrame::Encode(msgBulk);
+        for (std::size_t unIndex = 0; unIndex < k_unBulkFrames; ++unIndex) {
+            cClient.EnqueueFrame(cBulk, sbdp::SendPriority::Bulk);
+        }
+
+        std::vector<int64_t> vecLatencyNs;
+        std::size_t unBulkReceived = 0;
+        int64_t snNextPingNs = NowNs();
+        int64_t snBeginNs = snNextPingNs;
+        std::vector<uint8_t> vecFrame;
+        while (unBulkReceived < k_unBulkFrames) {
+            int64_t snNowNs = NowNs();
+            if (snNowNs >= snNextPingNs) {
+                sbdp::Message msgPing;
+                msgPing["op"] = std::string("ping");
+                msgPing["t"] = static_cast<uint64_t>(snNowNs);
+                cClient.EnqueueFrame(sbdp::SharedFrame::Encode(msgPing), ePriority);
+                snNextPingNs += k_snPingPeriodNs;
+            }
+            cClient.FlushSendQueue();
+            cServer.ReceiveAvailable();
+            while (cServer.PopFrame(vecFrame)) {
+                sbdp::FieldView stTime;
+                if (sbdp::FindField(vecFrame, "t", stTime)) {
+                    vecLatencyNs.push_back(NowNs() - static_cast<int64_t>(stTime.AsUInt64()));
+                }
+                else {
+                    ++unBulkReceived;
+                }
+            }
+            pollfd stPoll[2] {};
+            stPoll[0].fd = cClient.GetHandle();
+            stPoll[0].events = POLLIN | ((cClient.GetPendingSendBytes() != 0) ? POLLOUT : 0);
+            stPoll[1].fd = cServer.GetHandle();
+            stPoll[1].events = POLLIN;
+            ::poll(stPoll, 2, 1);
+        }
+        int64_t snElapsedNs = NowNs() - snBeginNs;
+        std::sort(vecLatencyNs.begin(), vecLatencyNs.end());
+        if (vecLatencyNs.empty()) {
+            vecLatencyNs.push_back(0);
+        }
+        sbdp::float64_t dbMiB = static_cast<sbdp::float64_t>(cBulk.Size() * k_unBulkFrames) / (1024.0 * 1024.0);
+        std::printf("%-8s ping p50 %9.1f us  p99 %9.1f us  max %9.1f us  (%zu pings)   bulk %7.1f MiB/s\n",
+                    pszName,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() / 2]) / 1000.0,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() * 99 / 100]) / 1000.0,
+                    static_cast<sbdp::float64_t>(vecLatencyNs.back()) / 1000.0,
+                    vecLatencyNs.size(),
+                    dbMiB / (static_cast<sbdp::float64_t>(snElapsedNs) / 1e9));
+    }
+
+} // namespace
+
+int main() {
+    RunMode("fifo", sbdp::SendPriority::Bulk, k_unBasePort);
+    RunMode("urgent", sbdp::SendPriority::Urgent, k_unBasePort + 1);
+    return 0;
+}
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    ResponseCacheBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Response Cache Benchmark
+ * @author  Satoh
+ * @note    Zipf 分布（s=1.0、10 万キー）の要求を複数スレッドから引き、
+ *          キャッシュのバイト数上限を変えたときのヒット率と、シャード数による
+ *          1 参照あたりの時間（要求のエンコード＋参照＋応答参照）を比較する。
+ *          ミス時の要求は送らず、応答をエンコードして格納する
+ *
+ *          g++ -std=c++17 -O2 -I../include ResponseCacheBench.cpp -o ResponseCacheBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPFieldView.h"
+#include "SBDPResponseCache.h"
+
+namespace {
+
+    constexpr std::size_t k_unKeys          = 100000;
+    constexpr std::size_t k_unThreads       = 4;
+    constexpr std::size_t k_unLookupsPerThread = 500000;
+
+    /******************************************************************************
+     * @brief   1 条件の計測
+     * @arg     unShards   (in) シャード数
+     * @arg     unMaxBytes (in) バイト数上限
+     * @arg     vecCdf     (in) Zipf 分布の累積分布
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunMode(std::size_t unShards, std::size_t unMaxBytes, const std::vector<sbdp::float64_t>& vecCdf) {
+        sbdp::ResponseCacheConfig stConfig;
+        stConfig.unShards = unShards;
+        stConfig.unMaxBytes = unMaxBytes;
+        stConfig.unTtlMs = 60000;
+        sbdp::ResponseCache cCache(stConfig);
+
+        auto tpBegin = std::chrono::steady_clock::now();
+        std::vector<std::thread> vecThreads;
+        for (std::size_t unThread = 0; unThread < k_unThreads; ++unThread) {
+            vecThreads.emplace_back([&cCache, &vecCdf, unThread]() {
+                std::mt19937_64 cRandom(unThread + 1);
+                std::uniform_real_distribution<sbdp::float64_t> cUniform(0.0, 1.0);
+                sbdp::SharedFrame cResponse;
+                for (std::size_t unIndex = 0; unIndex < k_unLookupsPerThread; ++unIndex) {
+                    std::size_t unKey = static_cast<std::size_t>(
+                        std::lower_bound(vecCdf.begin(), vecCdf.end(), cUniform(cRandom)) - vecCdf.begin());
+                    sbdp::Message msgRequest;
+                    msgRequest["op"] = std::string("get");
+                    msgRequest["key"] = static_cast<uint64_t>(unKey);
+                    std::vector<uint8_t> vecKey = sbdp::EncodeMessage(msgRequest);
+                    std::string_view svKey(reinterpret_cast<const char*>(vecKey.data()), vecKey.size());
+                    if (!cCache.Lookup(svKey, cResponse)) {
+                        sbdp::Message msgResponse;
+                        msgResponse["key"] = static_cast<uint64_t>(unKey);
+                        msgResponse["value"] = std::string(200, 'v');
+                        cResponse = sbdp::SharedFrame::Encode(msgResponse);
+                        cCache.Insert(svKey, cResponse);
+                    }
+                    sbdp::FieldView stValue;
+                    sbdp::FindField(cResponse.Bytes(), "value", stValue);
+                }
+            });
+        }
+        for (std::thread& thrWorker : vecThreads) {
+            thrWorker.join();
+        }
+        std::chrono::duration<sbdp::float64_t> durElapsed = std::chrono::steady_clock::now() - tpBegin;
+        sbdp::ResponseCacheStats stStats = cCache.GetStats();
+        std::printf("shards %2zu  budget %5.1f MiB  hit %5.1f%%  entries %6zu  used %5.1f MiB  evictions %7llu  %6.0f ns/lookup\n",
+                    unShards, static_cast<sbdp::float64_t>(unMaxBytes) / (1024.0 * 1024.0),
+                    100.0 * stStats.GetHitRatio(), stStats.unEntries,
+                    static_cast<sbdp::float64_t>(stStats.unBytes) / (1024.0 * 1024.0),
+                    static_cast<unsigned long long>(stStats.unEvictions),
+                    durElapsed.count() * 1e9 / static_cast<sbdp::float64_t>(k_unThreads * k_unLookupsPerThread));
+    }
+
+} // namespace
+
+int main() {
+    std::vector<sbdp::float64_t> vecCdf(k_unKeys);
+    sbdp::float64_t dbSum = 0.0;
+    for (std::size_t unIndex = 0; unIndex < k_unKeys; ++unIndex) {
+        dbSum += 1.0 / static_cast<sbdp::float64_t>(unIndex + 1);
+        vecCdf[unIndex] = dbSum;
+    }
+    for (sbdp::float64_t& dbValue : vecCdf) {
+        dbValue /= dbSum;
+    }
+    RunMode(1, 32 * 1024 * 1024, vecCdf);
+    RunMode(16, 32 * 1024 * 1024, vecCdf);
+    RunMode(16, 4 * 1024 * 1024, vecCdf);
+    RunMode(16, 1024 * 1024, vecCdf);
+    return 0;
+}
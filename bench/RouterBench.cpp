@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    RouterBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Router Benchmark
+ * @author  Satoh
+ * @note    1 キー遅延参照による振り分けと、デコード→再エンコードによる
+ *          振り分けの 1 フレームあたりのコストを比較する
+ *
+ *          g++ -std=c++17 -O2 -I../include RouterBench.cpp -o RouterBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SBDPRouter.h"
+
+namespace {
+
+    constexpr std::size_t k_unIterations = 1000000;
+    constexpr std::size_t k_unUpstreams  = 16;
+    constexpr std::size_t k_unAccounts   = 1024;
+
+    /******************************************************************************
+     * @brief   ゲートウェイ相当のリクエストフレームを生成
+     * @arg     unAccount (in) アカウント番号
+     * @return  エンコード済みフレーム
+     * @note
+     *****************************************************************************/
+    std::vector<uint8_t> MakeFrame(std::size_t unAccount) {
+        sbdp::Message msgRequest;
+        msgRequest["account_id"] = std::string("acct-") + std::to_string(unAccount);
+        msgRequest["amount"] = static_cast<int64_t>(12345);
+        msgRequest["currency"] = std::string("JPY");
+        msgRequest["memo"] = std::string(64, 'm');
+        msgRequest["nonce"] = static_cast<uint64_t>(unAccount * 7919);
+        msgRequest["payload"] = std::vector<uint8_t>(256, 0xAB);
+        msgRequest["price"] = static_cast<sbdp::float64_t>(101.25);
+        msgRequest["side"] = std::string("BUY");
+        return sbdp::EncodeMessage(msgRequest);
+    }
+
+    /******************************************************************************
+     * @brief   経過時間から 1 フレームあたりのナノ秒を表示
+     * @arg     pszName (in) 計測名
+     * @arg     tpBegin (in) 開始時刻
+     * @arg     unSink  (in) 最適化除去防止用の値
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void PrintResult(const char* pszName, std::chrono::steady_clock::time_point tpBegin,
+                     std::size_t unSink) {
+        std::chrono::duration<sbdp::float64_t, std::nano> durElapsed =
+            std::chrono::steady_clock::now() - tpBegin;
+        std::printf("%-28s %8.1f ns/frame  (sink=%zu)\n", pszName,
+                    durElapsed.count() / static_cast<sbdp::float64_t>(k_unIterations), unSink);
+    }
+
+} // namespace
+
+int main() {
+    std::vector<std::vector<uint8_t>> vecFrames;
+    for (std::size_t unAccount = 0; unAccount < k_unAccounts; ++unAccount) {
+        vecFrames.push_back(MakeFrame(unAccount));
+    }
+    sbdp::ConsistentHashRing cRing(k_unUpstreams);
+
+    // 遅延参照：キー 1 つを探し、値の生バイト列をハッシュするだけ
+    std::size_t unSink = 0;
+    auto tpBegin = std::chrono::steady_clock::now();
+    for (std::size_t unIndex = 0; unIndex < k_unIterations; ++unIndex) {
+        const std::vector<uint8_t>& vecFrame = vecFrames[unIndex % k_unAccounts];
+        sbdp::FieldView stValue {};
+        if (sbdp::FindField(vecFrame, "account_id", stValue)) {
+            unSink += cRing(stValue);
+        }
+        unSink += vecFrame.size();
+    }
+    PrintResult("lazy lookup + forward", tpBegin, unSink);
+
+    // 従来方式：全体をデコードし、キーを取り出してから再エンコードして転送
+    unSink = 0;
+    tpBegin = std::chrono::steady_clock::now();
+    for (std::size_t unIndex = 0; unIndex < k_unIterations; ++unIndex) {
+        sbdp::Message msgDecoded = sbdp::DecodeMessage(vecFrames[unIndex % k_unAccounts]);
+        const std::string& strAccount = std::get<std::string>(msgDecoded["account_id"]);
+        sbdp::FieldView stValue {sbdp::TYPE_STRING,
+                                 reinterpret_cast<const uint8_t*>(strAccount.data()),
+                                 strAccount.size()};
+        unSink += cRing(stValue);
+        unSink += sbdp::EncodeMessage(msgDecoded).size();
+    }
+    PrintResult("decode + re-encode", tpBegin, unSink);
+    return 0;
+}
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    ServerBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Server Admission Control Benchmark
+ * @author  Satoh
+ * @note    処理能力（1 ms のハンドラー × 4 スレッド ≒ 4000 req/s）の 0.5 倍・1 倍・2 倍の
+ *          要求を一定間隔で送り続け（応答を待たない開ループ）、期限 100 ms 以内に
+ *          正常応答が返った数（グッドプット）を、受付制御なしと CoDel 方式の受付制御ありで比較する
+ *
+ *          g++ -std=c++17 -O2 -I../include ServerBench.cpp -o ServerBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SBDPServer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr unsigned short k_unPort        = 39800;
+    constexpr std::size_t    k_unHandlers    = 4;
+    constexpr int64_t        k_snServiceUs   = 1000;
+    constexpr int64_t        k_snDeadlineMs  = 100;
+    constexpr int64_t        k_snDurationMs  = 3000;
+    constexpr uint64_t       k_unCapacityRps = 4000;
+
+    /******************************************************************************
+     * @brief   1 条件の計測
+     * @arg     pszName    (in) 方式名
+     * @arg     bAdmission (in) true:受付制御あり false:なし
+     * @arg     dbLoad     (in) 処理能力に対する負荷の倍率
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunCase(const char* pszName, bool bAdmission, sbdp::float64_t dbLoad) {
+        sbdp::ServerConfig stConfig;
+        stConfig.unPort = k_unPort;
+        stConfig.unHandlerThreads = k_unHandlers;
+        stConfig.stAdmission.bEnabled = bAdmission;
+        sbdp::Server cServer(stConfig, [](const sbdp::Message& msgRequest, sbdp::Message& msgResponse) {
+            std::this_thread::sleep_for(std::chrono::microseconds(k_snServiceUs));
+            msgResponse["value"] = msgRequest.at("key");
+            return true;
+        });
+        if (!cServer.Start()) {
+            std::printf("server start failed\n");
+            return;
+        }
+
+        sbdp::SocketOptions stOptions;
+        stOptions.bNoDelay = true;
+        sbdp::Socket cClient;
+        if (!cClient.Create(stOptions) || !cClient.Connect("127.0.0.1", k_unPort)) {
+            std::printf("connect failed\n");
+            return;
+        }
+
+        const uint64_t unRate = static_cast<uint64_t>(static_cast<sbdp::float64_t>(k_unCapacityRps) * dbLoad);
+        const std::chrono::nanoseconds durGap(1000000000LL / static_cast<int64_t>(unRate));
+        const Clock::time_point tpStart = Clock::now();
+        const Clock::time_point tpSendEnd = tpStart + std::chrono::milliseconds(k_snDurationMs);
+        const Clock::time_point tpEnd = tpSendEnd + std::chrono::milliseconds(k_snDeadlineMs);
+
+        std::unordered_map<uint64_t, Clock::time_point> mapSent;
+        uint64_t unSent = 0;
+        uint64_t unGood = 0;
+        uint64_t unLate = 0;
+        uint64_t unRejected = 0;
+        Clock::time_point tpNextSend = tpStart;
+        sbdp::Message msgRequest;
+        msgRequest["key"] = std::string("k");
+        std::vector<uint8_t> vecFrame;
+
+        while (Clock::now() < tpEnd) {
+            Clock::time_point tpNow = Clock::now();
+            while (tpNextSend <= tpNow && tpNextSend < tpSendEnd) {
+                ++unSent;
+                msgRequest[sbdp::k_pszRequestIdKey] = unSent;
+                mapSent.emplace(unSent, tpNextSend);
+                cClient.EnqueueFrame(sbdp::SharedFrame::Encode(msgRequest));
+                tpNextSend += durGap;
+            }
+            cClient.FlushSendQueue();
+            cClient.ReceiveAvailable();
+            while (cClient.PopFrame(vecFrame)) {
+                uint64_t unRequestId = 0;
+                if (!sbdp::GetRequestId(vecFrame, unRequestId)) {
+                    continue;
+                }
+                auto itSent = mapSent.find(unRequestId);
+                if (itSent == mapSent.end()) {
+                    continue;
+                }
+                sbdp::FieldView stError;
+                if (sbdp::FindField(vecFrame, sbdp::k_pszErrorKey, stError)) {
+                    ++unRejected;
+                }
+                else if (Clock::now() - itSent->second <= std::chrono::milliseconds(k_snDeadlineMs)) {
+                    ++unGood;
+                }
+                else {
+                    ++unLate;
+                }
+                mapSent.erase(itSent);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        sbdp::ServerStats stStats = cServer.GetStats();
+        cClient.Close();
+        cServer.Stop();
+        const sbdp::float64_t dbSeconds = static_cast<sbdp::float64_t>(k_snDurationMs) / 1000.0;
+        std::printf("%-9s load=%.1fx sent=%6llu goodput=%7.0f req/s late=%6llu rejected=%6llu "
+                    "pending=%6zu shed(arrival/queue)=%llu/%llu\n",
+                    pszName, dbLoad, static_cast<unsigned long long>(unSent),
+                    static_cast<sbdp::float64_t>(unGood) / dbSeconds,
+                    static_cast<unsigned long long>(unLate), static_cast<unsigned long long>(unRejected),
+                    mapSent.size(), static_cast<unsigned long long>(stStats.unShedOnArrival),
+                    static_cast<unsigned long long>(stStats.unShedInQueue));
+    }
+
+}
+
+int main() {
+    const sbdp::float64_t arrLoads[] = {0.5, 1.0, 2.0};
+    for (sbdp::float64_t dbLoad : arrLoads) {
+        RunCase("none", false, dbLoad);
+        RunCase("codel", true, dbLoad);
+    }
+    return 0;
+}
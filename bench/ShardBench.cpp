@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    ShardBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Key-affinity Sharding Benchmark
+ * @author  Satoh
+ * @note    複数の接続から口座ごとの更新要求を送り、口座の状態をミューテックスで守る
+ *          共有待ち行列と、口座キーでハンドラースレッドへ固定的に割り振りロックなしで
+ *          状態を持つシャード分割とで、処理速度と口座内の順序逆転数を比較する
+ *
+ *          g++ -std=c++17 -O2 -I../include ShardBench.cpp -o ShardBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SBDPServer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr unsigned short k_unPort     = 39900;
+    constexpr std::size_t    k_unHandlers = 4;
+    constexpr std::size_t    k_unClients  = 4;
+    constexpr std::size_t    k_unAccounts = 64;
+    constexpr uint64_t       k_unRequests = 50000;   // 接続ごと
+
+    // 口座の状態（接続ごとに最後に処理した通番を持ち、逆転を数える）
+    struct Account {
+        int64_t  snBalance = 0;
+        uint64_t arrLastSeq[k_unClients] = {};
+    };
+
+    /******************************************************************************
+     * @brief   口座の更新
+     * @arg     mapAccounts (in)  口座表
+     * @arg     msgRequest  (in)  要求
+     * @arg     unReorders  (out) 順序逆転数
+     * @return  更新後の残高
+     * @note
+     *****************************************************************************/
+    int64_t ApplyUpdate(std::unordered_map<std::string, Account>& mapAccounts,
+                        const sbdp::Message& msgRequest, uint64_t& unReorders) {
+        Account& stAccount = mapAccounts[std::get<std::string>(msgRequest.at("account"))];
+        std::size_t unClient = static_cast<std::size_t>(std::get<uint64_t>(msgRequest.at("client")));
+        uint64_t unSeq = std::get<uint64_t>(msgRequest.at("seq"));
+        if (unSeq < stAccount.arrLastSeq[unClient]) {
+            ++unReorders;
+        }
+        stAccount.arrLastSeq[unClient] = unSeq;
+        stAccount.snBalance += std::get<int64_t>(msgRequest.at("amount"));
+        return stAccount.snBalance;
+    }
+
+    /******************************************************************************
+     * @brief   1 接続分の要求送信と応答受信
+     * @arg     unClient (in) 接続番号
+     * @return  なし
+     * @note    応答を待たずに最大 256 件を送り続ける
+     *****************************************************************************/
+    void RunClient(std::size_t unClient) {
+        sbdp::SocketOptions stOptions;
+        stOptions.bNoDelay = true;
+        sbdp::Socket cClient;
+        if (!cClient.Create(stOptions) || !cClient.Connect("127.0.0.1", k_unPort)) {
+            std::printf("connect failed\n");
+            return;
+        }
+        sbdp::Message msgRequest;
+        msgRequest["client"] = static_cast<uint64_t>(unClient);
+        msgRequest["amount"] = static_cast<int64_t>(1);
+        std::vector<uint8_t> vecFrame;
+        uint64_t unSent = 0;
+        uint64_t unReceived = 0;
+        while (unReceived < k_unRequests) {
+            while (unSent < k_unRequests && unSent - unReceived < 256) {
+                ++unSent;
+                msgRequest["account"] = "acct-" + std::to_string(unSent % k_unAccounts);
+                msgRequest["seq"] = unSent;
+                cClient.EnqueueFrame(sbdp::SharedFrame::Encode(msgRequest));
+            }
+            cClient.FlushSendQueue();
+            cClient.ReceiveAvailable();
+            while (cClient.PopFrame(vecFrame)) {
+                ++unReceived;
+            }
+        }
+    }
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName  (in) 方式名
+     * @arg     bSharded (in) true:口座キーでシャード分割 false:共有待ち行列＋ミューテックス
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunMode(const char* pszName, bool bSharded) {
+        sbdp::ServerConfig stConfig;
+        stConfig.unPort = k_unPort;
+        stConfig.unHandlerThreads = k_unHandlers;
+        stConfig.stAdmission.bEnabled = false;
+        if (bSharded) {
+            stConfig.strShardKey = "account";
+        }
+
+        std::mutex mtxAccounts;
+        std::unordered_map<std::string, Account> mapShared;
+        std::vector<std::unordered_map<std::string, Account>> vecShards(k_unHandlers);
+        std::vector<uint64_t> vecReorders(k_unHandlers, 0);
+
+        sbdp::Server cServer(stConfig, [&](std::size_t unShard, const sbdp::Message& msgRequest,
+                                           sbdp::Message& msgResponse) {
+            int64_t snBalance = 0;
+            if (bSharded) {
+                snBalance = ApplyUpdate(vecShards[unShard], msgRequest, vecReorders[unShard]);
+            }
+            else {
+                std::lock_guard<std::mutex> lock(mtxAccounts);
+                snBalance = ApplyUpdate(mapShared, msgRequest, vecReorders[0]);
+            }
+            msgResponse["balance"] = snBalance;
+            return true;
+        });
+        if (!cServer.Start()) {
+            std::printf("server start failed\n");
+            return;
+        }
+
+        Clock::time_point tpStart = Clock::now();
+        std::vector<std::thread> vecClients;
+        for (std::size_t unClient = 0; unClient < k_unClients; ++unClient) {
+            vecClients.emplace_back(RunClient, unClient);
+        }
+        for (std::thread& thrClient : vecClients) {
+            thrClient.join();
+        }
+        sbdp::float64_t dbSeconds = std::chrono::duration<sbdp::float64_t>(Clock::now() - tpStart).count();
+        cServer.Stop();
+
+        uint64_t unReorders = 0;
+        for (uint64_t unCount : vecReorders) {
+            unReorders += unCount;
+        }
+        std::printf("%-8s %8.0f req/s  reordered=%llu\n", pszName,
+                    static_cast<sbdp::float64_t>(k_unClients * k_unRequests) / dbSeconds,
+                    static_cast<unsigned long long>(unReorders));
+    }
+
+}
+
+int main() {
+    RunMode("shared", false);
+    RunMode("sharded", true);
+    return 0;
+}
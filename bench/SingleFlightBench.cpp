@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SingleFlightBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Single-flight Benchmark
+ * @author  Satoh
+ * @note    多数のスレッドが少数の同じキーを同時に要求する（キャッシュスタンピード）状況で、
+ *          バックエンドに届く要求数と全体の所要時間を、集約なしと SingleFlight で比較する。
+ *          バックエンドは要求ごとに 2 ms かかる（データベース参照を模擬）
+ *
+ *          g++ -std=c++17 -O2 -I../include SingleFlightBench.cpp -o SingleFlightBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPSingleFlight.h"
+
+namespace {
+
+    constexpr unsigned short k_unPort      = 39700;
+    constexpr std::size_t    k_unThreads   = 64;
+    constexpr std::size_t    k_unRounds    = 50;
+    constexpr std::size_t    k_unHotKeys   = 4;
+    constexpr int64_t        k_snBackendUs = 2000;
+
+    std::atomic<uint64_t> g_unBackendRequests(0);
+
+    /******************************************************************************
+     * @brief   バックエンドの 1 接続の処理
+     * @arg     cPeer (in) 接続
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void ServeConnection(sbdp::Socket cPeer) {
+        try {
+            for (;;) {
+                sbdp::Message msgRequest = cPeer.RecvMessage();
+                g_unBackendRequests.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::microseconds(k_snBackendUs));
+                sbdp::Message msgResponse;
+                msgResponse["key"] = msgRequest["key"];
+                msgResponse["value"] = std::string(256, 'v');
+                cPeer.SendMessage(msgResponse);
+            }
+        }
+        catch (const std::exception&) {
+        }
+    }
+
+    /******************************************************************************
+     * @brief   1 方式の計測
+     * @arg     pszName    (in) 方式名
+     * @arg     bCoalesce  (in) true:SingleFlight 経由 false:各スレッドが直接送る
+     * @return  なし
+     * @note    各スレッドは自分の接続を持ち、ラウンドごとに同じホットキーを順に要求する
+     *****************************************************************************/
+    void RunMode(const char* pszName, bool bCoalesce) {
+        std::vector<std::unique_ptr<sbdp::Socket>> vecSockets;
+        for (std::size_t unIndex = 0; unIndex < k_unThreads; ++unIndex) {
+            sbdp::SocketOptions stOptions;
+            stOptions.bNoDelay = true;
+            auto upSocket = std::make_unique<sbdp::Socket>();
+            if (!upSocket->Create(stOptions) || !upSocket->Connect("127.0.0.1", k_unPort)) {
+                std::printf("%s: connect failed\n", pszName);
+                return;
+            }
+            vecSockets.push_back(std::move(upSocket));
+        }
+
+        // 各スレッドの接続で要求を送る（SingleFlight からは実行したスレッドの接続が使われる）
+        thread_local sbdp::Socket* t_pRawSocket = nullptr;
+        sbdp::SingleFlight cSingleFlight([](const sbdp::Message& msgRequest, sbdp::Message& msgResponse) {
+            if (!t_pRawSocket->SendMessage(msgRequest)) {
+                return false;
+            }
+            msgResponse = t_pRawSocket->RecvMessage(1000);
+            return true;
+        });
+
+        g_unBackendRequests.store(0);
+        std::atomic<uint64_t> unFailures(0);
+        auto tpBegin = std::chrono::steady_clock::now();
+        std::vector<std::thread> vecThreads;
+        for (std::size_t unThread = 0; unThread < k_unThreads; ++unThread) {
+            vecThreads.emplace_back([&, unThread]() {
+                t_pRawSocket = vecSockets[unThread].get();
+                sbdp::Message msgResponse;
+                for (std::size_t unRound = 0; unRound < k_unRounds; ++unRound) {
+                    for (std::size_t unKey = 0; unKey < k_unHotKeys; ++unKey) {
+                        sbdp::Message msgRequest;
+                        msgRequest["op"] = std::string("get");
+                        msgRequest["key"] = std::string("product:") + std::to_string(unKey);
+                        bool bOk = false;
+                        if (bCoalesce) {
+                            bOk = cSingleFlight.Call(msgRequest, msgResponse);
+                        }
+                        else {
+                            bOk = t_pRawSocket->SendMessage(msgRequest);
+                            if (bOk) {
+                                msgResponse = t_pRawSocket->RecvMessage(1000);
+                            }
+                        }
+                        if (!bOk) {
+                            unFailures.fetch_add(1);
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& thrClient : vecThreads) {
+            thrClient.join();
+        }
+        std::chrono::duration<sbdp::float64_t> durElapsed = std::chrono::steady_clock::now() - tpBegin;
+        const std::size_t unCalls = k_unThreads * k_unRounds * k_unHotKeys;
+        std::printf("%-10s calls %6zu  backend requests %6llu  elapsed %6.2f s  (%8.0f calls/s, failures %llu)\n",
+                    pszName, unCalls,
+                    static_cast<unsigned long long>(g_unBackendRequests.load()),
+                    durElapsed.count(),
+                    static_cast<sbdp::float64_t>(unCalls) / durElapsed.count(),
+                    static_cast<unsigned long long>(unFailures.load()));
+    }
+
+} // namespace
+
+int main() {
+    sbdp::SocketOptions stListenOptions;
+    stListenOptions.bReuseAddress = true;
+    stListenOptions.bNoDelay = true;
+    sbdp::Socket cListener;
+    if (!cListener.Create(stListenOptions) || !cListener.Bind(k_unPort) || !cListener.Listen()) {
+        std::printf("listen failed\n");
+        return 1;
+    }
+    std::thread thrAcceptor([&cListener]() {
+        for (;;) {
+            try {
+                std::thread(ServeConnection, cListener.Accept()).detach();
+            }
+            catch (const std::exception&) {
+                return;
+            }
+        }
+    });
+
+    RunMode("direct", false);
+    RunMode("coalesced", true);
+
+    cListener.Shutdown();
+    thrAcceptor.join();
+    return 0;
+}
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SocketOptionsBench.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Socket Options Benchmark
+ * @author  Satoh
+ * @note    ループバック上で既定値・LowLatency・BulkThroughput の各プリセットの
+ *          小メッセージ往復遅延と大フレーム転送スループットを比較する
+ *
+ *          g++ -std=c++17 -O2 -I../include SocketOptionsBench.cpp -o SocketOptionsBench -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SBDPSocket.h"
+
+namespace {
+
+    constexpr unsigned short k_unBasePort    = 39100;
+    constexpr std::size_t    k_unRoundTrips  = 20000;
+    constexpr std::size_t    k_unBulkFrames  = 4096;
+    constexpr std::size_t    k_unBulkPayload = 64 * 1024;
+
+    /******************************************************************************
+     * @brief   オプション値を表示用文字列へ変換
+     * @arg     oValue (in) 値
+     * @return  文字列（未取得は "-"）
+     * @note
+     *****************************************************************************/
+    template<class T_>
+    std::string ToText(const std::optional<T_>& oValue) {
+        if (!oValue.has_value()) {
+            return "-";
+        }
+        return std::to_string(static_cast<int64_t>(*oValue));
+    }
+
+    /******************************************************************************
+     * @brief   実効オプション値の表示
+     * @arg     cSocket (in) 対象ソケット
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void PrintEffective(const sbdp::Socket& cSocket) {
+        sbdp::SocketOptions stEffective = cSocket.GetEffectiveOptions();
+        std::printf("  effective: nodelay=%s quickack=%s sndbuf=%s rcvbuf=%s busy_poll=%s\n",
+                    ToText(stEffective.bNoDelay).c_str(), ToText(stEffective.bQuickAck).c_str(),
+                    ToText(stEffective.snSendBufferBytes).c_str(),
+                    ToText(stEffective.snRecvBufferBytes).c_str(),
+                    ToText(stEffective.snBusyPollUs).c_str());
+    }
+
+    /******************************************************************************
+     * @brief   1 プリセットの計測
+     * @arg     pszName   (in) プリセット名
+     * @arg     stOptions (in) ソケットオプション
+     * @arg     unPort    (in) 使用するポート
+     * @return  なし
+     * @note
+     *****************************************************************************/
+    void RunPreset(const char* pszName, const sbdp::SocketOptions& stOptions, unsigned short unPort) {
+        sbdp::SocketOptions stListenOptions = stOptions;
+        stListenOptions.bReuseAddress = true;
+        sbdp::Socket cListener;
+        if (!cListener.Create(stListenOptions) || !cListener.Bind(unPort) || !cListener.Listen()) {
+            std::printf("%s: listen failed\n", pszName);
+            return;
+        }
+
+        // サーバー側：往復計測中はエコー、その後は大フレームを読み捨てる
+        std::thread thrServer([&cListener]() {
+            sbdp::Socket cPeer = cListener.Accept();
+            std::vector<uint8_t> vecFrame;
+            for (std::size_t unIndex = 0; unIndex < k_unRoundTrips; ++unIndex) {
+                cPeer.RecvFrame(vecFrame);
+                cPeer.SendAll(vecFrame.data(), vecFrame.size());
+            }
+            for (std::size_t unIndex = 0; unIndex < k_unBulkFrames; ++unIndex) {
+                cPeer.RecvFrame(vecFrame);
+            }
+            uint8_t unAck = 1;
+            cPeer.SendAll(&unAck, sizeof(unAck));
+        });
+
+        sbdp::Socket cClient;
+        if (!cClient.Create(stOptions) || !cClient.Connect("127.0.0.1", unPort)) {
+            std::printf("%s: connect failed\n", pszName);
+            thrServer.detach();
+            return;
+        }
+
+        // 小メッセージの往復遅延
+        sbdp::Message msgPing;
+        msgPing["seq"] = static_cast<uint64_t>(0);
+        msgPing["op"] = std::string("ping");
+        sbdp::SharedFrame cPing = sbdp::SharedFrame::Encode(msgPing);
+        std::vector<uint8_t> vecReply;
+        std::vector<int64_t> vecLatencyNs;
+        vecLatencyNs.reserve(k_unRoundTrips);
+        for (std::size_t unIndex = 0; unIndex < k_unRoundTrips; ++unIndex) {
+            auto tpBegin = std::chrono::steady_clock::now();
+            cClient.SendFrame(cPing);
+            cClient.RecvFrame(vecReply);
+            vecLatencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - tpBegin).count());
+        }
+        std::sort(vecLatencyNs.begin(), vecLatencyNs.end());
+
+        // 大フレームの連続送信
+        sbdp::Message msgBulk;
+        msgBulk["payload"] = std::vector<uint8_t>(k_unBulkPayload, 0x5A);
+        sbdp::SharedFrame cBulk = sbdp::SharedFrame::Encode(msgBulk);
+        auto tpBegin = std::chrono::steady_clock::now();
+        for (std::size_t unIndex = 0; unIndex < k_unBulkFrames; ++unIndex) {
+            cClient.SendFrame(cBulk);
+        }
+        uint8_t unAck = 0;
+        cClient.RecvAll(&unAck, sizeof(unAck), 0);
+        std::chrono::duration<sbdp::float64_t> durBulk = std::chrono::steady_clock::now() - tpBegin;
+        thrServer.join();
+
+        sbdp::float64_t dbMiB = static_cast<sbdp::float64_t>(cBulk.Size() * k_unBulkFrames) / (1024.0 * 1024.0);
+        std::printf("%-16s rtt p50 %7.1f us  p99 %7.1f us   bulk %8.1f MiB/s\n", pszName,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() / 2]) / 1000.0,
+                    static_cast<sbdp::float64_t>(vecLatencyNs[vecLatencyNs.size() * 99 / 100]) / 1000.0,
+                    dbMiB / durBulk.count());
+        PrintEffective(cClient);
+    }
+
+} // namespace
+
+int main() {
+    RunPreset("default", sbdp::SocketOptions(), k_unBasePort);
+    RunPreset("low-latency", sbdp::SocketOptions::LowLatency(), k_unBasePort + 1);
+    RunPreset("bulk-throughput", sbdp::SocketOptions::BulkThroughput(), k_unBasePort + 2);
+    return 0;
+}
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    KvLoadGen.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Example Key-Value Load Generator
+ * @author  Satoh
+ * @note    KvServer に対し、全キーを SET で投入した後、Zipf 分布（s=0.99）のキーで
+ *          GET / SET / MGET を混ぜた要求を接続ごとに一定数パイプラインで送り続け、
+ *          処理数・ヒット率・往復遅延（p50 / p99 / p99.9）を表示する。
+ *          乱数の種は固定のため、同じ引数なら同じ要求列になる
+ *
+ *          使い方: KvLoadGen [host=127.0.0.1] [port=11311] [connections=4] [seconds=5]
+ *                            [keys=100000] [value-bytes=100] [set-percent=10]
+ *                            [mget-percent=5] [mget-keys=8] [depth=16]
+ *
+ *          g++ -std=c++17 -O2 -I../../include KvLoadGen.cpp -o KvLoadGen -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPFieldView.h"
+#include "SBDPRequest.h"
+#include "KvStore.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr sbdp::float64_t k_dbZipfExponent = 0.99;
+    constexpr uint64_t        k_unSeed          = 20260401;
+
+    // 負荷条件
+    struct LoadConfig {
+        std::string strHost       = "127.0.0.1";
+        uint16_t    unPort        = 11311;
+        std::size_t unConnections = 4;
+        uint64_t    unSeconds     = 5;
+        std::size_t unKeys        = 100000;
+        std::size_t unValueBytes  = 100;
+        uint64_t    unSetPercent  = 10;
+        uint64_t    unMGetPercent = 5;
+        uint64_t    unMGetKeys    = 8;
+        std::size_t unDepth       = 16;
+    };
+
+    // 接続ごとの結果
+    struct LoadResult {
+        uint64_t              unOps       = 0;
+        uint64_t              unGets      = 0;   // MGET の各キーを含む
+        uint64_t              unHits      = 0;
+        uint64_t              unErrors    = 0;
+        std::vector<uint32_t> vecLatencyUs;
+    };
+
+    /******************************************************************************
+     * @brief   キー文字列
+     * @arg     unKey (in) キー番号
+     * @return  キー
+     * @note
+     *****************************************************************************/
+    std::string KeyName(std::size_t unKey) {
+        return "key:" + std::to_string(unKey);
+    }
+
+    /******************************************************************************
+     * @brief   応答の status が ok か判定
+     * @arg     vecFrame (in) 応答フレーム
+     * @return  結果 true:ok false:それ以外
+     * @note
+     *****************************************************************************/
+    bool IsStatusOk(const std::vector<uint8_t>& vecFrame) {
+        sbdp::FieldView stStatus;
+        return sbdp::FindField(vecFrame, kvstore::k_pszStatusKey, stStatus) &&
+               stStatus.AsStringView() == kvstore::k_pszStatusOk;
+    }
+
+    /******************************************************************************
+     * @brief   全キーのうち担当分を SET で投入
+     * @arg     cClient  (in) 接続
+     * @arg     stConfig (in) 負荷条件
+     * @arg     unBegin  (in) 先頭のキー番号
+     * @arg     unEnd    (in) 終端のキー番号
+     * @return  結果 true:正常 false:失敗応答あり
+     * @note
+     *****************************************************************************/
+    bool Preload(sbdp::Socket& cClient, const LoadConfig& stConfig, std::size_t unBegin, std::size_t unEnd) {
+        sbdp::Message msgRequest;
+        msgRequest[kvstore::k_pszCommandKey] = std::string(kvstore::k_pszCommandSet);
+        msgRequest[kvstore::k_pszValueKey] = std::vector<uint8_t>(stConfig.unValueBytes, 'v');
+        std::vector<uint8_t> vecFrame;
+        std::size_t unNext = unBegin;
+        std::size_t unDone = unBegin;
+        bool bOk = true;
+        while (unDone < unEnd) {
+            while (unNext < unEnd && unNext - unDone < stConfig.unDepth) {
+                msgRequest[kvstore::k_pszKeyKey] = KeyName(unNext++);
+                cClient.EnqueueFrame(sbdp::SharedFrame::Encode(msgRequest));
+            }
+            cClient.Flush();
+            if (cClient.ReceiveAvailable() == sbdp::ReceiveResult::Closed) {
+                return false;
+            }
+            while (cClient.PopFrame(vecFrame)) {
+                bOk = IsStatusOk(vecFrame) && bOk;
+                ++unDone;
+            }
+        }
+        return bOk;
+    }
+
+    /******************************************************************************
+     * @brief   1 接続分の負荷生成
+     * @arg     stConfig   (in)  負荷条件
+     * @arg     unIndex    (in)  接続番号
+     * @arg     vecCdf     (in)  Zipf 分布の累積分布
+     * @arg     unReady    (in)  投入を終えた接続数
+     * @arg     stResult   (out) 結果
+     * @return  なし
+     * @note    全接続の投入完了を待ってから計測を始める
+     *****************************************************************************/
+    void RunConnection(const LoadConfig& stConfig, std::size_t unIndex, const std::vector<sbdp::float64_t>& vecCdf,
+                       std::atomic<std::size_t>& unReady, LoadResult& stResult) {
+        sbdp::SocketOptions stOptions;
+        stOptions.bNoDelay = true;
+        sbdp::Socket cClient;
+        if (!cClient.Create(stOptions) || !cClient.Connect(stConfig.strHost, stConfig.unPort)) {
+            std::printf("connect failed\n");
+            unReady.fetch_add(1);
+            return;
+        }
+        std::size_t unBegin = stConfig.unKeys * unIndex / stConfig.unConnections;
+        std::size_t unEnd = stConfig.unKeys * (unIndex + 1) / stConfig.unConnections;
+        if (!Preload(cClient, stConfig, unBegin, unEnd)) {
+            std::printf("preload: some SETs failed (server memory too small?)\n");
+        }
+        unReady.fetch_add(1);
+        while (unReady.load() < stConfig.unConnections) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::mt19937_64 cRandom(k_unSeed + unIndex);
+        std::uniform_real_distribution<sbdp::float64_t> cUniform(0.0, 1.0);
+        std::uniform_int_distribution<uint64_t> cPercent(0, 99);
+        auto fnNextKey = [&]() {
+            return KeyName(static_cast<std::size_t>(
+                std::lower_bound(vecCdf.begin(), vecCdf.end(), cUniform(cRandom)) - vecCdf.begin()));
+        };
+        const std::vector<uint8_t> vecValue(stConfig.unValueBytes, 'v');
+
+        struct Pending {
+            Clock::time_point tpSent;
+            uint64_t          unKeys;   // GET / MGET のキー数（SET は 0）
+            bool              bMGet;
+        };
+        std::unordered_map<uint64_t, Pending> mapPending;
+        uint64_t unNextId = 1;
+        std::vector<uint8_t> vecFrame;
+        const Clock::time_point tpEnd = Clock::now() + std::chrono::seconds(stConfig.unSeconds);
+
+        while (Clock::now() < tpEnd || !mapPending.empty()) {
+            while (Clock::now() < tpEnd && mapPending.size() < stConfig.unDepth) {
+                sbdp::Message msgRequest;
+                uint64_t unPercent = cPercent(cRandom);
+                uint64_t unKeys = 1;
+                bool bMGet = false;
+                if (unPercent < stConfig.unSetPercent) {
+                    msgRequest[kvstore::k_pszCommandKey] = std::string(kvstore::k_pszCommandSet);
+                    msgRequest[kvstore::k_pszKeyKey] = fnNextKey();
+                    msgRequest[kvstore::k_pszValueKey] = vecValue;
+                    unKeys = 0;
+                }
+                else if (unPercent < stConfig.unSetPercent + stConfig.unMGetPercent) {
+                    msgRequest[kvstore::k_pszCommandKey] = std::string(kvstore::k_pszCommandMGet);
+                    msgRequest[kvstore::k_pszCountKey] = stConfig.unMGetKeys;
+                    for (uint64_t unKey = 0; unKey < stConfig.unMGetKeys; ++unKey) {
+                        msgRequest[kvstore::IndexedName(kvstore::k_pszKeyKey, unKey)] = fnNextKey();
+                    }
+                    unKeys = stConfig.unMGetKeys;
+                    bMGet = true;
+                }
+                else {
+                    msgRequest[kvstore::k_pszCommandKey] = std::string(kvstore::k_pszCommandGet);
+                    msgRequest[kvstore::k_pszKeyKey] = fnNextKey();
+                }
+                msgRequest[sbdp::k_pszRequestIdKey] = unNextId;
+                mapPending.emplace(unNextId++, Pending{Clock::now(), unKeys, bMGet});
+                cClient.EnqueueFrame(sbdp::SharedFrame::Encode(msgRequest));
+            }
+            cClient.Flush();
+            if (cClient.ReceiveAvailable() == sbdp::ReceiveResult::Closed) {
+                std::printf("server closed the connection\n");
+                return;
+            }
+            while (cClient.PopFrame(vecFrame)) {
+                uint64_t unRequestId = 0;
+                auto itPending = sbdp::GetRequestId(vecFrame, unRequestId) ? mapPending.find(unRequestId)
+                                                                           : mapPending.end();
+                if (itPending == mapPending.end()) {
+                    continue;
+                }
+                stResult.vecLatencyUs.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - itPending->second.tpSent).count()));
+                ++stResult.unOps;
+                sbdp::FieldView stField;
+                if (itPending->second.unKeys == 1 && !itPending->second.bMGet) {
+                    ++stResult.unGets;
+                    if (IsStatusOk(vecFrame)) {
+                        ++stResult.unHits;
+                    }
+                    else if (!sbdp::FindField(vecFrame, kvstore::k_pszStatusKey, stField) ||
+                             stField.AsStringView() != kvstore::k_pszStatusMiss) {
+                        ++stResult.unErrors;
+                    }
+                }
+                else if (!IsStatusOk(vecFrame)) {
+                    ++stResult.unErrors;
+                }
+                else {
+                    for (uint64_t unKey = 0; unKey < itPending->second.unKeys; ++unKey) {
+                        ++stResult.unGets;
+                        if (sbdp::FindField(vecFrame, kvstore::IndexedName(kvstore::k_pszValueKey, unKey), stField)) {
+                            ++stResult.unHits;
+                        }
+                    }
+                }
+                mapPending.erase(itPending);
+            }
+        }
+    }
+
+    /******************************************************************************
+     * @brief   パーセンタイル値の取得
+     * @arg     vecSorted     (in) 昇順に並べた値
+     * @arg     dbPercentile  (in) パーセンタイル（0.0〜1.0）
+     * @return  値
+     * @note
+     *****************************************************************************/
+    uint32_t Percentile(const std::vector<uint32_t>& vecSorted, sbdp::float64_t dbPercentile) {
+        if (vecSorted.empty()) {
+            return 0;
+        }
+        std::size_t unIndex = static_cast<std::size_t>(dbPercentile * static_cast<sbdp::float64_t>(vecSorted.size() - 1));
+        return vecSorted[unIndex];
+    }
+
+}
+
+int main(int snArgc, char** ppszArgv) {
+    LoadConfig stConfig;
+    auto fnArg = [&](int snIndex, uint64_t unDefault) {
+        return (snIndex < snArgc) ? std::strtoull(ppszArgv[snIndex], nullptr, 10) : unDefault;
+    };
+    if (snArgc > 1) {
+        stConfig.strHost = ppszArgv[1];
+    }
+    stConfig.unPort = static_cast<uint16_t>(fnArg(2, stConfig.unPort));
+    stConfig.unConnections = std::max<std::size_t>(static_cast<std::size_t>(fnArg(3, stConfig.unConnections)), 1);
+    stConfig.unSeconds = fnArg(4, stConfig.unSeconds);
+    stConfig.unKeys = std::max<std::size_t>(static_cast<std::size_t>(fnArg(5, stConfig.unKeys)), 1);
+    stConfig.unValueBytes = static_cast<std::size_t>(fnArg(6, stConfig.unValueBytes));
+    stConfig.unSetPercent = fnArg(7, stConfig.unSetPercent);
+    stConfig.unMGetPercent = fnArg(8, stConfig.unMGetPercent);
+    stConfig.unMGetKeys = std::min<uint64_t>(std::max<uint64_t>(fnArg(9, stConfig.unMGetKeys), 1), kvstore::k_unMaxMGetKeys);
+    stConfig.unDepth = std::max<std::size_t>(static_cast<std::size_t>(fnArg(10, stConfig.unDepth)), 1);
+
+    std::vector<sbdp::float64_t> vecCdf(stConfig.unKeys);
+    sbdp::float64_t dbSum = 0.0;
+    for (std::size_t unIndex = 0; unIndex < stConfig.unKeys; ++unIndex) {
+        dbSum += 1.0 / std::pow(static_cast<sbdp::float64_t>(unIndex + 1), k_dbZipfExponent);
+        vecCdf[unIndex] = dbSum;
+    }
+    for (sbdp::float64_t& dbValue : vecCdf) {
+        dbValue /= dbSum;
+    }
+
+    std::atomic<std::size_t> unReady(0);
+    std::vector<LoadResult> vecResults(stConfig.unConnections);
+    std::vector<std::thread> vecThreads;
+    for (std::size_t unIndex = 0; unIndex < stConfig.unConnections; ++unIndex) {
+        vecThreads.emplace_back(RunConnection, std::cref(stConfig), unIndex, std::cref(vecCdf),
+                                std::ref(unReady), std::ref(vecResults[unIndex]));
+    }
+    for (std::thread& thrConnection : vecThreads) {
+        thrConnection.join();
+    }
+
+    LoadResult stTotal;
+    for (LoadResult& stResult : vecResults) {
+        stTotal.unOps += stResult.unOps;
+        stTotal.unGets += stResult.unGets;
+        stTotal.unHits += stResult.unHits;
+        stTotal.unErrors += stResult.unErrors;
+        stTotal.vecLatencyUs.insert(stTotal.vecLatencyUs.end(), stResult.vecLatencyUs.begin(), stResult.vecLatencyUs.end());
+    }
+    std::sort(stTotal.vecLatencyUs.begin(), stTotal.vecLatencyUs.end());
+    std::printf("connections %zu  depth %zu  keys %zu  value %zu B  set %llu%%  mget %llu%% x %llu\n",
+                stConfig.unConnections, stConfig.unDepth, stConfig.unKeys, stConfig.unValueBytes,
+                static_cast<unsigned long long>(stConfig.unSetPercent),
+                static_cast<unsigned long long>(stConfig.unMGetPercent),
+                static_cast<unsigned long long>(stConfig.unMGetKeys));
+    std::printf("%.0f ops/s  hit %.1f%%  errors %llu  p50 %u us  p99 %u us  p99.9 %u us\n",
+                static_cast<sbdp::float64_t>(stTotal.unOps) / static_cast<sbdp::float64_t>(std::max<uint64_t>(stConfig.unSeconds, 1)),
+                stTotal.unGets ? 100.0 * static_cast<sbdp::float64_t>(stTotal.unHits) / static_cast<sbdp::float64_t>(stTotal.unGets) : 0.0,
+                static_cast<unsigned long long>(stTotal.unErrors),
+                Percentile(stTotal.vecLatencyUs, 0.50), Percentile(stTotal.vecLatencyUs, 0.99),
+                Percentile(stTotal.vecLatencyUs, 0.999));
+    return 0;
+}
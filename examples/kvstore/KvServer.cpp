@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    KvServer.cpp
+ * @brief   SimpleBinaryDictionaryProtocol Example Key-Value Cache Server
+ * @author  Satoh
+ * @note    GET / SET / DEL / MGET を SBDP メッセージで受け付けるメモリ上のキャッシュサーバー。
+ *          コマンドの処理は短いため、sbdp::Server をハンドラースレッドなし（I/O ワーカー上で
+ *          直接処理）で動かし、スレッド間の受け渡しを省く。SIGINT / SIGTERM で終了する
+ *
+ *          使い方: KvServer [port=11311] [io=<CPU 数>] [memory-mb=64] [shards=16]
+ *
+ *          g++ -std=c++17 -O2 -I../../include KvServer.cpp -o KvServer -pthread
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include <pthread.h>
+#include <signal.h>
+#include "SBDPServer.h"
+#include "KvStore.h"
+
+namespace {
+
+    /******************************************************************************
+     * @brief   文字列・バイナリ値の参照
+     * @arg     msgRequest (in)  要求
+     * @arg     strKey     (in)  フィールド名
+     * @arg     pRawData   (out) 値の先頭
+     * @arg     unSize     (out) 値のバイト数
+     * @return  結果 true:あり false:なし・型が異なる
+     * @note
+     *****************************************************************************/
+    bool GetBytes(const sbdp::Message& msgRequest, const std::string& strKey,
+                  const uint8_t*& pRawData, std::size_t& unSize) {
+        auto itValue = msgRequest.find(strKey);
+        if (itValue == msgRequest.end()) {
+            return false;
+        }
+        if (const std::string* pRawString = std::get_if<std::string>(&itValue->second)) {
+            pRawData = reinterpret_cast<const uint8_t*>(pRawString->data());
+            unSize = pRawString->size();
+            return true;
+        }
+        if (const std::vector<uint8_t>* pRawBinary = std::get_if<std::vector<uint8_t>>(&itValue->second)) {
+            pRawData = pRawBinary->data();
+            unSize = pRawBinary->size();
+            return true;
+        }
+        return false;
+    }
+
+    /******************************************************************************
+     * @brief   キーの参照
+     * @arg     msgRequest (in)  要求
+     * @arg     strName    (in)  フィールド名
+     * @arg     svKey      (out) キー
+     * @return  結果 true:あり false:なし・型が異なる
+     * @note
+     *****************************************************************************/
+    bool GetKey(const sbdp::Message& msgRequest, const std::string& strName, std::string_view& svKey) {
+        const uint8_t* pRawData = nullptr;
+        std::size_t unSize = 0;
+        if (!GetBytes(msgRequest, strName, pRawData, unSize)) {
+            return false;
+        }
+        svKey = std::string_view(reinterpret_cast<const char*>(pRawData), unSize);
+        return true;
+    }
+
+    /******************************************************************************
+     * @brief   1 コマンドの処理
+     * @arg     cStore      (in)  ストア
+     * @arg     msgRequest  (in)  要求
+     * @arg     msgResponse (out) 応答
+     * @return  結果 true:応答する
+     * @note    不正な要求には status=error を返す
+     *****************************************************************************/
+    bool HandleCommand(kvstore::KvStore& cStore, const sbdp::Message& msgRequest, sbdp::Message& msgResponse) {
+        std::string_view svCommand;
+        std::string_view svKey;
+        if (!GetKey(msgRequest, kvstore::k_pszCommandKey, svCommand)) {
+            msgResponse[kvstore::k_pszStatusKey] = std::string(kvstore::k_pszStatusError);
+            return true;
+        }
+        const char* pszStatus = kvstore::k_pszStatusError;
+        if (svCommand == kvstore::k_pszCommandGet) {
+            std::vector<uint8_t> vecValue;
+            if (GetKey(msgRequest, kvstore::k_pszKeyKey, svKey)) {
+                pszStatus = kvstore::k_pszStatusMiss;
+                if (cStore.Get(svKey, vecValue)) {
+                    msgResponse[kvstore::k_pszValueKey] = std::move(vecValue);
+                    pszStatus = kvstore::k_pszStatusOk;
+                }
+            }
+        }
+        else if (svCommand == kvstore::k_pszCommandSet) {
+            const uint8_t* pRawValue = nullptr;
+            std::size_t unSize = 0;
+            if (GetKey(msgRequest, kvstore::k_pszKeyKey, svKey) &&
+                GetBytes(msgRequest, kvstore::k_pszValueKey, pRawValue, unSize) &&
+                cStore.Set(svKey, pRawValue, unSize)) {
+                pszStatus = kvstore::k_pszStatusOk;
+            }
+        }
+        else if (svCommand == kvstore::k_pszCommandDel) {
+            if (GetKey(msgRequest, kvstore::k_pszKeyKey, svKey)) {
+                pszStatus = cStore.Delete(svKey) ? kvstore::k_pszStatusOk : kvstore::k_pszStatusMiss;
+            }
+        }
+        else if (svCommand == kvstore::k_pszCommandMGet) {
+            auto itCount = msgRequest.find(kvstore::k_pszCountKey);
+            const uint64_t* pRawCount = (itCount != msgRequest.end()) ? std::get_if<uint64_t>(&itCount->second) : nullptr;
+            if (pRawCount != nullptr && *pRawCount <= kvstore::k_unMaxMGetKeys) {
+                // 見つかったキーだけ "value<i>" を返す
+                for (uint64_t unIndex = 0; unIndex < *pRawCount; ++unIndex) {
+                    std::vector<uint8_t> vecValue;
+                    if (GetKey(msgRequest, kvstore::IndexedName(kvstore::k_pszKeyKey, unIndex), svKey) &&
+                        cStore.Get(svKey, vecValue)) {
+                        msgResponse[kvstore::IndexedName(kvstore::k_pszValueKey, unIndex)] = std::move(vecValue);
+                    }
+                }
+                msgResponse[kvstore::k_pszCountKey] = *pRawCount;
+                pszStatus = kvstore::k_pszStatusOk;
+            }
+        }
+        msgResponse[kvstore::k_pszStatusKey] = std::string(pszStatus);
+        return true;
+    }
+
+    /******************************************************************************
+     * @brief   コマンドライン引数の数値取得
+     * @arg     snArgc    (in) 引数の数
+     * @arg     ppszArgv  (in) 引数
+     * @arg     snIndex   (in) 位置
+     * @arg     unDefault (in) 省略時の値
+     * @return  値
+     * @note
+     *****************************************************************************/
+    uint64_t ArgOr(int snArgc, char** ppszArgv, int snIndex, uint64_t unDefault) {
+        return (snIndex < snArgc) ? std::strtoull(ppszArgv[snIndex], nullptr, 10) : unDefault;
+    }
+
+}
+
+int main(int snArgc, char** ppszArgv) {
+    uint64_t unCpus = std::max<uint64_t>(std::thread::hardware_concurrency(), 1);
+
+    kvstore::KvStoreConfig stStoreConfig;
+    stStoreConfig.unMaxBytes = static_cast<std::size_t>(ArgOr(snArgc, ppszArgv, 3, 64)) * 1024 * 1024;
+    stStoreConfig.unShards = static_cast<std::size_t>(ArgOr(snArgc, ppszArgv, 4, 16));
+    kvstore::KvStore cStore(stStoreConfig);
+
+    sbdp::ServerConfig stConfig;
+    stConfig.unPort = static_cast<uint16_t>(ArgOr(snArgc, ppszArgv, 1, 11311));
+    stConfig.unIoThreads = static_cast<std::size_t>(ArgOr(snArgc, ppszArgv, 2, unCpus));
+    stConfig.unHandlerThreads = 0;
+    stConfig.stAdmission.bEnabled = false;
+
+    // シグナルは sigwait で受けるため、ワーカースレッド生成前にブロックしておく
+    sigset_t stSignals;
+    sigemptyset(&stSignals);
+    sigaddset(&stSignals, SIGINT);
+    sigaddset(&stSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stSignals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sbdp::Server cServer(stConfig, [&cStore](const sbdp::Message& msgRequest, sbdp::Message& msgResponse) {
+        return HandleCommand(cStore, msgRequest, msgResponse);
+    });
+    if (!cServer.Start()) {
+        std::printf("listen failed on port %u\n", static_cast<unsigned>(stConfig.unPort));
+        return 1;
+    }
+    std::printf("KvServer listening on port %u (io threads %zu, memory %zu MiB, shards %zu)\n",
+                static_cast<unsigned>(stConfig.unPort), stConfig.unIoThreads,
+                stStoreConfig.unMaxBytes / (1024 * 1024), stStoreConfig.unShards);
+
+    int snSignal = 0;
+    sigwait(&stSignals, &snSignal);
+    cServer.Stop();
+
+    kvstore::KvStoreStats stStats = cStore.GetStats();
+    std::printf("gets %llu (hits %llu)  sets %llu (failed %llu)  deletes %llu  evictions %llu  "
+                "page moves %llu  items %zu  slab %zu MiB\n",
+                static_cast<unsigned long long>(stStats.unGets), static_cast<unsigned long long>(stStats.unHits),
+                static_cast<unsigned long long>(stStats.unSets), static_cast<unsigned long long>(stStats.unSetFails),
+                static_cast<unsigned long long>(stStats.unDeletes), static_cast<unsigned long long>(stStats.unEvictions),
+                static_cast<unsigned long long>(stStats.unPageMoves), stStats.unItems, stStats.unBytes / (1024 * 1024));
+    return 0;
+}
@@ -0,0 +1,544 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    KvStore.h
+ * @brief   SimpleBinaryDictionaryProtocol Example Key-Value Store
+ * @author  Satoh
+ * @note    キーのハッシュでシャードに分けたハッシュ表と、シャードごとのスラブアロケーター
+ *          （サイズクラス別の固定長チャンク、クラスごとの LRU で追い出し）によるメモリ上の
+ *          キー・バリューストア。ページを持たないクラスには他のクラスのページを移す。KvServer / KvLoadGen が共有するコマンド定義も置く
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "SBDPHash.h"
+
+namespace kvstore {
+
+    // コマンド（SBDP メッセージのキーと値）
+    constexpr const char* k_pszCommandKey = "cmd";      // "get" / "set" / "del" / "mget"
+    constexpr const char* k_pszKeyKey     = "key";
+    constexpr const char* k_pszValueKey   = "value";
+    constexpr const char* k_pszCountKey   = "count";    // mget のキー数（キーは "key0", "key1", ...）
+    constexpr const char* k_pszStatusKey  = "status";   // "ok" / "miss" / "error"
+    constexpr const char* k_pszCommandGet  = "get";
+    constexpr const char* k_pszCommandSet  = "set";
+    constexpr const char* k_pszCommandDel  = "del";
+    constexpr const char* k_pszCommandMGet = "mget";
+    constexpr const char* k_pszStatusOk    = "ok";
+    constexpr const char* k_pszStatusMiss  = "miss";
+    constexpr const char* k_pszStatusError = "error";
+    constexpr uint64_t    k_unMaxMGetKeys  = 256;
+
+    /******************************************************************************
+     * @brief   mget の i 番目のキー名（応答の値は "value" + i）
+     * @arg     pszPrefix (in) "key" または "value"
+     * @arg     unIndex   (in) 番号
+     * @return  キー名
+     * @note
+     *****************************************************************************/
+    inline std::string IndexedName(const char* pszPrefix, uint64_t unIndex) {
+        return std::string(pszPrefix) + std::to_string(unIndex);
+    }
+
+    // スラブのページサイズ（1 要素の最大サイズでもある）
+    constexpr std::size_t k_unSlabPageSize   = 256 * 1024;
+    constexpr std::size_t k_unSlabMinChunk   = 64;
+    constexpr std::size_t k_unSlabGrowthNum  = 5;   // クラスごとのチャンクサイズの伸び率 5/4
+    constexpr std::size_t k_unSlabGrowthDen  = 4;
+    constexpr uint32_t    k_unSlabFreeChunk  = UINT32_MAX;  // 空きチャンクの Item::unClass
+
+    // ストア設定
+    struct KvStoreConfig {
+        std::size_t unShards   = 16;
+        std::size_t unMaxBytes = 64 * 1024 * 1024;  // 全シャードのスラブページ合計の上限
+    };
+
+    // ストア統計
+    struct KvStoreStats {
+        uint64_t    unGets      = 0;
+        uint64_t    unHits      = 0;
+        uint64_t    unSets      = 0;
+        uint64_t    unSetFails  = 0;    // 大きすぎる・メモリを確保できなかった
+        uint64_t    unDeletes   = 0;
+        uint64_t    unEvictions = 0;
+        uint64_t    unPageMoves = 0;    // サイズクラス間で移したページ数
+        std::size_t unItems     = 0;
+        std::size_t unBytes     = 0;    // 確保済みスラブページの合計
+    };
+
+    // スラブアロケーター（要素ヘッダーにクラス内 LRU のリンクを持つ。スレッドセーフではない）
+    class SlabAllocator {
+    public:
+        // 要素（ヘッダーの直後にキー、続けて値を置く）
+        struct Item {
+            Item*    pRawPrev;
+            Item*    pRawNext;
+            uint32_t unKeyLength;
+            uint32_t unValueLength;
+            uint32_t unClass;           // 空きチャンクは k_unSlabFreeChunk
+
+            const uint8_t* Data() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+            uint8_t* Data() { return reinterpret_cast<uint8_t*>(this + 1); }
+            std::string_view Key() const {
+                return std::string_view(reinterpret_cast<const char*>(Data()), unKeyLength);
+            }
+        };
+
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     unMaxPages (in) 確保するページ数の上限
+         * @return  なし
+         * @note    チャンクサイズは 64 バイトから 1.25 倍ずつ、ページサイズまで
+         *****************************************************************************/
+        explicit SlabAllocator(std::size_t unMaxPages) : m_unMaxPages(std::max<std::size_t>(unMaxPages, 1)) {
+            std::size_t unSize = k_unSlabMinChunk;
+            while (unSize < k_unSlabPageSize) {
+                m_vecClasses.push_back(SlabClass{unSize, nullptr, nullptr, nullptr, 0});
+                unSize = (unSize * k_unSlabGrowthNum / k_unSlabGrowthDen + 7) & ~static_cast<std::size_t>(7);
+            }
+            m_vecClasses.push_back(SlabClass{k_unSlabPageSize, nullptr, nullptr, nullptr, 0});
+        }
+
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        /******************************************************************************
+         * @brief   要素に必要なバイト数からサイズクラスを決定
+         * @arg     unBytes (in) ヘッダー込みのバイト数
+         * @arg     unClass (out) サイズクラス
+         * @return  結果 true:正常 false:ページサイズを超える
+         * @note
+         *****************************************************************************/
+        bool FindClass(std::size_t unBytes, uint32_t& unClass) const {
+            auto itClass = std::lower_bound(m_vecClasses.begin(), m_vecClasses.end(), unBytes,
+                [](const SlabClass& stClass, std::size_t unSize) { return stClass.unChunkSize < unSize; });
+            if (itClass == m_vecClasses.end()) {
+                return false;
+            }
+            unClass = static_cast<uint32_t>(itClass - m_vecClasses.begin());
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   チャンクの確保
+         * @arg     unClass (in) サイズクラス
+         * @return  チャンク（空きがなくページも上限の場合は nullptr）
+         * @note    nullptr の場合、呼び出し元で同じクラスの LRU 末尾を追い出して再試行する
+         *****************************************************************************/
+        Item* Allocate(uint32_t unClass) {
+            SlabClass& stClass = m_vecClasses[unClass];
+            if (stClass.pRawFree == nullptr && !bAddPage(stClass)) {
+                return nullptr;
+            }
+            Item* pRawItem = stClass.pRawFree;
+            stClass.pRawFree = pRawItem->pRawNext;
+            pRawItem->unClass = unClass;
+            return pRawItem;
+        }
+
+        /******************************************************************************
+         * @brief   チャンクの解放
+         * @arg     pRawItem (in) LRU から外した要素
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Free(Item* pRawItem) {
+            SlabClass& stClass = m_vecClasses[pRawItem->unClass];
+            pRawItem->pRawNext = stClass.pRawFree;
+            pRawItem->unClass = k_unSlabFreeChunk;
+            stClass.pRawFree = pRawItem;
+        }
+
+        /******************************************************************************
+         * @brief   他のサイズクラスのページを 1 枚指定クラスへ移す
+         * @arg     unClass (in) 移し先のサイズクラス
+         * @arg     fnEvict (in) 移すページ上の使用中の要素ごとに呼ぶ（呼び出し元の索引から外す）
+         * @return  結果 true:移した false:移せるページがない
+         * @note    ページ数の上限に達した後、ページを持たないクラスにも要素を置けるようにする。
+         *          最も多くのページを持つクラスから、LRU 末尾の要素を含むページを選ぶ。
+         *          ページ上の要素は LRU から外して破棄する（fnEvict の後に領域を再利用する）
+         *****************************************************************************/
+        bool ReassignPage(uint32_t unClass, const std::function<void(Item*)>& fnEvict) {
+            std::size_t unVictim = m_vecClasses.size();
+            for (std::size_t unIndex = 0; unIndex < m_vecClasses.size(); ++unIndex) {
+                if (unIndex != unClass && m_vecClasses[unIndex].unPages > 0 &&
+                    (unVictim == m_vecClasses.size() ||
+                     m_vecClasses[unIndex].unPages > m_vecClasses[unVictim].unPages)) {
+                    unVictim = unIndex;
+                }
+            }
+            if (unVictim == m_vecClasses.size()) {
+                return false;
+            }
+            SlabClass& stVictim = m_vecClasses[unVictim];
+            std::size_t unPage = unFindPage(static_cast<uint32_t>(unVictim), stVictim.pRawTail);
+            uint8_t* pRawPage = m_vecPages[unPage].get();
+            for (std::size_t unOffset = 0; unOffset + stVictim.unChunkSize <= k_unSlabPageSize;
+                 unOffset += stVictim.unChunkSize) {
+                Item* pRawItem = reinterpret_cast<Item*>(pRawPage + unOffset);
+                if (pRawItem->unClass != k_unSlabFreeChunk) {
+                    fnEvict(pRawItem);
+                    Unlink(pRawItem);
+                }
+            }
+            // 移すページ上の空きチャンクを空きリストから外す
+            Item** ppRawLink = &stVictim.pRawFree;
+            while (*ppRawLink != nullptr) {
+                uint8_t* pRawChunk = reinterpret_cast<uint8_t*>(*ppRawLink);
+                if (pRawChunk >= pRawPage && pRawChunk < pRawPage + k_unSlabPageSize) {
+                    *ppRawLink = (*ppRawLink)->pRawNext;
+                }
+                else {
+                    ppRawLink = &(*ppRawLink)->pRawNext;
+                }
+            }
+            --stVictim.unPages;
+            m_vecPageClasses[unPage] = unClass;
+            vCarvePage(pRawPage, m_vecClasses[unClass]);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   LRU の先頭（最近使用）へ追加
+         * @arg     pRawItem (in) 要素
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void LinkFront(Item* pRawItem) {
+            SlabClass& stClass = m_vecClasses[pRawItem->unClass];
+            pRawItem->pRawPrev = nullptr;
+            pRawItem->pRawNext = stClass.pRawHead;
+            if (stClass.pRawHead != nullptr) {
+                stClass.pRawHead->pRawPrev = pRawItem;
+            }
+            stClass.pRawHead = pRawItem;
+            if (stClass.pRawTail == nullptr) {
+                stClass.pRawTail = pRawItem;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   LRU から外す
+         * @arg     pRawItem (in) 要素
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Unlink(Item* pRawItem) {
+            SlabClass& stClass = m_vecClasses[pRawItem->unClass];
+            (pRawItem->pRawPrev != nullptr ? pRawItem->pRawPrev->pRawNext : stClass.pRawHead) = pRawItem->pRawNext;
+            (pRawItem->pRawNext != nullptr ? pRawItem->pRawNext->pRawPrev : stClass.pRawTail) = pRawItem->pRawPrev;
+        }
+
+        /******************************************************************************
+         * @brief   LRU の先頭へ移動（参照時）
+         * @arg     pRawItem (in) 要素
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Touch(Item* pRawItem) {
+            if (m_vecClasses[pRawItem->unClass].pRawHead != pRawItem) {
+                Unlink(pRawItem);
+                LinkFront(pRawItem);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   LRU 末尾（最も古い）要素の取得
+         * @arg     unClass (in) サイズクラス
+         * @return  要素（なければ nullptr）
+         * @note
+         *****************************************************************************/
+        Item* Oldest(uint32_t unClass) const {
+            return m_vecClasses[unClass].pRawTail;
+        }
+
+        /******************************************************************************
+         * @brief   確保済みページのバイト数の取得
+         * @arg     なし
+         * @return  バイト数
+         * @note
+         *****************************************************************************/
+        std::size_t GetBytes() const {
+            return m_vecPages.size() * k_unSlabPageSize;
+        }
+
+    private:
+        struct SlabClass {
+            std::size_t unChunkSize;
+            Item*       pRawFree;   // 空きチャンク（pRawNext で連結）
+            Item*       pRawHead;   // LRU 先頭（最近使用）
+            Item*       pRawTail;   // LRU 末尾
+            std::size_t unPages;    // 割り当て済みページ数
+        };
+
+        /******************************************************************************
+         * @brief   ページを確保してチャンクに分け、空きリストへ加える
+         * @arg     stClass (in) サイズクラス
+         * @return  結果 true:正常 false:ページ数の上限
+         * @note
+         *****************************************************************************/
+        bool bAddPage(SlabClass& stClass) {
+            if (m_vecPages.size() >= m_unMaxPages) {
+                return false;
+            }
+            m_vecPages.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[k_unSlabPageSize]));
+            m_vecPageClasses.push_back(static_cast<uint32_t>(&stClass - m_vecClasses.data()));
+            vCarvePage(m_vecPages.back().get(), stClass);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ページをチャンクに分け、空きリストへ加える
+         * @arg     pRawPage (in) ページ
+         * @arg     stClass  (in) サイズクラス
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vCarvePage(uint8_t* pRawPage, SlabClass& stClass) {
+            for (std::size_t unOffset = 0; unOffset + stClass.unChunkSize <= k_unSlabPageSize;
+                 unOffset += stClass.unChunkSize) {
+                Item* pRawItem = reinterpret_cast<Item*>(pRawPage + unOffset);
+                pRawItem->pRawNext = stClass.pRawFree;
+                pRawItem->unClass = k_unSlabFreeChunk;
+                stClass.pRawFree = pRawItem;
+            }
+            ++stClass.unPages;
+        }
+
+        /******************************************************************************
+         * @brief   サイズクラスのページ番号の取得
+         * @arg     unClass  (in) サイズクラス
+         * @arg     pRawItem (in) 含まれるページを求める要素（nullptr:クラスの任意のページ）
+         * @return  ページ番号
+         * @note    ページ数はシャードあたり数十枚程度のため線形に探す
+         *****************************************************************************/
+        std::size_t unFindPage(uint32_t unClass, const Item* pRawItem) const {
+            const uint8_t* pRawChunk = reinterpret_cast<const uint8_t*>(pRawItem);
+            std::size_t unFound = m_vecPages.size();
+            for (std::size_t unIndex = 0; unIndex < m_vecPages.size(); ++unIndex) {
+                if (m_vecPageClasses[unIndex] != unClass) {
+                    continue;
+                }
+                const uint8_t* pRawPage = m_vecPages[unIndex].get();
+                if (pRawItem == nullptr || (pRawChunk >= pRawPage && pRawChunk < pRawPage + k_unSlabPageSize)) {
+                    return unIndex;
+                }
+                unFound = unIndex;
+            }
+            return unFound;
+        }
+
+        std::size_t                             m_unMaxPages;
+        std::vector<SlabClass>                  m_vecClasses;
+        std::vector<std::unique_ptr<uint8_t[]>> m_vecPages;
+        std::vector<uint32_t>                   m_vecPageClasses;   // ページごとのサイズクラス
+    };
+
+    // シャード分割したキー・バリューストア（スレッドセーフ）
+    class KvStore {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     stConfig (in) ストア設定
+         * @return  なし
+         * @note    ページはシャードごとに上限を等分して持つ（シャード間で融通しない）
+         *****************************************************************************/
+        explicit KvStore(const KvStoreConfig& stConfig) {
+            std::size_t unShards = std::max<std::size_t>(stConfig.unShards, 1);
+            std::size_t unPages = stConfig.unMaxBytes / k_unSlabPageSize / unShards;
+            for (std::size_t unIndex = 0; unIndex < unShards; ++unIndex) {
+                m_vecShards.push_back(std::make_unique<Shard>(unPages));
+            }
+        }
+
+        KvStore(const KvStore&) = delete;
+        KvStore& operator=(const KvStore&) = delete;
+
+        /******************************************************************************
+         * @brief   値の取得
+         * @arg     svKey    (in)  キー
+         * @arg     vecValue (out) 値（コピー）
+         * @return  結果 true:あり false:なし
+         * @note
+         *****************************************************************************/
+        bool Get(std::string_view svKey, std::vector<uint8_t>& vecValue) {
+            Shard& stShard = stGetShard(svKey);
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            ++stShard.stStats.unGets;
+            auto itItem = stShard.mapItems.find(svKey);
+            if (itItem == stShard.mapItems.end()) {
+                return false;
+            }
+            SlabAllocator::Item* pRawItem = itItem->second;
+            stShard.cSlab.Touch(pRawItem);
+            const uint8_t* pRawValue = pRawItem->Data() + pRawItem->unKeyLength;
+            vecValue.assign(pRawValue, pRawValue + pRawItem->unValueLength);
+            ++stShard.stStats.unHits;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   値の設定
+         * @arg     svKey     (in) キー
+         * @arg     pRawValue (in) 値
+         * @arg     unSize    (in) 値のバイト数
+         * @return  結果 true:正常 false:大きすぎる・メモリを確保できない
+         * @note    空きがなければ同じサイズクラスの最も古い要素を追い出し、
+         *          クラスにページがなければ他のクラスからページを移す。
+         *          同じキーの古い値は新しい要素を確保できてから置き換えるため、
+         *          失敗した場合は古い値が残る
+         *****************************************************************************/
+        bool Set(std::string_view svKey, const uint8_t* pRawValue, std::size_t unSize) {
+            Shard& stShard = stGetShard(svKey);
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            ++stShard.stStats.unSets;
+            uint32_t unClass = 0;
+            if (!stShard.cSlab.FindClass(sizeof(SlabAllocator::Item) + svKey.size() + unSize, unClass)) {
+                ++stShard.stStats.unSetFails;
+                return false;
+            }
+            SlabAllocator::Item* pRawItem = pRawAllocate(stShard, unClass);
+            if (pRawItem == nullptr) {
+                ++stShard.stStats.unSetFails;
+                return false;
+            }
+            bErase(stShard, svKey);
+            pRawItem->unKeyLength = static_cast<uint32_t>(svKey.size());
+            pRawItem->unValueLength = static_cast<uint32_t>(unSize);
+            std::memcpy(pRawItem->Data(), svKey.data(), svKey.size());
+            if (unSize != 0) {
+                std::memcpy(pRawItem->Data() + svKey.size(), pRawValue, unSize);
+            }
+            stShard.cSlab.LinkFront(pRawItem);
+            stShard.mapItems.emplace(pRawItem->Key(), pRawItem);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   値の削除
+         * @arg     svKey (in) キー
+         * @return  結果 true:削除した false:なし
+         * @note
+         *****************************************************************************/
+        bool Delete(std::string_view svKey) {
+            Shard& stShard = stGetShard(svKey);
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            ++stShard.stStats.unDeletes;
+            return bErase(stShard, svKey);
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  全シャードの合計
+         * @note
+         *****************************************************************************/
+        KvStoreStats GetStats() const {
+            KvStoreStats stTotal;
+            for (const std::unique_ptr<Shard>& upShard : m_vecShards) {
+                std::lock_guard<std::mutex> lock(upShard->mtxShard);
+                stTotal.unGets += upShard->stStats.unGets;
+                stTotal.unHits += upShard->stStats.unHits;
+                stTotal.unSets += upShard->stStats.unSets;
+                stTotal.unSetFails += upShard->stStats.unSetFails;
+                stTotal.unDeletes += upShard->stStats.unDeletes;
+                stTotal.unEvictions += upShard->stStats.unEvictions;
+                stTotal.unPageMoves += upShard->stStats.unPageMoves;
+                stTotal.unItems += upShard->mapItems.size();
+                stTotal.unBytes += upShard->cSlab.GetBytes();
+            }
+            return stTotal;
+        }
+
+    private:
+        struct KeyHash {
+            std::size_t operator()(std::string_view svKey) const {
+                return static_cast<std::size_t>(sbdp::HashBytes(svKey));
+            }
+        };
+
+        struct Shard {
+            explicit Shard(std::size_t unMaxPages) : cSlab(unMaxPages) { }
+
+            mutable std::mutex                                                      mtxShard;
+            SlabAllocator                                                           cSlab;
+            std::unordered_map<std::string_view, SlabAllocator::Item*, KeyHash>     mapItems;  // キーは要素内を指す
+            KvStoreStats                                                            stStats;
+        };
+
+        /******************************************************************************
+         * @brief   キーの属するシャードの取得
+         * @arg     svKey (in) キー
+         * @return  シャード
+         * @note    表内のバケット選択と相関しないよう、ハッシュの上位ビットを使う
+         *****************************************************************************/
+        Shard& stGetShard(std::string_view svKey) {
+            return *m_vecShards[static_cast<std::size_t>((sbdp::HashBytes(svKey) >> 32) % m_vecShards.size())];
+        }
+
+        /******************************************************************************
+         * @brief   要素の確保（シャードのロック中に呼ぶ）
+         * @arg     stShard (in) シャード
+         * @arg     unClass (in) サイズクラス
+         * @return  要素（確保できない場合は nullptr）
+         * @note    空きがなければ同じサイズクラスの LRU 末尾から追い出して再試行する。
+         *          クラスに要素がない（ページがない）場合は他のクラスのページを移す。
+         *          クラス間のページ数の偏りはそれ以外では調整しない
+         *****************************************************************************/
+        static SlabAllocator::Item* pRawAllocate(Shard& stShard, uint32_t unClass) {
+            SlabAllocator::Item* pRawItem = stShard.cSlab.Allocate(unClass);
+            while (pRawItem == nullptr) {
+                SlabAllocator::Item* pRawOldest = stShard.cSlab.Oldest(unClass);
+                if (pRawOldest != nullptr) {
+                    bErase(stShard, pRawOldest->Key());
+                    ++stShard.stStats.unEvictions;
+                }
+                else {
+                    auto fnEvict = [&stShard](SlabAllocator::Item* pRawEvicted) {
+                        stShard.mapItems.erase(stShard.mapItems.find(pRawEvicted->Key()));
+                        ++stShard.stStats.unEvictions;
+                    };
+                    if (!stShard.cSlab.ReassignPage(unClass, fnEvict)) {
+                        return nullptr;
+                    }
+                    ++stShard.stStats.unPageMoves;
+                }
+                pRawItem = stShard.cSlab.Allocate(unClass);
+            }
+            return pRawItem;
+        }
+
+        /******************************************************************************
+         * @brief   要素の削除（シャードのロック中に呼ぶ）
+         * @arg     stShard (in) シャード
+         * @arg     svKey   (in) キー
+         * @return  結果 true:削除した false:なし
+         * @note
+         *****************************************************************************/
+        static bool bErase(Shard& stShard, std::string_view svKey) {
+            auto itItem = stShard.mapItems.find(svKey);
+            if (itItem == stShard.mapItems.end()) {
+                return false;
+            }
+            SlabAllocator::Item* pRawItem = itItem->second;
+            stShard.mapItems.erase(itItem);
+            stShard.cSlab.Unlink(pRawItem);
+            stShard.cSlab.Free(pRawItem);
+            return true;
+        }
+
+        std::vector<std::unique_ptr<Shard>> m_vecShards;
+    };
+
+} // namespace kvstore
@@ -0,0 +1,740 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPBroker.h
+ * @brief   SimpleBinaryDictionaryProtocol Publish/Subscribe Broker
+ * @author  Satoh
+ * @note    トピック指定のフレームをデコードせずに購読者へ中継する（Linux 専用）
+ *
+ *          購読 : {"subscribe": "<pattern>"} / {"unsubscribe": "<pattern>"}
+ *          配信 : "topic" キー（文字列）を持つ任意のメッセージ
+ *          パターンは '.' 区切りで、'*' は 1 階層、末尾の '#' は 0 階層以上に一致
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPSharedFrame.h"
+#include "SBDPFieldView.h"
+#include "SBDPEventLoop.h"
+
+namespace sbdp {
+
+    // 予約キー
+    inline constexpr std::string_view k_svTopicKey       = "topic";
+    inline constexpr std::string_view k_svSubscribeKey   = "subscribe";
+    inline constexpr std::string_view k_svUnsubscribeKey = "unsubscribe";
+    // トピックの区切り文字とワイルドカード
+    constexpr char k_chTopicSeparator = '.';
+    inline constexpr std::string_view k_svWildcardOne  = "*";
+    inline constexpr std::string_view k_svWildcardRest = "#";
+
+    // 送信キューが上限を超えた購読者の扱い
+    enum class SlowConsumerPolicy : uint8_t {
+        DropNewest = 0,     // 上限を超えるフレームを破棄する
+        Disconnect,         // 接続を切断する
+        DropOldest,         // 未送信の古いフレームを破棄して新しいフレームを積む
+    };
+
+    // ブローカー設定
+    struct BrokerConfig {
+        uint16_t           unPort          = 0;
+        std::size_t        unWorkerCount   = 1;
+        std::size_t        unMaxQueueBytes = 4 * 1024 * 1024;
+        std::size_t        unMaxFrameSize  = 16 * 1024 * 1024;
+        SlowConsumerPolicy ePolicy         = SlowConsumerPolicy::DropNewest;
+        uint64_t           unIdleTimeoutMs = 0;     // 受信のないセッションを閉じるまでの時間（0:無効）
+        AddressFamily      eFamily         = AddressFamily::IPv4;   // 待ち受けのアドレスファミリー
+    };
+
+    // ブローカー統計
+    struct BrokerStats {
+        uint64_t unPublished    = 0;    // 受信した配信フレーム数
+        uint64_t unDelivered    = 0;    // 購読者の送信キューへ積んだ数
+        uint64_t unDropped      = 0;    // 送信キュー超過で破棄した数
+        uint64_t unDisconnected = 0;    // 送信キュー超過で切断した購読者数
+        uint64_t unIdleClosed   = 0;    // 無受信タイムアウトで閉じたセッション数
+    };
+
+    /******************************************************************************
+     * @brief   ブローカー設定から購読者ソケットの送信キュー上限を生成
+     * @arg     stConfig (in) ブローカー設定
+     * @return  送信キュー上限（低ウォーターマークは上限の半分）
+     * @note    ループスレッドを止めないよう Block は使わない
+     *****************************************************************************/
+    inline SendQueueLimits MakeSendQueueLimits(const BrokerConfig& stConfig) {
+        SendQueueLimits stLimits;
+        stLimits.unHighWatermark = stConfig.unMaxQueueBytes;
+        stLimits.unLowWatermark = stConfig.unMaxQueueBytes / 2;
+        switch (stConfig.ePolicy) {
+        case SlowConsumerPolicy::Disconnect:
+            stLimits.ePolicy = OverflowPolicy::Disconnect;
+            break;
+        case SlowConsumerPolicy::DropOldest:
+            stLimits.ePolicy = OverflowPolicy::DropOldest;
+            break;
+        case SlowConsumerPolicy::DropNewest:
+        default:
+            stLimits.ePolicy = OverflowPolicy::DropNewest;
+            break;
+        }
+        return stLimits;
+    }
+
+    // トピックパターンのトライ木索引
+    class TopicTrie {
+    public:
+        using SubscriberId = uint64_t;
+
+        /******************************************************************************
+         * @brief   購読パターンの登録
+         * @arg     svPattern (in) 購読パターン
+         * @arg     unId      (in) 購読者 ID
+         * @return  結果 true:登録 false:不正なパターン
+         * @note    '#' は末尾の階層にのみ指定できる
+         *****************************************************************************/
+        bool Insert(std::string_view svPattern, SubscriberId unId) {
+            std::vector<std::string_view> vecSegments;
+            if (!bSplitPattern(svPattern, vecSegments)) {
+                return false;
+            }
+            Node* pRawNode = &m_stRoot;
+            for (std::string_view svSegment : vecSegments) {
+                auto itChild = pRawNode->mapChildren.find(svSegment);
+                if (itChild == pRawNode->mapChildren.end()) {
+                    itChild = pRawNode->mapChildren.emplace(std::string(svSegment), std::make_unique<Node>()).first;
+                }
+                pRawNode = itChild->second.get();
+            }
+            std::vector<SubscriberId>& vecIds = pRawNode->vecSubscribers;
+            if (std::find(vecIds.begin(), vecIds.end(), unId) == vecIds.end()) {
+                vecIds.push_back(unId);
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   購読パターンの削除
+         * @arg     svPattern (in) 購読パターン
+         * @arg     unId      (in) 購読者 ID
+         * @return  なし
+         * @note    購読者も子もなくなったノードは末端から順に取り除く
+         *****************************************************************************/
+        void Erase(std::string_view svPattern, SubscriberId unId) {
+            std::vector<std::string_view> vecSegments;
+            if (!bSplitPattern(svPattern, vecSegments)) {
+                return;
+            }
+            std::vector<Node*> vecPath;
+            vecPath.reserve(vecSegments.size() + 1);
+            vecPath.push_back(&m_stRoot);
+            for (std::string_view svSegment : vecSegments) {
+                auto itChild = vecPath.back()->mapChildren.find(svSegment);
+                if (itChild == vecPath.back()->mapChildren.end()) {
+                    return;
+                }
+                vecPath.push_back(itChild->second.get());
+            }
+            std::vector<SubscriberId>& vecIds = vecPath.back()->vecSubscribers;
+            vecIds.erase(std::remove(vecIds.begin(), vecIds.end(), unId), vecIds.end());
+            for (std::size_t unDepth = vecSegments.size(); unDepth > 0; --unDepth) {
+                const Node& stNode = *vecPath[unDepth];
+                if (!stNode.vecSubscribers.empty() || !stNode.mapChildren.empty()) {
+                    break;
+                }
+                Node& stParent = *vecPath[unDepth - 1];
+                stParent.mapChildren.erase(stParent.mapChildren.find(vecSegments[unDepth - 1]));
+            }
+        }
+
+        /******************************************************************************
+         * @brief   トピックに一致する購読者の検索
+         * @arg     svTopic (in)  トピック
+         * @arg     vecIds  (out) 一致した購読者 ID（重複なし）
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Match(std::string_view svTopic, std::vector<SubscriberId>& vecIds) const {
+            vecIds.clear();
+            std::vector<std::string_view> vecSegments;
+            vSplit(svTopic, vecSegments);
+            vMatch(m_stRoot, vecSegments, 0, vecIds);
+            std::sort(vecIds.begin(), vecIds.end());
+            vecIds.erase(std::unique(vecIds.begin(), vecIds.end()), vecIds.end());
+        }
+
+    private:
+        // 子は string_view のまま検索できるよう透過比較の map で持つ
+        struct Node {
+            std::map<std::string, std::unique_ptr<Node>, std::less<>> mapChildren;
+            std::vector<SubscriberId>                                 vecSubscribers;
+        };
+
+        /******************************************************************************
+         * @brief   '.' 区切りで分割
+         * @arg     svText      (in)  分割する文字列
+         * @arg     vecSegments (out) 分割結果
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vSplit(std::string_view svText, std::vector<std::string_view>& vecSegments) {
+            std::size_t unBegin = 0;
+            while (true) {
+                std::size_t unEnd = svText.find(k_chTopicSeparator, unBegin);
+                if (unEnd == std::string_view::npos) {
+                    vecSegments.push_back(svText.substr(unBegin));
+                    return;
+                }
+                vecSegments.push_back(svText.substr(unBegin, unEnd - unBegin));
+                unBegin = unEnd + 1;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   購読パターンの分割と検証
+         * @arg     svPattern   (in)  購読パターン
+         * @arg     vecSegments (out) 分割結果
+         * @return  結果 true:正常 false:'#' が末尾以外にある
+         * @note
+         *****************************************************************************/
+        static bool bSplitPattern(std::string_view svPattern,
+                                  std::vector<std::string_view>& vecSegments) {
+            vSplit(svPattern, vecSegments);
+            for (std::size_t unIndex = 0; unIndex + 1 < vecSegments.size(); ++unIndex) {
+                if (vecSegments[unIndex] == k_svWildcardRest) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   トライ木の再帰探索
+         * @arg     stNode      (in)  探索中のノード
+         * @arg     vecSegments (in)  トピックの階層
+         * @arg     unDepth     (in)  探索中の階層
+         * @arg     vecIds      (out) 一致した購読者 ID
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vMatch(const Node& stNode, const std::vector<std::string_view>& vecSegments,
+                           std::size_t unDepth, std::vector<SubscriberId>& vecIds) {
+            auto itRest = stNode.mapChildren.find(k_svWildcardRest);
+            if (itRest != stNode.mapChildren.end()) {
+                const std::vector<SubscriberId>& vecRest = itRest->second->vecSubscribers;
+                vecIds.insert(vecIds.end(), vecRest.begin(), vecRest.end());
+            }
+            if (unDepth == vecSegments.size()) {
+                vecIds.insert(vecIds.end(), stNode.vecSubscribers.begin(),
+                              stNode.vecSubscribers.end());
+                return;
+            }
+            auto itExact = stNode.mapChildren.find(vecSegments[unDepth]);
+            if (itExact != stNode.mapChildren.end()) {
+                vMatch(*itExact->second, vecSegments, unDepth + 1, vecIds);
+            }
+            auto itOne = stNode.mapChildren.find(k_svWildcardOne);
+            if (itOne != stNode.mapChildren.end()) {
+                vMatch(*itOne->second, vecSegments, unDepth + 1, vecIds);
+            }
+        }
+
+    private:
+        Node m_stRoot;
+    };
+
+    // Publish/Subscribe ブローカー（ワーカーごとにイベントループと購読索引の複製を持つ）
+    class Broker {
+    public:
+        explicit Broker(const BrokerConfig& stConfig)
+            : m_stConfig(stConfig), m_bRunning(false), m_unNextWorker(0) {
+            if (m_stConfig.unWorkerCount == 0 || m_stConfig.unWorkerCount > k_unMaxWorkers) {
+                throw std::invalid_argument("Broker: invalid worker count");
+            }
+        }
+        ~Broker() { Stop(); }
+
+        Broker(const Broker&) = delete;
+        Broker& operator=(const Broker&) = delete;
+
+        /******************************************************************************
+         * @brief   待ち受けとワーカースレッドの開始
+         * @arg     なし
+         * @return  結果 true:正常 false:ソケット作成・バインド・待ち受け失敗
+         * @note
+         *****************************************************************************/
+        bool Start() {
+            if (m_bRunning) {
+                return true;
+            }
+            if (!m_cListener.Create(SocketOptions(), m_stConfig.eFamily) || !m_cListener.Bind(m_stConfig.unPort) ||
+                !m_cListener.Listen() || !m_cListener.SetNonBlocking(true)) {
+                m_cListener.Close();
+                return false;
+            }
+            for (std::size_t unIndex = 0; unIndex < m_stConfig.unWorkerCount; ++unIndex) {
+                m_vecWorkers.push_back(std::make_unique<Worker>(*this, unIndex));
+            }
+            Worker& cAcceptor = *m_vecWorkers.front();
+            cAcceptor.m_cLoop.Add(m_cListener.GetHandle(), k_unEventRead,
+                                  [this](uint32_t) { vAcceptPending(); });
+            for (std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                Worker& cWorker = *upWorker;
+                m_vecThreads.emplace_back([&cWorker]() { cWorker.m_cLoop.Run(); });
+            }
+            m_bRunning = true;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ブローカーの停止
+         * @arg     なし
+         * @return  なし
+         * @note    全接続をクローズする
+         *****************************************************************************/
+        void Stop() {
+            if (!m_bRunning) {
+                return;
+            }
+            for (std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                upWorker->m_cLoop.Stop();
+            }
+            for (std::thread& thWorker : m_vecThreads) {
+                thWorker.join();
+            }
+            m_vecThreads.clear();
+            m_vecWorkers.clear();
+            m_cListener.Close();
+            m_bRunning = false;
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  全ワーカーの合計
+         * @note    Start 後、Stop 前に呼び出すこと
+         *****************************************************************************/
+        BrokerStats GetStats() const {
+            BrokerStats stStats;
+            for (const std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                stStats.unPublished    += upWorker->m_unPublished.load(std::memory_order_relaxed);
+                stStats.unDelivered    += upWorker->m_unDelivered.load(std::memory_order_relaxed);
+                stStats.unDropped      += upWorker->m_unDropped.load(std::memory_order_relaxed);
+                stStats.unDisconnected += upWorker->m_unDisconnected.load(std::memory_order_relaxed);
+                stStats.unIdleClosed   += upWorker->m_unIdleClosed.load(std::memory_order_relaxed);
+            }
+            return stStats;
+        }
+
+    private:
+        // 購読者 ID の上位ビットに所属ワーカー番号を格納する
+        static constexpr uint32_t    k_unWorkerShift = 48;
+        static constexpr std::size_t k_unMaxWorkers  = 1024;
+
+        struct Session {
+            Socket                   cSocket;
+            std::vector<std::string> vecPatterns;
+            bool                     bWantWrite = false;
+            bool                     bDirty     = false;
+            bool                     bClosing   = false;    // クローズ予約済み
+            TimerNode                stIdleTimer;
+        };
+
+        struct Delivery {
+            SharedFrame cFrame;
+            uint64_t    unSubscriberId;
+        };
+
+        // ワーカー（1 スレッド・1 イベントループ、所属セッションはこのスレッドのみが操作する）
+        class Worker {
+        public:
+            Worker(Broker& cBroker, std::size_t unIndex)
+                : m_cLoop(), m_unPublished(0), m_unDelivered(0), m_unDropped(0),
+                  m_unDisconnected(0), m_unIdleClosed(0), m_cBroker(cBroker), m_unIndex(unIndex),
+                  m_unNextSequence(1), m_vecOutbox(cBroker.m_stConfig.unWorkerCount) {
+                m_cLoop.AddIterationCallback([this]() { vFlushIteration(); });
+            }
+
+            /******************************************************************************
+             * @brief   受け付けた接続をこのワーカーへ登録
+             * @arg     spSocket (in) 受け付けたソケット
+             * @return  なし
+             * @note    ループスレッドで呼び出すこと
+             *****************************************************************************/
+            void Attach(const std::shared_ptr<Socket>& spSocket) {
+                uint64_t unId = (static_cast<uint64_t>(m_unIndex) << k_unWorkerShift) |
+                                m_unNextSequence++;
+                std::unique_ptr<Session> upSession = std::make_unique<Session>();
+                upSession->cSocket = std::move(*spSocket);
+                upSession->cSocket.SetNonBlocking(true);
+                upSession->cSocket.SetMaxFrameSize(m_cBroker.m_stConfig.unMaxFrameSize);
+                upSession->cSocket.SetSendQueueLimits(MakeSendQueueLimits(m_cBroker.m_stConfig));
+                // タイマーノードはセッションが所有するため、コールバック内では閉じずにタスクとして投げる
+                upSession->stIdleTimer.fnCallback = [this, unId]() {
+                    m_cLoop.Post([this, unId]() {
+                        if (m_mapSessions.count(unId) != 0) {
+                            m_unIdleClosed.fetch_add(1, std::memory_order_relaxed);
+                            vCloseSession(unId);
+                        }
+                    });
+                };
+                vArmIdleTimer(*upSession);
+                SocketOptions stOptions;
+                stOptions.bNoDelay = true;
+                upSession->cSocket.SetOptions(stOptions);
+                SOCKET hHandle = upSession->cSocket.GetHandle();
+                m_mapSessions.emplace(unId, std::move(upSession));
+                m_cLoop.Add(hHandle, k_unEventRead,
+                            [this, unId](uint32_t unEvents) { vOnEvent(unId, unEvents); });
+            }
+
+            /******************************************************************************
+             * @brief   購読索引の更新
+             * @arg     strPattern (in) 購読パターン
+             * @arg     unId       (in) 購読者 ID
+             * @arg     bInsert    (in) true:登録 false:削除
+             * @return  なし
+             * @note    ループスレッドで呼び出すこと
+             *****************************************************************************/
+            void UpdateIndex(const std::string& strPattern, uint64_t unId, bool bInsert) {
+                if (bInsert) {
+                    m_cTrie.Insert(strPattern, unId);
+                }
+                else {
+                    m_cTrie.Erase(strPattern, unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   購読者の送信キューへフレームを積む
+             * @arg     cFrame (in) 配信フレーム
+             * @arg     unId   (in) 購読者 ID
+             * @return  なし
+             * @note    送信キュー上限を超える場合はソケットに設定したポリシーに従う。
+             *          切断ポリシーで閉じるセッションは、送信元として受信処理中の可能性があるため
+             *          クローズを予約し、フレーム処理の後でまとめて閉じる
+             *****************************************************************************/
+            void Deliver(const SharedFrame& cFrame, uint64_t unId) {
+                auto itSession = m_mapSessions.find(unId);
+                if (itSession == m_mapSessions.end() || itSession->second->bClosing) {
+                    return;
+                }
+                Session& stSession = *itSession->second;
+                uint64_t unDroppedBefore = stSession.cSocket.GetStats().unFramesDropped;
+                EnqueueResult eResult = stSession.cSocket.EnqueueFrame(cFrame);
+                if (eResult == EnqueueResult::Disconnected) {
+                    m_unDisconnected.fetch_add(1, std::memory_order_relaxed);
+                    vRequestClose(stSession, unId);
+                    return;
+                }
+                uint64_t unDropped = stSession.cSocket.GetStats().unFramesDropped - unDroppedBefore;
+                if (unDropped > 0) {
+                    m_unDropped.fetch_add(unDropped, std::memory_order_relaxed);
+                }
+                if (eResult == EnqueueResult::Dropped) {
+                    return;
+                }
+                m_unDelivered.fetch_add(1, std::memory_order_relaxed);
+                if (!stSession.bDirty) {
+                    stSession.bDirty = true;
+                    m_vecDirty.push_back(unId);
+                }
+            }
+
+        private:
+            /******************************************************************************
+             * @brief   セッションのイベント処理
+             * @arg     unId     (in) 購読者 ID
+             * @arg     unEvents (in) 発生イベント
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vOnEvent(uint64_t unId, uint32_t unEvents) {
+                auto itSession = m_mapSessions.find(unId);
+                if (itSession == m_mapSessions.end()) {
+                    return;
+                }
+                Session& stSession = *itSession->second;
+                try {
+                    if (unEvents & k_unEventWrite) {
+                        vFlushSession(stSession);
+                    }
+                    if (unEvents & (k_unEventRead | k_unEventError)) {
+                        vOnReadable(unId, stSession);
+                    }
+                }
+                catch (const std::exception&) {
+                    vCloseSession(unId);
+                }
+                vClosePending();
+            }
+
+            /******************************************************************************
+             * @brief   受信データの処理
+             * @arg     unId      (in) 購読者 ID
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note    切断・不正フレームは例外として呼び出し元でクローズする
+             *****************************************************************************/
+            void vOnReadable(uint64_t unId, Session& stSession) {
+                vArmIdleTimer(stSession);
+                bool bClosed = (stSession.cSocket.ReceiveAvailable() == ReceiveResult::Closed);
+                std::vector<uint8_t> vecFrame;
+                // 配信先として自分自身のクローズが予約された場合はそれ以上読まない
+                while (m_mapSessions.count(unId) != 0 && !stSession.bClosing &&
+                       stSession.cSocket.PopFrame(vecFrame)) {
+                    vHandleFrame(unId, stSession, SharedFrame(std::move(vecFrame)));
+                    vecFrame = std::vector<uint8_t>();
+                }
+                if (bClosed) {
+                    vCloseSession(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   1 フレームの振り分け（配信・購読・購読解除）
+             * @arg     unId      (in) 送信元 ID
+             * @arg     stSession (in) 送信元セッション
+             * @arg     cFrame    (in) 受信フレーム
+             * @return  なし
+             * @note    予約キー以外は読まない
+             *****************************************************************************/
+            void vHandleFrame(uint64_t unId, Session& stSession, const SharedFrame& cFrame) {
+                FieldView stField {};
+                const std::vector<uint8_t>& vecBytes = cFrame.Bytes();
+                if (FindField(vecBytes, k_svTopicKey, stField) && stField.eType == TYPE_STRING) {
+                    vPublish(stField.AsStringView(), cFrame);
+                    return;
+                }
+                if (FindField(vecBytes, k_svSubscribeKey, stField) && stField.eType == TYPE_STRING) {
+                    std::string strPattern(stField.AsStringView());
+                    stSession.vecPatterns.push_back(strPattern);
+                    m_cBroker.vBroadcastIndexUpdate(strPattern, unId, true);
+                    return;
+                }
+                if (FindField(vecBytes, k_svUnsubscribeKey, stField) && stField.eType == TYPE_STRING) {
+                    std::string strPattern(stField.AsStringView());
+                    std::vector<std::string>& vecPatterns = stSession.vecPatterns;
+                    vecPatterns.erase(std::remove(vecPatterns.begin(), vecPatterns.end(), strPattern),
+                                      vecPatterns.end());
+                    m_cBroker.vBroadcastIndexUpdate(strPattern, unId, false);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   トピックに一致する購読者への配信
+             * @arg     svTopic (in) トピック
+             * @arg     cFrame  (in) 配信フレーム
+             * @return  なし
+             * @note    他ワーカーの購読者分はイテレーション終了時にまとめて転送する
+             *****************************************************************************/
+            void vPublish(std::string_view svTopic, const SharedFrame& cFrame) {
+                m_unPublished.fetch_add(1, std::memory_order_relaxed);
+                m_cTrie.Match(svTopic, m_vecMatched);
+                for (uint64_t unId : m_vecMatched) {
+                    std::size_t unWorker = static_cast<std::size_t>(unId >> k_unWorkerShift);
+                    if (unWorker == m_unIndex) {
+                        Deliver(cFrame, unId);
+                    }
+                    else {
+                        m_vecOutbox[unWorker].push_back(Delivery{cFrame, unId});
+                    }
+                }
+            }
+
+            /******************************************************************************
+             * @brief   イテレーション終了時の転送と送信
+             * @arg     なし
+             * @return  なし
+             * @note    他ワーカー宛ての配信はワーカーごとに 1 タスクへまとめる
+             *****************************************************************************/
+            void vFlushIteration() {
+                for (std::size_t unWorker = 0; unWorker < m_vecOutbox.size(); ++unWorker) {
+                    if (m_vecOutbox[unWorker].empty()) {
+                        continue;
+                    }
+                    std::shared_ptr<std::vector<Delivery>> spBatch =
+                        std::make_shared<std::vector<Delivery>>(std::move(m_vecOutbox[unWorker]));
+                    m_vecOutbox[unWorker].clear();
+                    Worker& cTarget = *m_cBroker.m_vecWorkers[unWorker];
+                    cTarget.m_cLoop.Post([&cTarget, spBatch]() {
+                        for (const Delivery& stDelivery : *spBatch) {
+                            cTarget.Deliver(stDelivery.cFrame, stDelivery.unSubscriberId);
+                        }
+                    });
+                }
+                std::vector<uint64_t> vecDirty;
+                vecDirty.swap(m_vecDirty);
+                for (uint64_t unId : vecDirty) {
+                    auto itSession = m_mapSessions.find(unId);
+                    if (itSession == m_mapSessions.end() || itSession->second->bClosing) {
+                        continue;
+                    }
+                    itSession->second->bDirty = false;
+                    try {
+                        vFlushSession(*itSession->second);
+                    }
+                    catch (const std::exception&) {
+                        vCloseSession(unId);
+                    }
+                }
+                vClosePending();
+            }
+
+            /******************************************************************************
+             * @brief   セッションのクローズ予約
+             * @arg     stSession (in) セッション
+             * @arg     unId      (in) 購読者 ID
+             * @return  なし
+             * @note    予約したセッションには以後配信しない
+             *****************************************************************************/
+            void vRequestClose(Session& stSession, uint64_t unId) {
+                if (!stSession.bClosing) {
+                    stSession.bClosing = true;
+                    m_vecToClose.push_back(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   予約したセッションのクローズ
+             * @arg     なし
+             * @return  なし
+             * @note    セッションを参照中の処理がない時点で呼び出すこと
+             *****************************************************************************/
+            void vClosePending() {
+                std::vector<uint64_t> vecToClose;
+                vecToClose.swap(m_vecToClose);
+                for (uint64_t unId : vecToClose) {
+                    vCloseSession(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   セッションの送信キューを送出し書き込み監視を切り替える
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vFlushSession(Session& stSession) {
+                bool bWantWrite = (stSession.cSocket.FlushSendQueue() == FlushResult::WouldBlock);
+                if (bWantWrite != stSession.bWantWrite) {
+                    stSession.bWantWrite = bWantWrite;
+                    m_cLoop.Modify(stSession.cSocket.GetHandle(),
+                                   bWantWrite ? (k_unEventRead | k_unEventWrite) : k_unEventRead);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   セッションのクローズと購読の解除
+             * @arg     unId (in) 購読者 ID
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vCloseSession(uint64_t unId) {
+                auto itSession = m_mapSessions.find(unId);
+                if (itSession == m_mapSessions.end()) {
+                    return;
+                }
+                std::unique_ptr<Session> upSession = std::move(itSession->second);
+                m_mapSessions.erase(itSession);
+                m_cLoop.Remove(upSession->cSocket.GetHandle());
+                m_cLoop.CancelTimer(upSession->stIdleTimer);
+                for (const std::string& strPattern : upSession->vecPatterns) {
+                    m_cBroker.vBroadcastIndexUpdate(strPattern, unId, false);
+                }
+                upSession->cSocket.Close();
+            }
+
+            /******************************************************************************
+             * @brief   無受信タイマーの再設定
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note    設定で無効の場合は何もしない
+             *****************************************************************************/
+            void vArmIdleTimer(Session& stSession) {
+                uint64_t unIdleTimeoutMs = m_cBroker.m_stConfig.unIdleTimeoutMs;
+                if (unIdleTimeoutMs != 0) {
+                    m_cLoop.ArmTimer(stSession.stIdleTimer, unIdleTimeoutMs);
+                }
+            }
+
+        public:
+            EventLoop                                              m_cLoop;
+            std::atomic<uint64_t>                                  m_unPublished;
+            std::atomic<uint64_t>                                  m_unDelivered;
+            std::atomic<uint64_t>                                  m_unDropped;
+            std::atomic<uint64_t>                                  m_unDisconnected;
+            std::atomic<uint64_t>                                  m_unIdleClosed;
+
+        private:
+            Broker&                                                m_cBroker;
+            std::size_t                                            m_unIndex;
+            uint64_t                                               m_unNextSequence;
+            TopicTrie                                              m_cTrie;
+            std::unordered_map<uint64_t, std::unique_ptr<Session>> m_mapSessions;
+            std::vector<std::vector<Delivery>>                     m_vecOutbox;
+            std::vector<uint64_t>                                  m_vecDirty;
+            std::vector<uint64_t>                                  m_vecToClose;
+            std::vector<uint64_t>                                  m_vecMatched;
+        };
+
+        /******************************************************************************
+         * @brief   保留中の接続をすべて受け付けてワーカーへ割り振る
+         * @arg     なし
+         * @return  なし
+         * @note    ワーカー 0 のループスレッドで実行される
+         *****************************************************************************/
+        void vAcceptPending() {
+            std::vector<Socket> vecAccepted;
+            try {
+                m_cListener.AcceptMany(vecAccepted);
+            }
+            catch (const std::exception&) {
+                // 受け入れ済みの分は割り振る
+            }
+            for (Socket& cAccepted : vecAccepted) {
+                std::shared_ptr<Socket> spSocket = std::make_shared<Socket>(std::move(cAccepted));
+                Worker& cTarget = *m_vecWorkers[m_unNextWorker];
+                m_unNextWorker = (m_unNextWorker + 1) % m_vecWorkers.size();
+                cTarget.m_cLoop.Post([&cTarget, spSocket]() { cTarget.Attach(spSocket); });
+            }
+        }
+
+        /******************************************************************************
+         * @brief   全ワーカーの購読索引へ更新を通知
+         * @arg     strPattern (in) 購読パターン
+         * @arg     unId       (in) 購読者 ID
+         * @arg     bInsert    (in) true:登録 false:削除
+         * @return  なし
+         * @note    各ワーカーは自身のループスレッドで索引を更新する
+         *****************************************************************************/
+        void vBroadcastIndexUpdate(const std::string& strPattern, uint64_t unId, bool bInsert) {
+            for (std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                Worker& cWorker = *upWorker;
+                cWorker.m_cLoop.Post([&cWorker, strPattern, unId, bInsert]() {
+                    cWorker.UpdateIndex(strPattern, unId, bInsert);
+                });
+            }
+        }
+
+    private:
+        BrokerConfig                         m_stConfig;
+        bool                                 m_bRunning;
+        Socket                               m_cListener;
+        std::vector<std::unique_ptr<Worker>> m_vecWorkers;
+        std::vector<std::thread>             m_vecThreads;
+        std::size_t                          m_unNextWorker;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPConcurrentSender.h
+ * @brief   SimpleBinaryDictionaryProtocol Concurrent Sender
+ * @author  Satoh
+ * @note    複数スレッドから 1 本のソケットへ送信するための送信器。
+ *          エンコードは呼び出し元スレッドで行い、フレームは MPSC キューへ
+ *          積むだけにする。書き込みは 1 スレッド（フラッシャ）がまとめて
+ *          writev 相当の 1 システムコールで行う
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPMpscQueue.h"
+
+namespace sbdp {
+
+    // フラッシャの選び方
+    enum class SenderMode : uint8_t {
+        Combining = 0,      // キューを空にする役は、フラッシャ権を取れた送信スレッドが担う
+        DedicatedWriter     // 専用の書き込みスレッドが担う
+    };
+
+    // 並行送信器
+    class ConcurrentSender {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     cSocket (in) 送信先ソケット（送信器より長く生存すること）
+         * @arg     eMode   (in) フラッシャの選び方
+         * @return  なし
+         * @note    ソケットへの送信は以後この送信器経由でのみ行うこと
+         *****************************************************************************/
+        explicit ConcurrentSender(Socket& cSocket, SenderMode eMode = SenderMode::Combining)
+            : m_cSocket(cSocket), m_eMode(eMode), m_bFlushing(false),
+              m_bStopping(false), m_bFailed(false), m_unBatches(0) {
+            if (m_eMode == SenderMode::DedicatedWriter) {
+                m_thrWriter = std::thread([this]() { vWriterMain(); });
+            }
+        }
+
+        ~ConcurrentSender() {
+            if (m_thrWriter.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxWriter);
+                    m_bStopping.store(true);
+                }
+                m_cvWriter.notify_one();
+                m_thrWriter.join();
+            }
+        }
+
+        ConcurrentSender(const ConcurrentSender&) = delete;
+        ConcurrentSender& operator=(const ConcurrentSender&) = delete;
+
+        /******************************************************************************
+         * @brief   メッセージ送信
+         * @arg     msgData (in) 送信するメッセージ
+         * @return  送信結果 true:正常 false:異常（以前の書き込みが失敗済み）
+         * @note    任意のスレッドから呼び出し可能。エンコードは呼び出し元で行う
+         *****************************************************************************/
+        bool SendMessage(const Message& msgData) {
+            return SendFrame(SharedFrame::Encode(msgData));
+        }
+
+        /******************************************************************************
+         * @brief   エンコード済みフレーム送信
+         * @arg     cFrame (in) 送信するフレーム
+         * @return  送信結果 true:正常 false:異常（以前の書き込みが失敗済み）
+         * @note    任意のスレッドから呼び出し可能。
+         *          Combining では、フラッシャ権を取れた場合に限り呼び出し元で
+         *          書き込みを行い、書き込みエラーは std::system_error を送出する
+         *****************************************************************************/
+        bool SendFrame(const SharedFrame& cFrame) {
+            if (m_bFailed.load()) {
+                return false;
+            }
+            if (cFrame.IsEmpty()) {
+                return true;
+            }
+            m_cQueue.Push(cFrame);
+            if (m_eMode == SenderMode::DedicatedWriter) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxWriter);
+                }
+                m_cvWriter.notify_one();
+                return true;
+            }
+            vCombine();
+            return !m_bFailed.load();
+        }
+
+        /******************************************************************************
+         * @brief   未送信フレーム数の取得
+         * @arg     なし
+         * @return  キューに残っているフレーム数
+         * @note
+         *****************************************************************************/
+        std::size_t GetPendingFrames() const {
+            return m_cQueue.GetSize();
+        }
+
+        /******************************************************************************
+         * @brief   書き込みシステムコール回数の取得
+         * @arg     なし
+         * @return  まとめ書きを行った回数（フレーム数との比がまとめ効率）
+         * @note
+         *****************************************************************************/
+        uint64_t GetBatchCount() const {
+            return m_unBatches.load();
+        }
+
+        /******************************************************************************
+         * @brief   書き込み失敗の有無
+         * @arg     なし
+         * @return  true:失敗済み（以後のフレームは破棄される）
+         * @note
+         *****************************************************************************/
+        bool IsFailed() const {
+            return m_bFailed.load();
+        }
+
+    private:
+        // フラッシャ権の解放（例外時も必ず解放する）
+        struct FlushGuard {
+            std::atomic_bool& bFlushing;
+            ~FlushGuard() { bFlushing.store(false); }
+        };
+
+        /******************************************************************************
+         * @brief   フラッシャ権を取れたらキューを空にする
+         * @arg     なし
+         * @return  なし
+         * @note    権を解放した直後に積まれたフレームを取り残さないよう、
+         *          解放後にキューを再確認する
+         *****************************************************************************/
+        void vCombine() {
+            do {
+                if (m_bFlushing.exchange(true)) {
+                    return;
+                }
+                FlushGuard stGuard {m_bFlushing};
+                vDrain();
+            } while (m_cQueue.GetSize() > 0 && !m_bFailed.load());
+        }
+
+        /******************************************************************************
+         * @brief   キュー内のフレームをまとめてソケットへ書き込む
+         * @arg     なし
+         * @return  なし
+         * @note    フラッシャ（同時に 1 スレッド）からのみ呼び出す。
+         *          1 回の書き込みは k_unMaxGatherBuffers フレームまで
+         *****************************************************************************/
+        void vDrain() {
+            std::vector<SharedFrame> vecFrames;
+            std::vector<ConstBuffer> vecBuffers;
+            vecFrames.reserve(k_unMaxGatherBuffers);
+            vecBuffers.reserve(k_unMaxGatherBuffers);
+            SharedFrame cFrame;
+            for (;;) {
+                vecFrames.clear();
+                while (vecFrames.size() < k_unMaxGatherBuffers && m_cQueue.Pop(cFrame)) {
+                    vecFrames.push_back(std::move(cFrame));
+                }
+                if (vecFrames.empty()) {
+                    return;
+                }
+                if (m_bFailed.load()) {
+                    continue;   // 失敗後は捨てるだけ
+                }
+                vecBuffers.clear();
+                for (const SharedFrame& cPending : vecFrames) {
+                    vecBuffers.push_back(ConstBuffer{cPending.Data(), cPending.Size()});
+                }
+                try {
+                    m_cSocket.SendBuffers(vecBuffers);
+                    m_unBatches.fetch_add(1);
+                }
+                catch (...) {
+                    m_bFailed.store(true);
+                    if (m_eMode == SenderMode::Combining) {
+                        throw;
+                    }
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   専用書き込みスレッド本体
+         * @arg     なし
+         * @return  なし
+         * @note    停止要求時は残りのフレームを書き込んでから終了する
+         *****************************************************************************/
+        void vWriterMain() {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mtxWriter);
+                    m_cvWriter.wait(lock, [this]() {
+                        return m_bStopping.load() || m_cQueue.GetSize() > 0;
+                    });
+                }
+                vDrain();
+                if (m_bStopping.load() && m_cQueue.GetSize() == 0) {
+                    return;
+                }
+            }
+        }
+
+        Socket&                 m_cSocket;
+        SenderMode              m_eMode;
+        MpscQueue<SharedFrame>  m_cQueue;
+        std::atomic_bool        m_bFlushing;
+        std::atomic_bool        m_bStopping;
+        std::atomic_bool        m_bFailed;
+        std::atomic<uint64_t>   m_unBatches;
+        std::mutex              m_mtxWriter;
+        std::condition_variable m_cvWriter;
+        std::thread             m_thrWriter;
+    };
+
+} // namespace sbdp
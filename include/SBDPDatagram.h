@@ -0,0 +1,651 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPDatagram.h
+ * @brief   SimpleBinaryDictionaryProtocol Datagram Socket
+ * @author  Satoh
+ * @note    UDP 上で 1 データグラム = 1 フレームとして送受信する（到達保証なし）。
+ *          長さヘッダはデータグラム長との一致検証に使う。
+ *          Linux では sendmmsg / recvmmsg で複数データグラムを 1 回のシステムコールで扱う
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#ifdef _WIN32
+#error "SBDPDatagram.h requires POSIX sockets"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <net/if.h>
+#include <poll.h>
+#include "SBDPSocket.h"
+
+namespace sbdp {
+
+    // 1 回のシステムコールで送受信する最大データグラム数
+    constexpr std::size_t k_unMaxDatagramBatch = 64;
+    // UDP で送れる最大ペイロード長（IPv4）
+    constexpr std::size_t k_unMaxDatagramPayload = 65507;
+    // 受信スロット 1 つあたりの既定サイズ（これを超えるデータグラムは切り詰められ破棄する）
+    constexpr std::size_t k_unDefaultDatagramSize = 8 * 1024;
+
+    // データグラム統計
+    struct DatagramStats {
+        uint64_t unSent      = 0;   // 送信したデータグラム数
+        uint64_t unReceived  = 0;   // 受信した正常なデータグラム数
+        uint64_t unRejected  = 0;   // 長さヘッダ不一致・切り詰めで破棄した受信データグラム数
+        uint64_t unDropped   = 0;   // 送信エラー・サイズ超過で送らなかったデータグラム数
+        uint64_t unSendCalls = 0;   // 送信システムコール数
+        uint64_t unRecvCalls = 0;   // 受信システムコール数
+    };
+
+    // データグラムソケット（コピー禁止、ムーブ可能。スレッドセーフではない）
+    class DatagramSocket {
+    public:
+        DatagramSocket()
+            : m_hSocket(INVALID_SOCKET), m_eFamily(AddressFamily::IPv4),
+              m_unSlotSize(k_unDefaultDatagramSize), m_stStats() { }
+        ~DatagramSocket() { Close(); }
+
+        DatagramSocket(const DatagramSocket&) = delete;
+        DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+        DatagramSocket(DatagramSocket&& other) noexcept
+            : m_hSocket(other.m_hSocket), m_eFamily(other.m_eFamily),
+              m_unSlotSize(other.m_unSlotSize), m_stStats(other.m_stStats),
+              m_vecPending(std::move(other.m_vecPending)) {
+            other.m_hSocket = INVALID_SOCKET;
+        }
+        DatagramSocket& operator=(DatagramSocket&& other) noexcept {
+            if (this != &other) {
+                Close();
+                m_hSocket = other.m_hSocket;
+                m_eFamily = other.m_eFamily;
+                m_unSlotSize = other.m_unSlotSize;
+                m_stStats = other.m_stStats;
+                m_vecPending = std::move(other.m_vecPending);
+                other.m_hSocket = INVALID_SOCKET;
+            }
+            return *this;
+        }
+
+        /******************************************************************************
+         * @brief   ソケット作成（SOCK_DGRAM）
+         * @arg     stOptions (in) ソケットオプション（SO_REUSEADDR / SO_REUSEPORT /
+         *                         SO_SNDBUF / SO_RCVBUF のみ適用する）
+         * @arg     eFamily   (in) アドレスファミリー
+         * @return  結果 true:正常 false:異常
+         * @note    マルチキャストを複数プロセスで受信する場合は bReuseAddress を設定する
+         *****************************************************************************/
+        bool Create(const SocketOptions& stOptions = SocketOptions(),
+                    AddressFamily eFamily = AddressFamily::IPv4) {
+            m_hSocket = ::socket((eFamily == AddressFamily::IPv4) ? AF_INET : AF_INET6, SOCK_DGRAM, 0);
+            if (m_hSocket == INVALID_SOCKET) {
+                return false;
+            }
+            m_eFamily = eFamily;
+            if (eFamily != AddressFamily::IPv4 &&
+                !bSetOption(IPPROTO_IPV6, IPV6_V6ONLY, (eFamily == AddressFamily::IPv6) ? 1 : 0)) {
+                Close();
+                return false;
+            }
+            vApplyOption(stOptions.bReuseAddress, SO_REUSEADDR);
+            vApplyOption(stOptions.bReusePort, k_snOptionReusePort);
+            vApplyOption(stOptions.snSendBufferBytes, SO_SNDBUF);
+            vApplyOption(stOptions.snRecvBufferBytes, SO_RCVBUF);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   指定ポートでバインドする（受信用）
+         * @arg     unPort (in) ポート
+         * @return  結果 true:正常 false:異常
+         * @note    全アドレスで受信する（マルチキャスト受信もこちらを使う）
+         *****************************************************************************/
+        bool Bind(unsigned short unPort) {
+            return Bind((m_eFamily == AddressFamily::IPv4) ? "0.0.0.0" : "::", unPort);
+        }
+
+        /******************************************************************************
+         * @brief   指定アドレス・ポートでバインドする（受信用）
+         * @arg     strAddress (in) 数値形式のアドレス
+         * @arg     unPort     (in) ポート
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool Bind(const std::string& strAddress, unsigned short unPort) {
+            addrinfo* pstResult = pstResolve(strAddress, unPort, AI_PASSIVE | AI_NUMERICHOST);
+            if (pstResult == nullptr) {
+                return false;
+            }
+            bool bBound = (::bind(m_hSocket, pstResult->ai_addr, pstResult->ai_addrlen) != SOCKET_ERROR);
+            freeaddrinfo(pstResult);
+            return bBound;
+        }
+
+        /******************************************************************************
+         * @brief   送信先の設定
+         * @arg     strHost (in) 送信先ホスト（マルチキャストグループを含む）
+         * @arg     unPort  (in) 送信先ポート
+         * @return  結果 true:正常 false:異常
+         * @note    UDP の connect は送信先を固定するだけで通信は発生しない。
+         *          以後この送信先以外からのデータグラムは受信しない
+         *****************************************************************************/
+        bool Connect(const std::string& strHost, unsigned short unPort) {
+            addrinfo* pstResult = pstResolve(strHost, unPort, 0);
+            if (pstResult == nullptr) {
+                return false;
+            }
+            bool bConnected = (::connect(m_hSocket, pstResult->ai_addr, pstResult->ai_addrlen) != SOCKET_ERROR);
+            freeaddrinfo(pstResult);
+            return bConnected;
+        }
+
+        /******************************************************************************
+         * @brief   マルチキャストグループへの参加
+         * @arg     strGroup     (in) グループアドレス（"239.1.2.3"、"ff15::1" 等）
+         * @arg     strInterface (in) 受信インターフェース名（空:OS の既定）
+         * @return  結果 true:正常 false:異常
+         * @note    Bind 後に呼び出す
+         *****************************************************************************/
+        bool JoinGroup(const std::string& strGroup, const std::string& strInterface = std::string()) {
+            return bChangeMembership(strGroup, strInterface, true);
+        }
+
+        /******************************************************************************
+         * @brief   マルチキャストグループからの離脱
+         * @arg     strGroup     (in) グループアドレス
+         * @arg     strInterface (in) JoinGroup と同じインターフェース名
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool LeaveGroup(const std::string& strGroup, const std::string& strInterface = std::string()) {
+            return bChangeMembership(strGroup, strInterface, false);
+        }
+
+        /******************************************************************************
+         * @brief   マルチキャスト送信の設定
+         * @arg     unHops       (in) TTL / ホップ数（1:同一セグメント内）
+         * @arg     bLoopback    (in) true:自ホストの受信者にも届ける
+         * @arg     strInterface (in) 送信インターフェース名（空:経路表に従う）
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool SetMulticast(uint8_t unHops, bool bLoopback, const std::string& strInterface = std::string()) {
+            unsigned int unIfIndex = 0;
+            if (!strInterface.empty()) {
+                unIfIndex = ::if_nametoindex(strInterface.c_str());
+                if (unIfIndex == 0) {
+                    return false;
+                }
+            }
+            bool bResult = true;
+            if (m_eFamily != AddressFamily::IPv6) {
+                // DualStack では IPv4 グループ宛て（::ffff:a.b.c.d）の送信に反映する
+                bool bIPv4Result = bSetOption(IPPROTO_IP, IP_MULTICAST_TTL, unHops) &&
+                                   bSetOption(IPPROTO_IP, IP_MULTICAST_LOOP, bLoopback ? 1 : 0);
+            #ifdef __linux__
+                if (unIfIndex != 0) {
+                    ip_mreqn stRequest {};
+                    stRequest.imr_ifindex = static_cast<int>(unIfIndex);
+                    bIPv4Result = bIPv4Result && (::setsockopt(m_hSocket, IPPROTO_IP, IP_MULTICAST_IF,
+                                                               &stRequest, sizeof(stRequest)) == 0);
+                }
+            #endif
+                if (m_eFamily == AddressFamily::IPv4) {
+                    bResult = bIPv4Result;
+                }
+            }
+            if (m_eFamily != AddressFamily::IPv4) {
+                bResult = bSetOption(IPPROTO_IPV6, IPV6_MULTICAST_HOPS, unHops) &&
+                          bSetOption(IPPROTO_IPV6, IPV6_MULTICAST_LOOP, bLoopback ? 1 : 0) &&
+                          (unIfIndex == 0 ||
+                           bSetOption(IPPROTO_IPV6, IPV6_MULTICAST_IF, static_cast<int>(unIfIndex)));
+            }
+            return bResult;
+        }
+
+        /******************************************************************************
+         * @brief   受信スロットサイズの設定
+         * @arg     unSlotSize (in) 1 データグラムの最大受信サイズ（k_unMaxDatagramPayload まで）
+         * @return  なし
+         * @note    受信バッファは k_unMaxDatagramBatch 個のスロットをまとめて確保する
+         *****************************************************************************/
+        void SetMaxDatagramSize(size_t unSlotSize) {
+            m_unSlotSize = std::min(std::max(unSlotSize, k_unHeaderSize), k_unMaxDatagramPayload);
+        }
+
+        /******************************************************************************
+         * @brief   フレームを 1 データグラムとして即時送信
+         * @arg     cFrame (in) 送信するフレーム
+         * @return  結果 true:送信した false:送らなかった（サイズ超過・送信エラー）
+         * @note    送信待ちのフレームがあれば先に送る
+         *****************************************************************************/
+        bool SendFrame(const SharedFrame& cFrame) {
+            uint64_t unDroppedBefore = m_stStats.unDropped;
+            if (!EnqueueFrame(cFrame)) {
+                return false;
+            }
+            Flush();
+            return (m_stStats.unDropped == unDroppedBefore);
+        }
+
+        /******************************************************************************
+         * @brief   メッセージを 1 データグラムとして即時送信
+         * @arg     msgData (in) 送信するメッセージ
+         * @return  結果 true:送信した false:送らなかった
+         * @note
+         *****************************************************************************/
+        bool SendMessage(const Message& msgData) {
+            return SendFrame(SharedFrame::Encode(msgData));
+        }
+
+        /******************************************************************************
+         * @brief   フレームを送信待ちに追加
+         * @arg     cFrame (in) 送信するフレーム
+         * @return  結果 true:追加した false:サイズ超過で破棄した
+         * @note    k_unMaxDatagramBatch 個たまると自動で Flush する。
+         *          送信間隔が空く場合は定期的に Flush を呼ぶこと
+         *****************************************************************************/
+        bool EnqueueFrame(const SharedFrame& cFrame) {
+            if (cFrame.Size() < k_unHeaderSize || cFrame.Size() > k_unMaxDatagramPayload) {
+                ++m_stStats.unDropped;
+                return false;
+            }
+            m_vecPending.push_back(cFrame);
+            if (m_vecPending.size() >= k_unMaxDatagramBatch) {
+                Flush();
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   メッセージを送信待ちに追加
+         * @arg     msgData (in) 送信するメッセージ
+         * @return  結果 true:追加した false:サイズ超過で破棄した
+         * @note
+         *****************************************************************************/
+        bool EnqueueMessage(const Message& msgData) {
+            return EnqueueFrame(SharedFrame::Encode(msgData));
+        }
+
+        /******************************************************************************
+         * @brief   送信待ちのフレームをまとめて送信
+         * @arg     なし
+         * @return  送信したデータグラム数
+         * @note    Connect で設定した送信先へ送る。送信エラー（ICMP による ECONNREFUSED、
+         *          ENOBUFS 等）になったデータグラムは破棄して残りを送る
+         *****************************************************************************/
+        size_t Flush() {
+            size_t unSent = 0;
+            size_t unOffset = 0;
+            while (unOffset < m_vecPending.size()) {
+                size_t unBatch = std::min(m_vecPending.size() - unOffset, k_unMaxDatagramBatch);
+                int snSent = snSendBatch(unOffset, unBatch);
+                ++m_stStats.unSendCalls;
+                if (snSent < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    ++m_stStats.unDropped;      // 先頭のデータグラムでエラー
+                    snSent = 1;
+                }
+                else {
+                    unSent += static_cast<size_t>(snSent);
+                }
+                unOffset += static_cast<size_t>(snSent);
+            }
+            m_stStats.unSent += unSent;
+            m_vecPending.clear();
+            return unSent;
+        }
+
+        /******************************************************************************
+         * @brief   データグラムをまとめて受信
+         * @arg     vecFrames   (out) 受信したフレーム（ヘッダ含む）。呼び出し間で使い回すと
+         *                            要素のメモリを再利用する
+         * @arg     snTimeoutMs (in)  最初の 1 個を待つ時間(ミリ秒) -1:無限 0:待たない
+         * @return  受信したフレーム数（0:タイムアウト）
+         * @note    最初の 1 個が届いたら、その時点で届いている分を最大
+         *          k_unMaxDatagramBatch 個まで 1 回のシステムコールで取り出す。
+         *          長さヘッダがデータグラム長と一致しないものは破棄する。
+         *          受信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        size_t ReceiveBatch(std::vector<std::vector<uint8_t>>& vecFrames, int32_t snTimeoutMs) {
+            size_t unCount = 0;
+            if (bWaitReadable(snTimeoutMs)) {
+                vPrepareReceive();
+                int snReceived = snReceiveBatch();
+                ++m_stStats.unRecvCalls;
+                if (snReceived < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR &&
+                    errno != ECONNREFUSED) {
+                    throw std::system_error(errno, std::system_category(), "recvmmsg");
+                }
+                for (int snIndex = 0; snIndex < snReceived; ++snIndex) {
+                    const uint8_t* pData = m_vecRecvBuffer.data() + static_cast<size_t>(snIndex) * m_unSlotSize;
+                    size_t unLength = m_vecRecvLengths[static_cast<size_t>(snIndex)];
+                    if (!bIsValidFrame(pData, unLength)) {
+                        ++m_stStats.unRejected;
+                        continue;
+                    }
+                    if (vecFrames.size() <= unCount) {
+                        vecFrames.emplace_back();
+                    }
+                    vecFrames[unCount++].assign(pData, pData + unLength);
+                }
+            }
+            vecFrames.resize(unCount);
+            m_stStats.unReceived += unCount;
+            return unCount;
+        }
+
+        /******************************************************************************
+         * @brief   メッセージをまとめて受信
+         * @arg     vecMessages (out) 受信したメッセージ（クリアしてから追加する）
+         * @arg     snTimeoutMs (in)  最初の 1 個を待つ時間(ミリ秒) -1:無限 0:待たない
+         * @return  受信したメッセージ数
+         * @note    デコードできないフレームは破棄して unRejected に数える
+         *****************************************************************************/
+        size_t ReceiveMessages(std::vector<Message>& vecMessages, int32_t snTimeoutMs) {
+            vecMessages.clear();
+            ReceiveBatch(m_vecFrames, snTimeoutMs);
+            for (const std::vector<uint8_t>& vecFrame : m_vecFrames) {
+                try {
+                    vecMessages.push_back(DecodeMessage(vecFrame));
+                }
+                catch (const std::exception&) {
+                    ++m_stStats.unRejected;
+                    --m_stStats.unReceived;
+                }
+            }
+            return vecMessages.size();
+        }
+
+        /******************************************************************************
+         * @brief   送信待ちのフレーム数の取得
+         * @arg     なし
+         * @return  フレーム数
+         * @note
+         *****************************************************************************/
+        size_t GetPendingFrames() const {
+            return m_vecPending.size();
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        const DatagramStats& GetStats() const {
+            return m_stStats;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットハンドルの取得
+         * @arg     なし
+         * @return  ソケットハンドル
+         * @note    イベントループ・セレクターへの登録等に使用する
+         *****************************************************************************/
+        SOCKET GetHandle() const {
+            return m_hSocket;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットのクローズ
+         * @arg     なし
+         * @return  なし
+         * @note    送信待ちのフレームは破棄する
+         *****************************************************************************/
+        void Close() {
+            if (m_hSocket != INVALID_SOCKET) {
+                ::close(m_hSocket);
+                m_hSocket = INVALID_SOCKET;
+            }
+            m_vecPending.clear();
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   名前解決
+         * @arg     strHost  (in) ホスト・アドレス
+         * @arg     unPort   (in) ポート
+         * @arg     snFlags  (in) addrinfo のフラグ
+         * @return  解決結果（freeaddrinfo で解放する。nullptr:失敗）
+         * @note    DualStack は IPv4 アドレスを ::ffff:a.b.c.d として解決する
+         *****************************************************************************/
+        addrinfo* pstResolve(const std::string& strHost, unsigned short unPort, int snFlags) const {
+            addrinfo stHints {};
+            stHints.ai_socktype = SOCK_DGRAM;
+            stHints.ai_flags = snFlags;
+            if (m_eFamily == AddressFamily::IPv4) {
+                stHints.ai_family = AF_INET;
+            }
+            else {
+                stHints.ai_family = AF_INET6;
+                if (m_eFamily == AddressFamily::DualStack) {
+                    stHints.ai_flags |= AI_V4MAPPED | AI_ALL;
+                }
+            }
+            addrinfo* pstResult = nullptr;
+            std::string strPort = std::to_string(unPort);
+            if (getaddrinfo(strHost.c_str(), strPort.c_str(), &stHints, &pstResult) != 0) {
+                return nullptr;
+            }
+            return pstResult;
+        }
+
+        /******************************************************************************
+         * @brief   グループ参加・離脱
+         * @arg     strGroup     (in) グループアドレス
+         * @arg     strInterface (in) インターフェース名（空:OS の既定）
+         * @arg     bJoin        (in) true:参加 false:離脱
+         * @return  結果 true:正常 false:異常
+         * @note    IPv4 グループは DualStack のソケットでも IP レベルで参加する
+         *****************************************************************************/
+        bool bChangeMembership(const std::string& strGroup, const std::string& strInterface, bool bJoin) {
+            unsigned int unIfIndex = 0;
+            if (!strInterface.empty()) {
+                unIfIndex = ::if_nametoindex(strInterface.c_str());
+                if (unIfIndex == 0) {
+                    return false;
+                }
+            }
+            in_addr stGroup4 {};
+            if (::inet_pton(AF_INET, strGroup.c_str(), &stGroup4) == 1) {
+                if (m_eFamily == AddressFamily::IPv6) {
+                    return false;
+                }
+            #ifdef __linux__
+                ip_mreqn stRequest {};
+                stRequest.imr_multiaddr = stGroup4;
+                stRequest.imr_ifindex = static_cast<int>(unIfIndex);
+            #else
+                if (unIfIndex != 0) {
+                    return false;
+                }
+                ip_mreq stRequest {};
+                stRequest.imr_multiaddr = stGroup4;
+                stRequest.imr_interface.s_addr = htonl(INADDR_ANY);
+            #endif
+                return (::setsockopt(m_hSocket, IPPROTO_IP, bJoin ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP,
+                                     &stRequest, sizeof(stRequest)) == 0);
+            }
+            in6_addr stGroup6 {};
+            if (m_eFamily == AddressFamily::IPv4 || ::inet_pton(AF_INET6, strGroup.c_str(), &stGroup6) != 1) {
+                return false;
+            }
+            ipv6_mreq stRequest {};
+            stRequest.ipv6mr_multiaddr = stGroup6;
+            stRequest.ipv6mr_interface = unIfIndex;
+            return (::setsockopt(m_hSocket, IPPROTO_IPV6, bJoin ? IPV6_JOIN_GROUP : IPV6_LEAVE_GROUP,
+                                 &stRequest, sizeof(stRequest)) == 0);
+        }
+
+        /******************************************************************************
+         * @brief   int 値のソケットオプション設定
+         * @arg     snLevel (in) レベル
+         * @arg     snName  (in) オプション名
+         * @arg     snValue (in) 値
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool bSetOption(int snLevel, int snName, int snValue) {
+            return (::setsockopt(m_hSocket, snLevel, snName, &snValue, sizeof(snValue)) == 0);
+        }
+
+        /******************************************************************************
+         * @brief   SOL_SOCKET オプション 1 項目の適用
+         * @arg     oValue (in) 値（未設定なら何もしない）
+         * @arg     snName (in) オプション名（-1:未対応）
+         * @return  なし
+         * @note    適用できない項目は無視する
+         *****************************************************************************/
+        template<class T_>
+        void vApplyOption(const std::optional<T_>& oValue, int snName) {
+            if (oValue.has_value() && snName >= 0) {
+                bSetOption(SOL_SOCKET, snName, static_cast<int>(*oValue));
+            }
+        }
+
+        /******************************************************************************
+         * @brief   受信可能になるまで待機
+         * @arg     snTimeoutMs (in) 待ち時間(ミリ秒) -1:無限 0:待たない
+         * @return  結果 true:受信可能 false:タイムアウト・シグナル割り込み
+         * @note    待機エラー時は std::system_error を送出する
+         *****************************************************************************/
+        bool bWaitReadable(int32_t snTimeoutMs) {
+            pollfd stPoll {};
+            stPoll.fd = m_hSocket;
+            stPoll.events = POLLIN;
+            int snReady = ::poll(&stPoll, 1, snTimeoutMs);
+            if (snReady < 0 && errno != EINTR) {
+                throw std::system_error(errno, std::system_category(), "poll");
+            }
+            return (snReady > 0);
+        }
+
+        /******************************************************************************
+         * @brief   フレームの長さヘッダとデータグラム長の一致判定
+         * @arg     pData    (in) データグラム
+         * @arg     unLength (in) データグラム長
+         * @return  結果 true:正常 false:不一致
+         * @note
+         *****************************************************************************/
+        static bool bIsValidFrame(const uint8_t* pData, size_t unLength) {
+            if (unLength < k_unHeaderSize) {
+                return false;
+            }
+            uint32_t unNetPayloadLen = 0;
+            std::memcpy(&unNetPayloadLen, pData, k_unHeaderSize);
+            return (k_unHeaderSize + ntohl(unNetPayloadLen) == unLength);
+        }
+
+        /******************************************************************************
+         * @brief   受信スロットの準備
+         * @arg     なし
+         * @return  なし
+         * @note    スロットサイズが変わった場合のみ確保し直す
+         *****************************************************************************/
+        void vPrepareReceive() {
+            m_vecRecvBuffer.resize(k_unMaxDatagramBatch * m_unSlotSize);
+            m_vecRecvLengths.resize(k_unMaxDatagramBatch);
+        }
+
+        /******************************************************************************
+         * @brief   送信待ちフレームの一部を送信
+         * @arg     unOffset (in) 送信待ちの先頭からの位置
+         * @arg     unCount  (in) 送信するフレーム数（k_unMaxDatagramBatch 以下）
+         * @return  送信したデータグラム数（-1:先頭のデータグラムでエラー）
+         * @note    Linux では sendmmsg、それ以外は sendmsg を繰り返す
+         *****************************************************************************/
+        int snSendBatch(size_t unOffset, size_t unCount) {
+            iovec stIov[k_unMaxDatagramBatch];
+        #ifdef __linux__
+            mmsghdr stMessages[k_unMaxDatagramBatch];
+            std::memset(stMessages, 0, sizeof(mmsghdr) * unCount);
+            for (size_t unIndex = 0; unIndex < unCount; ++unIndex) {
+                const SharedFrame& cFrame = m_vecPending[unOffset + unIndex];
+                stIov[unIndex].iov_base = const_cast<uint8_t*>(cFrame.Data());
+                stIov[unIndex].iov_len = cFrame.Size();
+                stMessages[unIndex].msg_hdr.msg_iov = &stIov[unIndex];
+                stMessages[unIndex].msg_hdr.msg_iovlen = 1;
+            }
+            return ::sendmmsg(m_hSocket, stMessages, static_cast<unsigned int>(unCount), k_snSendNoSignal);
+        #else
+            int snSent = 0;
+            for (size_t unIndex = 0; unIndex < unCount; ++unIndex) {
+                const SharedFrame& cFrame = m_vecPending[unOffset + unIndex];
+                stIov[0].iov_base = const_cast<uint8_t*>(cFrame.Data());
+                stIov[0].iov_len = cFrame.Size();
+                msghdr stMessage {};
+                stMessage.msg_iov = stIov;
+                stMessage.msg_iovlen = 1;
+                if (::sendmsg(m_hSocket, &stMessage, k_snSendNoSignal) < 0) {
+                    return (snSent == 0) ? -1 : snSent;
+                }
+                ++snSent;
+            }
+            return snSent;
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   届いているデータグラムを受信スロットへ取り出す
+         * @arg     なし
+         * @return  取り出したデータグラム数（-1:エラー）
+         * @note    切り詰められたデータグラムは長さ 0 として返す（検証で破棄される）
+         *****************************************************************************/
+        int snReceiveBatch() {
+            iovec stIov[k_unMaxDatagramBatch];
+        #ifdef __linux__
+            mmsghdr stMessages[k_unMaxDatagramBatch];
+            std::memset(stMessages, 0, sizeof(stMessages));
+            for (size_t unIndex = 0; unIndex < k_unMaxDatagramBatch; ++unIndex) {
+                stIov[unIndex].iov_base = m_vecRecvBuffer.data() + unIndex * m_unSlotSize;
+                stIov[unIndex].iov_len = m_unSlotSize;
+                stMessages[unIndex].msg_hdr.msg_iov = &stIov[unIndex];
+                stMessages[unIndex].msg_hdr.msg_iovlen = 1;
+            }
+            int snReceived = ::recvmmsg(m_hSocket, stMessages, static_cast<unsigned int>(k_unMaxDatagramBatch),
+                                        MSG_DONTWAIT, nullptr);
+            for (int snIndex = 0; snIndex < snReceived; ++snIndex) {
+                bool bTruncated = (stMessages[snIndex].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+                m_vecRecvLengths[static_cast<size_t>(snIndex)] = bTruncated ? 0 : stMessages[snIndex].msg_len;
+            }
+            return snReceived;
+        #else
+            int snReceived = 0;
+            for (size_t unIndex = 0; unIndex < k_unMaxDatagramBatch; ++unIndex) {
+                stIov[0].iov_base = m_vecRecvBuffer.data() + unIndex * m_unSlotSize;
+                stIov[0].iov_len = m_unSlotSize;
+                msghdr stMessage {};
+                stMessage.msg_iov = stIov;
+                stMessage.msg_iovlen = 1;
+                ssize_t snLength = ::recvmsg(m_hSocket, &stMessage, MSG_DONTWAIT);
+                if (snLength < 0) {
+                    return (snReceived == 0) ? -1 : snReceived;
+                }
+                bool bTruncated = (stMessage.msg_flags & MSG_TRUNC) != 0;
+                m_vecRecvLengths[unIndex] = bTruncated ? 0 : static_cast<size_t>(snLength);
+                ++snReceived;
+            }
+            return snReceived;
+        #endif
+        }
+
+        SOCKET                            m_hSocket;
+        AddressFamily                     m_eFamily;
+        size_t                            m_unSlotSize;         // 受信スロット 1 つのサイズ
+        DatagramStats                     m_stStats;
+        std::vector<SharedFrame>          m_vecPending;         // 送信待ちのフレーム
+        std::vector<uint8_t>              m_vecRecvBuffer;      // 受信スロット（k_unMaxDatagramBatch 個）
+        std::vector<size_t>               m_vecRecvLengths;     // スロットごとの受信長（0:破棄）
+        std::vector<std::vector<uint8_t>> m_vecFrames;          // ReceiveMessages の作業領域
+    };
+
+} // namespace sbdp
@@ -21,13 +21,15 @@ inline constexpr bool k_bHostIsLittleEndian = true;
 #error "Cannot determine host byte order."
 #endif
 
+// 関数名を括弧で囲み、最適化ビルドで <netinet/in.h> が定義する
+// htons 等の関数形式マクロに展開されないようにする
 /******************************************************************************
  * @brief   16bit値をホストバイトオーダーからネットワークバイトオーダーへ変換
  * @arg     x (in) 変換する16bit値
  * @return  ネットワークバイトオーダーに変換された16bit値
  * @note    
  *****************************************************************************/
-inline uint16_t htons(uint16_t x) {
+inline uint16_t (htons)(uint16_t x) {
     if constexpr (!k_bHostIsLittleEndian) {
         return x;
     }
@@ -40,7 +42,7 @@ inline uint16_t htons(uint16_t x) {
  * @return  ホストバイトオーダーに変換された16bit値
  * @note    
  *****************************************************************************/
-inline uint16_t ntohs(uint16_t x) {
+inline uint16_t (ntohs)(uint16_t x) {
     return htons(x);
 }
 
@@ -50,7 +52,7 @@ inline uint16_t ntohs(uint16_t x) {
  * @return  ネットワークバイトオーダーに変換された32bit値
  * @note    
  *****************************************************************************/
-inline uint32_t htonl(uint32_t x) {
+inline uint32_t (htonl)(uint32_t x) {
     if constexpr (!k_bHostIsLittleEndian) {
         return x;
     }
@@ -66,7 +68,7 @@ inline uint32_t htonl(uint32_t x) {
  * @return  ホストバイトオーダーに変換された32bit値
  * @note    
  *****************************************************************************/
-inline uint32_t ntohl(uint32_t x) {
+inline uint32_t (ntohl)(uint32_t x) {
     return htonl(x);
 }
 
@@ -76,7 +78,7 @@ inline uint32_t ntohl(uint32_t x) {
  * @return  ネットワークバイトオーダーに変換された64bit値
  * @note    
  *****************************************************************************/
-inline uint64_t htonll(uint64_t x) {
+inline uint64_t (htonll)(uint64_t x) {
     if constexpr (!k_bHostIsLittleEndian) {
         return x;
     }
@@ -96,7 +98,7 @@ inline uint64_t htonll(uint64_t x) {
  * @return  ホストバイトオーダーに変換された64bit値
  * @note    
  *****************************************************************************/
-inline uint64_t ntohll(uint64_t x) {
+inline uint64_t (ntohll)(uint64_t x) {
     return htonll(x);
 }
 
@@ -0,0 +1,373 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPEventLoop.h
+ * @brief   SimpleBinaryDictionaryProtocol Event Loop
+ * @author  Satoh
+ * @note    epoll によるシングルスレッドのイベントループ（Linux 専用）
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#ifndef __linux__
+#error "SBDPEventLoop.h requires Linux (epoll)"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "SBDPSocket.h"
+#include "SBDPTimerWheel.h"
+
+namespace sbdp {
+
+    // 監視イベント
+    constexpr uint32_t k_unEventRead  = EPOLLIN;
+    constexpr uint32_t k_unEventWrite = EPOLLOUT;
+    constexpr uint32_t k_unEventError = EPOLLERR | EPOLLHUP;
+    // 1 回の epoll_wait で取得するイベント数の上限
+    constexpr std::size_t k_unMaxEventsPerWait = 256;
+
+    // イベントループ（ハンドラ登録・イベント待ちはループスレッドからのみ行うこと）
+    class EventLoop {
+    public:
+        using EventHandler = std::function<void(uint32_t unEvents)>;
+        using Task = std::function<void()>;
+
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     なし
+         * @return  なし
+         * @note    epoll / eventfd の生成に失敗した場合は std::system_error を送出する
+         *****************************************************************************/
+        EventLoop()
+            : m_hEpoll(::epoll_create1(EPOLL_CLOEXEC)),
+              m_hWakeup(-1),
+              m_unNextToken(1),
+              m_bStop(false),
+              m_idLoopThread(),
+              m_tpEpoch(std::chrono::steady_clock::now()),
+              m_cTimers(1, 0) {
+            if (m_hEpoll < 0) {
+                throw std::system_error(errno, std::system_category(), "epoll_create1");
+            }
+            m_hWakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_hWakeup < 0) {
+                int snError = errno;
+                ::close(m_hEpoll);
+                throw std::system_error(snError, std::system_category(), "eventfd");
+            }
+            Add(m_hWakeup, k_unEventRead, [this](uint32_t) { vRunPostedTasks(); });
+        }
+
+        ~EventLoop() {
+            ::close(m_hWakeup);
+            ::close(m_hEpoll);
+        }
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+        EventLoop(EventLoop&&) = delete;
+        EventLoop& operator=(EventLoop&&) = delete;
+
+        /******************************************************************************
+         * @brief   ハンドルの監視登録
+         * @arg     hHandle    (in) 監視するハンドル
+         * @arg     unEvents   (in) 監視イベント（k_unEventRead 等の論理和）
+         * @arg     fnHandler  (in) イベント発生時のハンドラ
+         * @return  なし
+         * @note    失敗時は std::system_error を送出する
+         *****************************************************************************/
+        void Add(SOCKET hHandle, uint32_t unEvents, EventHandler fnHandler) {
+            uint32_t unToken = m_unNextToken++;
+            epoll_event stEvent {};
+            stEvent.events = unEvents;
+            stEvent.data.u64 = unMakeKey(hHandle, unToken);
+            if (::epoll_ctl(m_hEpoll, EPOLL_CTL_ADD, hHandle, &stEvent) != 0) {
+                throw std::system_error(errno, std::system_category(), "epoll_ctl(ADD)");
+            }
+            m_mapHandlers[hHandle] = Registration{
+                unToken, std::make_shared<EventHandler>(std::move(fnHandler))};
+        }
+
+        /******************************************************************************
+         * @brief   監視イベントの変更
+         * @arg     hHandle  (in) 登録済みハンドル
+         * @arg     unEvents (in) 監視イベント
+         * @return  なし
+         * @note    失敗時は std::system_error を送出する
+         *****************************************************************************/
+        void Modify(SOCKET hHandle, uint32_t unEvents) {
+            auto itEntry = m_mapHandlers.find(hHandle);
+            if (itEntry == m_mapHandlers.end()) {
+                throw std::invalid_argument("EventLoop::Modify: handle not registered");
+            }
+            epoll_event stEvent {};
+            stEvent.events = unEvents;
+            stEvent.data.u64 = unMakeKey(hHandle, itEntry->second.unToken);
+            if (::epoll_ctl(m_hEpoll, EPOLL_CTL_MOD, hHandle, &stEvent) != 0) {
+                throw std::system_error(errno, std::system_category(), "epoll_ctl(MOD)");
+            }
+        }
+
+        /******************************************************************************
+         * @brief   ハンドルの監視解除
+         * @arg     hHandle (in) 登録済みハンドル
+         * @return  なし
+         * @note    ハンドラ実行中に自身を解除してもよい。ソケットのクローズ前に呼ぶこと
+         *****************************************************************************/
+        void Remove(SOCKET hHandle) {
+            if (m_mapHandlers.erase(hHandle) == 0) {
+                return;
+            }
+            ::epoll_ctl(m_hEpoll, EPOLL_CTL_DEL, hHandle, nullptr);
+        }
+
+        /******************************************************************************
+         * @brief   ループスレッドで実行するタスクの投入
+         * @arg     fnTask (in) 実行するタスク
+         * @return  なし
+         * @note    任意のスレッドから呼び出し可能
+         *****************************************************************************/
+        void Post(Task fnTask) {
+            {
+                std::unique_lock<std::mutex> lock(m_mtxPosted);
+                m_vecPosted.push_back(std::move(fnTask));
+            }
+            vWakeup();
+        }
+
+        /******************************************************************************
+         * @brief   各イテレーション終了時に呼び出すコールバックの登録
+         * @arg     fnTask (in) 実行するコールバック
+         * @return  なし
+         * @note    イテレーション中に溜めた送信のまとめ出し等に使用する
+         *****************************************************************************/
+        void AddIterationCallback(Task fnTask) {
+            m_vecIterationCallbacks.push_back(std::move(fnTask));
+        }
+
+        /******************************************************************************
+         * @brief   ループ反復の終了時に送信フラッシュを行うソケットを登録
+         * @arg     cSocket (in) バッファリング送信中のソケット
+         * @return  なし
+         * @note    ループスレッドから呼び出すこと。登録は 1 反復限りで、
+         *          ソケットはその反復の終了まで生存していること。
+         *          ハンドラ内の送信をまとめて 1 回のシステムコールで送るために使う。
+         *          フラッシュ時の送信エラーはソケットをシャットダウンして通知する
+         *****************************************************************************/
+        void ScheduleFlush(Socket& cSocket) {
+            m_vecFlushSockets.push_back(&cSocket);
+        }
+
+        /******************************************************************************
+         * @brief   タイマーの設定
+         * @arg     stNode    (in) タイマーノード（fnCallback を設定済みであること）
+         * @arg     unDelayMs (in) 満了までのミリ秒
+         * @return  なし
+         * @note    ループスレッドから呼び出すこと。設定中なら再設定する。
+         *          メモリ確保なしの O(1)。ノードの所有者は破棄前に CancelTimer を呼ぶこと
+         *****************************************************************************/
+        void ArmTimer(TimerNode& stNode, uint64_t unDelayMs) {
+            m_cTimers.Arm(stNode, unDelayMs, unNowMs());
+        }
+
+        /******************************************************************************
+         * @brief   タイマーの取り消し
+         * @arg     stNode (in) タイマーノード
+         * @return  なし
+         * @note    ループスレッドから呼び出すこと。未設定なら何もしない
+         *****************************************************************************/
+        void CancelTimer(TimerNode& stNode) {
+            m_cTimers.Cancel(stNode);
+        }
+
+        /******************************************************************************
+         * @brief   イベントを 1 回待ってハンドラを実行
+         * @arg     snTimeoutMs (in) 待ち時間(ミリ秒) -1:無限
+         * @return  なし
+         * @note    設定中のタイマーがあれば待ち時間を次の満了までに短縮し、
+         *          イベント処理の後に満了したタイマーの処理を呼び出す。
+         *          epoll_wait の失敗時は std::system_error を送出する
+         *****************************************************************************/
+        void RunOnce(int32_t snTimeoutMs) {
+            int64_t snTimerMs = m_cTimers.GetNextTimeoutMs(unNowMs());
+            if (snTimerMs >= 0 && (snTimeoutMs < 0 || snTimerMs < snTimeoutMs)) {
+                snTimeoutMs = static_cast<int32_t>(std::min<int64_t>(snTimerMs, INT32_MAX));
+            }
+            epoll_event stEvents[k_unMaxEventsPerWait];
+            int snCount = ::epoll_wait(m_hEpoll, stEvents,
+                                       static_cast<int>(k_unMaxEventsPerWait), snTimeoutMs);
+            if (snCount < 0) {
+                if (errno == EINTR) {
+                    return;
+                }
+                throw std::system_error(errno, std::system_category(), "epoll_wait");
+            }
+            for (int snIndex = 0; snIndex < snCount; ++snIndex) {
+                vDispatch(stEvents[snIndex]);
+            }
+            m_cTimers.Advance(unNowMs());
+            vFlushScheduledSockets();
+            for (Task& fnCallback : m_vecIterationCallbacks) {
+                fnCallback();
+            }
+        }
+
+        /******************************************************************************
+         * @brief   Stop が呼ばれるまでイベントループを実行
+         * @arg     なし
+         * @return  なし
+         * @note    呼び出したスレッドがループスレッドとなる
+         *****************************************************************************/
+        void Run() {
+            m_idLoopThread = std::this_thread::get_id();
+            while (!m_bStop.load()) {
+                RunOnce(-1);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   イベントループの停止要求
+         * @arg     なし
+         * @return  なし
+         * @note    任意のスレッドから呼び出し可能
+         *****************************************************************************/
+        void Stop() {
+            m_bStop.store(true);
+            vWakeup();
+        }
+
+        /******************************************************************************
+         * @brief   呼び出し元がループスレッドか判定
+         * @arg     なし
+         * @return  結果 true:ループスレッド false:他スレッド
+         * @note
+         *****************************************************************************/
+        bool IsInLoopThread() const {
+            return m_idLoopThread == std::this_thread::get_id();
+        }
+
+    private:
+        struct Registration {
+            uint32_t                      unToken;
+            std::shared_ptr<EventHandler> spHandler;
+        };
+
+        /******************************************************************************
+         * @brief   epoll に登録するキーの生成
+         * @arg     hHandle (in) ハンドル
+         * @arg     unToken (in) 登録ごとの通し番号
+         * @return  キー
+         * @note    解除後に同じ fd が再利用された場合の誤配送を防ぐ
+         *****************************************************************************/
+        static uint64_t unMakeKey(SOCKET hHandle, uint32_t unToken) {
+            return (static_cast<uint64_t>(unToken) << 32) |
+                   static_cast<uint32_t>(hHandle);
+        }
+
+        /******************************************************************************
+         * @brief   1 イベントのハンドラ呼び出し
+         * @arg     stEvent (in) 発生したイベント
+         * @return  なし
+         * @note    ハンドラ内での解除に備えて参照を保持してから呼び出す
+         *****************************************************************************/
+        void vDispatch(const epoll_event& stEvent) {
+            SOCKET hHandle = static_cast<SOCKET>(stEvent.data.u64 & 0xFFFFFFFFULL);
+            uint32_t unToken = static_cast<uint32_t>(stEvent.data.u64 >> 32);
+            auto itEntry = m_mapHandlers.find(hHandle);
+            if (itEntry == m_mapHandlers.end() || itEntry->second.unToken != unToken) {
+                return;
+            }
+            std::shared_ptr<EventHandler> spHandler = itEntry->second.spHandler;
+            (*spHandler)(stEvent.events);
+        }
+
+        /******************************************************************************
+         * @brief   登録されたソケットの送信フラッシュ
+         * @arg     なし
+         * @return  なし
+         * @note    ノンブロッキングソケットで残ったデータは送信キューに保持される
+         *****************************************************************************/
+        void vFlushScheduledSockets() {
+            std::vector<Socket*> vecSockets;
+            vecSockets.swap(m_vecFlushSockets);
+            for (Socket* pRawSocket : vecSockets) {
+                try {
+                    pRawSocket->Flush();
+                }
+                catch (const std::system_error&) {
+                    pRawSocket->Shutdown();
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   ループ生成からの経過ミリ秒
+         * @arg     なし
+         * @return  ミリ秒
+         * @note
+         *****************************************************************************/
+        uint64_t unNowMs() const {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - m_tpEpoch).count());
+        }
+
+        /******************************************************************************
+         * @brief   ループスレッドの起床
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vWakeup() {
+            uint64_t unOne = 1;
+            ssize_t snWritten = ::write(m_hWakeup, &unOne, sizeof(unOne));
+            (void)snWritten;
+        }
+
+        /******************************************************************************
+         * @brief   投入されたタスクの実行
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vRunPostedTasks() {
+            uint64_t unValue = 0;
+            ssize_t snRead = ::read(m_hWakeup, &unValue, sizeof(unValue));
+            (void)snRead;
+            std::vector<Task> vecTasks;
+            {
+                std::unique_lock<std::mutex> lock(m_mtxPosted);
+                vecTasks.swap(m_vecPosted);
+            }
+            for (Task& fnTask : vecTasks) {
+                fnTask();
+            }
+        }
+
+    private:
+        int                                      m_hEpoll;
+        int                                      m_hWakeup;
+        uint32_t                                 m_unNextToken;
+        std::atomic_bool                         m_bStop;
+        std::thread::id                          m_idLoopThread;
+        std::unordered_map<SOCKET, Registration> m_mapHandlers;
+        std::mutex                               m_mtxPosted;
+        std::vector<Task>                        m_vecPosted;
+        std::vector<Task>                        m_vecIterationCallbacks;
+        std::vector<Socket*>                     m_vecFlushSockets;
+        std::chrono::steady_clock::time_point    m_tpEpoch;
+        TimerWheel                               m_cTimers;
+    };
+
+} // namespace sbdp
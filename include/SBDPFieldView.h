@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPFieldView.h
+ * @brief   SimpleBinaryDictionaryProtocol Lazy Field Lookup
+ * @author  Satoh
+ * @note    フレーム全体をデコードせずに単一キーの値を参照する
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "SBDP.h"
+
+namespace sbdp {
+
+    // エンコード済みフレーム内の値への非所有参照
+    struct FieldView {
+        ValueType      eType;
+        const uint8_t* pData;     // 値本体の先頭（文字列・バイナリは長さ部の直後）
+        std::size_t    unSize;    // 値本体のバイト数
+
+        /******************************************************************************
+         * @brief   文字列・バイナリ値を文字列ビューとして取得
+         * @arg     なし
+         * @return  値本体の文字列ビュー
+         * @note    数値型の場合はネットワークバイトオーダーの生バイト列を返す
+         *****************************************************************************/
+        std::string_view AsStringView() const {
+            return std::string_view(reinterpret_cast<const char*>(pData), unSize);
+        }
+
+        /******************************************************************************
+         * @brief   uint64 値の取得
+         * @arg     なし
+         * @return  ホストバイトオーダーの値
+         * @note    型が TYPE_UINT64 以外の場合は std::runtime_error を送出する
+         *****************************************************************************/
+        uint64_t AsUInt64() const {
+            if (eType != TYPE_UINT64) {
+                throw std::runtime_error("Field is not uint64");
+            }
+            return unReadNet64();
+        }
+
+        /******************************************************************************
+         * @brief   int64 値の取得
+         * @arg     なし
+         * @return  ホストバイトオーダーの値
+         * @note    型が TYPE_INT64 以外の場合は std::runtime_error を送出する
+         *****************************************************************************/
+        int64_t AsInt64() const {
+            if (eType != TYPE_INT64) {
+                throw std::runtime_error("Field is not int64");
+            }
+            return static_cast<int64_t>(unReadNet64());
+        }
+
+    private:
+        uint64_t unReadNet64() const {
+            uint64_t unNetValue = 0;
+            std::memcpy(&unNetValue, pData, sizeof(unNetValue));
+            return ntohll(unNetValue);
+        }
+    };
+
+    /******************************************************************************
+     * @brief   エンコード済みフレームから指定キーの値を検索
+     * @arg     pFrame      (in)  フレーム先頭（ヘッダ含む）
+     * @arg     unFrameSize (in)  フレーム長
+     * @arg     svKey       (in)  検索するキー
+     * @arg     stView      (out) 見つかった値への参照
+     * @return  結果 true:見つかった false:キーなし
+     * @note    値はコピーせずフレーム内を指す。フレームの破損を検出した場合は
+     *          std::runtime_error を送出する
+     *****************************************************************************/
+    inline bool FindField(const uint8_t* pFrame, std::size_t unFrameSize,
+                          std::string_view svKey, FieldView& stView) {
+        if (unFrameSize < k_unHeaderSize) {
+            throw std::runtime_error("Message too short");
+        }
+        uint32_t unNetPayloadLen = 0;
+        std::memcpy(&unNetPayloadLen, pFrame, k_unHeaderSize);
+        std::size_t unEnd = k_unHeaderSize + ntohl(unNetPayloadLen);
+        if (unEnd != unFrameSize) {
+            throw std::runtime_error("Frame length mismatch");
+        }
+
+        std::size_t unOffset = k_unHeaderSize;
+        while (unOffset < unEnd) {
+            if (unOffset + k_unKeyLengthSize + 1 > unEnd) {
+                throw std::runtime_error("Key length read error");
+            }
+            uint16_t unNetKeyLen = 0;
+            std::memcpy(&unNetKeyLen, pFrame + unOffset, k_unKeyLengthSize);
+            unOffset += k_unKeyLengthSize;
+            std::size_t unKeyLen = ntohs(unNetKeyLen);
+            if (unOffset + unKeyLen + 1 > unEnd) {
+                throw std::runtime_error("Key string region insufficient");
+            }
+            std::string_view svCurrent(
+                reinterpret_cast<const char*>(pFrame + unOffset), unKeyLen);
+            unOffset += unKeyLen;
+
+            uint8_t unTypeCode = pFrame[unOffset++];
+            std::size_t unValueSize = 0;
+            if (unTypeCode == TYPE_INT64 || unTypeCode == TYPE_UINT64 ||
+                unTypeCode == TYPE_FLOAT64) {
+                unValueSize = k_unInt64ValueSize;
+            }
+            else if (unTypeCode == TYPE_STRING || unTypeCode == TYPE_BINARY) {
+                if (unOffset + k_unStringLengthSize > unEnd) {
+                    throw std::runtime_error("Length read error");
+                }
+                uint32_t unNetLen = 0;
+                std::memcpy(&unNetLen, pFrame + unOffset, k_unStringLengthSize);
+                unOffset += k_unStringLengthSize;
+                unValueSize = ntohl(unNetLen);
+            }
+            else {
+                throw std::runtime_error("Unknown type code");
+            }
+            if (unOffset + unValueSize > unEnd) {
+                throw std::runtime_error("Value data insufficient");
+            }
+            if (svCurrent == svKey) {
+                stView.eType = static_cast<ValueType>(unTypeCode);
+                stView.pData = pFrame + unOffset;
+                stView.unSize = unValueSize;
+                return true;
+            }
+            unOffset += unValueSize;
+        }
+        return false;
+    }
+
+    /******************************************************************************
+     * @brief   エンコード済みフレームから指定キーの値を検索
+     * @arg     vecFrame (in)  フレーム（ヘッダ含む）
+     * @arg     svKey    (in)  検索するキー
+     * @arg     stView   (out) 見つかった値への参照
+     * @return  結果 true:見つかった false:キーなし
+     * @note
+     *****************************************************************************/
+    inline bool FindField(const std::vector<uint8_t>& vecFrame,
+                          std::string_view svKey, FieldView& stView) {
+        return FindField(vecFrame.data(), vecFrame.size(), svKey, stView);
+    }
+
+} // namespace sbdp
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPFrameReader.h
+ * @brief   SimpleBinaryDictionaryProtocol Frame Reader
+ * @author  Satoh
+ * @note    ノンブロッキング受信したバイト列からフレーム単位で切り出す
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "SBDP.h"
+
+namespace sbdp {
+
+    // 受信バッファ（フレーム境界の検出のみ行い、デコードはしない）
+    class FrameReader {
+    public:
+        FrameReader() : m_unReadOffset(0), m_unPrepared(0), m_unMaxFrameSize(0) { }
+
+        /******************************************************************************
+         * @brief   書き込み領域の確保
+         * @arg     unLength (in) 書き込む最大バイト数
+         * @return  書き込み先の先頭
+         * @note    書き込み後に CommitWrite で確定すること
+         *****************************************************************************/
+        uint8_t* PrepareWrite(std::size_t unLength) {
+            vCompact();
+            std::size_t unOldSize = m_vecBuffer.size();
+            m_vecBuffer.resize(unOldSize + unLength);
+            m_unPrepared = unOldSize;
+            return m_vecBuffer.data() + unOldSize;
+        }
+
+        /******************************************************************************
+         * @brief   書き込んだバイト数の確定
+         * @arg     unLength (in) 実際に書き込んだバイト数
+         * @return  なし
+         * @note    PrepareWrite で確保した残りの領域は破棄する
+         *****************************************************************************/
+        void CommitWrite(std::size_t unLength) {
+            m_vecBuffer.resize(m_unPrepared + unLength);
+            vValidateHeader();
+        }
+
+        /******************************************************************************
+         * @brief   完全なフレームが溜まっているか判定
+         * @arg     なし
+         * @return  結果 true:取り出し可能 false:不足
+         * @note
+         *****************************************************************************/
+        bool HasFrame() const {
+            std::size_t unAvailable = GetBufferedBytes();
+            if (unAvailable < k_unHeaderSize) {
+                return false;
+            }
+            return unAvailable >= unPeekFrameSize();
+        }
+
+        /******************************************************************************
+         * @brief   現在のフレームを完成させるのに必要な残りバイト数
+         * @arg     なし
+         * @return  残りバイト数（ヘッダ未受信時はヘッダの残り）
+         * @note    完全なフレームがある場合は 0
+         *****************************************************************************/
+        std::size_t GetMissingBytes() const {
+            std::size_t unAvailable = GetBufferedBytes();
+            if (unAvailable < k_unHeaderSize) {
+                return k_unHeaderSize - unAvailable;
+            }
+            std::size_t unFrameSize = unPeekFrameSize();
+            return (unAvailable >= unFrameSize) ? 0 : unFrameSize - unAvailable;
+        }
+
+        /******************************************************************************
+         * @brief   先頭のフレームを取り出す
+         * @arg     vecFrame (out) 取り出したフレーム（ヘッダ含む）
+         * @return  結果 true:取り出した false:完全なフレームなし
+         * @note
+         *****************************************************************************/
+        bool PopFrame(std::vector<uint8_t>& vecFrame) {
+            if (!HasFrame()) {
+                return false;
+            }
+            std::size_t unFrameSize = unPeekFrameSize();
+            const uint8_t* pBegin = m_vecBuffer.data() + m_unReadOffset;
+            vecFrame.assign(pBegin, pBegin + unFrameSize);
+            m_unReadOffset += unFrameSize;
+            vValidateHeader();
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   バッファ済みバイト数の取得
+         * @arg     なし
+         * @return  未処理のバイト数
+         * @note
+         *****************************************************************************/
+        std::size_t GetBufferedBytes() const {
+            return m_vecBuffer.size() - m_unReadOffset;
+        }
+
+        /******************************************************************************
+         * @brief   最大フレーム長の設定
+         * @arg     unMaxFrameSize (in) 最大フレーム長（0:無制限）
+         * @return  なし
+         * @note    超過するヘッダを受信した場合は std::runtime_error を送出する
+         *****************************************************************************/
+        void SetMaxFrameSize(std::size_t unMaxFrameSize) {
+            m_unMaxFrameSize = unMaxFrameSize;
+        }
+
+        /******************************************************************************
+         * @brief   バッファの破棄
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Clear() {
+            m_vecBuffer.clear();
+            m_unReadOffset = 0;
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   先頭フレームの全長（ヘッダ含む）を取得
+         * @arg     なし
+         * @return  フレーム長
+         * @note    ヘッダ受信済みであること
+         *****************************************************************************/
+        std::size_t unPeekFrameSize() const {
+            uint32_t unNetPayloadLen = 0;
+            std::memcpy(&unNetPayloadLen, m_vecBuffer.data() + m_unReadOffset,
+                        k_unHeaderSize);
+            return k_unHeaderSize + ntohl(unNetPayloadLen);
+        }
+
+        /******************************************************************************
+         * @brief   先頭フレームのヘッダが最大フレーム長以内か検査
+         * @arg     なし
+         * @return  なし
+         * @note    超過時は std::runtime_error を送出する
+         *****************************************************************************/
+        void vValidateHeader() const {
+            if (m_unMaxFrameSize == 0 || GetBufferedBytes() < k_unHeaderSize) {
+                return;
+            }
+            if (unPeekFrameSize() > m_unMaxFrameSize) {
+                throw std::runtime_error("Frame too large");
+            }
+        }
+
+        /******************************************************************************
+         * @brief   処理済み領域をバッファ先頭から詰める
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vCompact() {
+            if (m_unReadOffset == 0) {
+                return;
+            }
+            m_vecBuffer.erase(m_vecBuffer.begin(),
+                              m_vecBuffer.begin() + static_cast<std::ptrdiff_t>(m_unReadOffset));
+            m_unReadOffset = 0;
+        }
+
+    private:
+        std::vector<uint8_t> m_vecBuffer;
+        std::size_t          m_unReadOffset;
+        std::size_t          m_unPrepared;
+        std::size_t          m_unMaxFrameSize;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPHash.h
+ * @brief   SimpleBinaryDictionaryProtocol Byte Hash
+ * @author  Satoh
+ * @note    エンコード済みバイト列用の高速 64bit ハッシュ（MurmurHash64A）
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "SBDPEndian.h"
+
+namespace sbdp {
+
+    constexpr uint64_t k_unHashMultiplier = 0xc6a4a7935bd1e995ULL;
+    constexpr uint32_t k_unHashShift      = 47;
+    constexpr uint64_t k_unHashDefaultSeed = 0x5344425048415348ULL;
+
+    /******************************************************************************
+     * @brief   リトルエンディアンの 64bit 値を読み込む
+     * @arg     pData (in) 先頭（アライメント不要）
+     * @return  ホストバイトオーダーの値
+     * @note
+     *****************************************************************************/
+    inline uint64_t LoadLittleEndian64(const uint8_t* pData) {
+        uint64_t unValue = 0;
+        if constexpr (k_bHostIsLittleEndian) {
+            std::memcpy(&unValue, pData, sizeof(unValue));
+            return unValue;
+        }
+        for (std::size_t unIndex = 0; unIndex < sizeof(unValue); ++unIndex) {
+            unValue |= static_cast<uint64_t>(pData[unIndex]) << (8 * unIndex);
+        }
+        return unValue;
+    }
+
+    /******************************************************************************
+     * @brief   バイト列の 64bit ハッシュ値を計算
+     * @arg     pData    (in) 先頭
+     * @arg     unLength (in) バイト数
+     * @arg     unSeed   (in) シード
+     * @return  ハッシュ値
+     * @note    リトルエンディアンとして読み込むため、ホストによらず同じ値になる
+     *          （複数ホストで一貫したハッシュ振り分けを行うため）
+     *****************************************************************************/
+    inline uint64_t HashBytes(const uint8_t* pData, std::size_t unLength,
+                              uint64_t unSeed = k_unHashDefaultSeed) {
+        uint64_t unHash = unSeed ^ (static_cast<uint64_t>(unLength) * k_unHashMultiplier);
+        std::size_t unBlocks = unLength / sizeof(uint64_t);
+        for (std::size_t unIndex = 0; unIndex < unBlocks; ++unIndex) {
+            uint64_t unBlock = LoadLittleEndian64(pData + unIndex * sizeof(uint64_t));
+            unBlock *= k_unHashMultiplier;
+            unBlock ^= unBlock >> k_unHashShift;
+            unBlock *= k_unHashMultiplier;
+            unHash ^= unBlock;
+            unHash *= k_unHashMultiplier;
+        }
+        const uint8_t* pTail = pData + unBlocks * sizeof(uint64_t);
+        std::size_t unTail = unLength & (sizeof(uint64_t) - 1);
+        if (unTail > 0) {
+            uint64_t unBlock = 0;
+            for (std::size_t unIndex = 0; unIndex < unTail; ++unIndex) {
+                unBlock |= static_cast<uint64_t>(pTail[unIndex]) << (8 * unIndex);
+            }
+            unHash ^= unBlock;
+            unHash *= k_unHashMultiplier;
+        }
+        unHash ^= unHash >> k_unHashShift;
+        unHash *= k_unHashMultiplier;
+        unHash ^= unHash >> k_unHashShift;
+        return unHash;
+    }
+
+    /******************************************************************************
+     * @brief   文字列ビューの 64bit ハッシュ値を計算
+     * @arg     svData (in) 対象
+     * @arg     unSeed (in) シード
+     * @return  ハッシュ値
+     * @note
+     *****************************************************************************/
+    inline uint64_t HashBytes(std::string_view svData, uint64_t unSeed = k_unHashDefaultSeed) {
+        return HashBytes(reinterpret_cast<const uint8_t*>(svData.data()), svData.size(), unSeed);
+    }
+
+} // namespace sbdp
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPMpscQueue.h
+ * @brief   SimpleBinaryDictionaryProtocol Lock-free MPSC Queue
+ * @author  Satoh
+ * @note    複数プロデューサ・単一コンシューマのロックフリーキュー
+ *          （Vyukov 方式の連結リスト）
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace sbdp {
+
+    // MPSC キュー（Push は任意のスレッド、Pop は同時に 1 スレッドのみ）
+    template<class T_>
+    class MpscQueue {
+    public:
+        MpscQueue() : m_pRawHead(nullptr), m_pRawTail(new Node()), m_unSize(0) {
+            m_pRawHead.store(m_pRawTail);
+        }
+
+        ~MpscQueue() {
+            T_ tValue;
+            while (Pop(tValue)) {
+            }
+            delete m_pRawTail;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /******************************************************************************
+         * @brief   末尾へ追加
+         * @arg     tValue (in) 追加する値
+         * @return  なし
+         * @note    任意のスレッドから呼び出し可能（待機なし）
+         *****************************************************************************/
+        void Push(T_ tValue) {
+            Node* pRawNode = new Node();
+            pRawNode->tValue = std::move(tValue);
+            m_unSize.fetch_add(1);
+            Node* pRawPrev = m_pRawHead.exchange(pRawNode, std::memory_order_acq_rel);
+            pRawPrev->pRawNext.store(pRawNode, std::memory_order_release);
+        }
+
+        /******************************************************************************
+         * @brief   先頭から取り出し
+         * @arg     tValue (out) 取り出した値
+         * @return  結果 true:取り出した false:空（または追加途中）
+         * @note    同時に呼び出せるのは 1 スレッドのみ
+         *****************************************************************************/
+        bool Pop(T_& tValue) {
+            Node* pRawTail = m_pRawTail;
+            Node* pRawNext = pRawTail->pRawNext.load(std::memory_order_acquire);
+            if (pRawNext == nullptr) {
+                return false;
+            }
+            tValue = std::move(pRawNext->tValue);
+            pRawNext->tValue = T_();
+            m_pRawTail = pRawNext;
+            delete pRawTail;
+            m_unSize.fetch_sub(1);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   要素数の取得
+         * @arg     なし
+         * @return  要素数（追加途中で Pop できない要素を含む）
+         * @note    任意のスレッドから呼び出し可能
+         *****************************************************************************/
+        std::size_t GetSize() const {
+            return m_unSize.load();
+        }
+
+    private:
+        struct Node {
+            std::atomic<Node*> pRawNext {nullptr};
+            T_                 tValue {};
+        };
+
+        std::atomic<Node*>       m_pRawHead;
+        Node*                    m_pRawTail;
+        std::atomic<std::size_t> m_unSize;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,556 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPRelay.h
+ * @brief   SimpleBinaryDictionaryProtocol Decode-free Relay
+ * @author  Satoh
+ * @note    フレームヘッダのみを読み、ペイロードは splice(2) でソケット間を
+ *          直接転送する中継（Linux 専用）。splice が使えない場合は
+ *          ユーザー空間バッファでのコピー転送に切り替える
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "SBDPSocket.h"
+#include "SBDPEventLoop.h"
+
+namespace sbdp {
+
+    // 中継設定
+    struct RelayConfig {
+        std::size_t unWindowBytes  = 1024 * 1024;        // 片方向あたりの転送中バイト上限
+        std::size_t unMaxFrameSize = 64 * 1024 * 1024;   // 0:無制限
+        bool        bUseSplice     = true;
+    };
+
+    // 中継統計
+    struct RelayStats {
+        uint64_t unFrames      = 0;     // 転送を開始したフレーム数
+        uint64_t unSplicedBytes = 0;    // splice で転送したバイト数
+        uint64_t unCopiedBytes  = 0;    // バッファコピーで転送したバイト数
+        uint64_t unSessions    = 0;     // 現在の中継セッション数
+    };
+
+    // 片方向の中継（送信元ソケット → 送信先ソケット）
+    class RelayDirection {
+    public:
+        RelayDirection(Socket& cSource, Socket& cDestination, const RelayConfig& stConfig)
+            : m_cSource(cSource), m_cDestination(cDestination), m_stConfig(stConfig),
+              m_hPipeRead(-1), m_hPipeWrite(-1), m_unWindow(stConfig.unWindowBytes),
+              m_unHeaderReceived(0), m_unPayloadRemain(0), m_bInPayload(false),
+              m_unInFlight(0), m_unBufferBegin(0), m_unBufferEnd(0),
+              m_unFrames(0), m_unSplicedBytes(0), m_unCopiedBytes(0),
+              m_bSourceEof(false), m_bFinished(false) {
+            if (m_unWindow < k_unHeaderSize) {
+                throw std::invalid_argument("RelayConfig: window too small");
+            }
+            if (!m_stConfig.bUseSplice || !bOpenPipe()) {
+                m_vecBuffer.resize(m_unWindow);
+            }
+        }
+
+        ~RelayDirection() { vClosePipe(); }
+
+        RelayDirection(const RelayDirection&) = delete;
+        RelayDirection& operator=(const RelayDirection&) = delete;
+
+        /******************************************************************************
+         * @brief   送信元からの読み込みと送信先への書き出しを可能な限り進める
+         * @arg     なし
+         * @return  なし
+         * @note    送信元がフレーム境界で切断した場合は、転送中データを
+         *          送り切ってから送信先の送信方向をシャットダウンする。
+         *          ソケットエラーは std::system_error、不正フレームは
+         *          std::runtime_error を送出する
+         *****************************************************************************/
+        void Pump() {
+            bool bProgress = true;
+            while (bProgress) {
+                bProgress = (m_unInFlight > 0 && unDrain() > 0);
+                if (WantsRead()) {
+                    int64_t snFilled = snFill();
+                    if (snFilled == 0) {
+                        m_bSourceEof = true;
+                    }
+                    bProgress = bProgress || (snFilled > 0);
+                }
+            }
+            if (m_bSourceEof && m_unInFlight == 0 && !m_bFinished) {
+                ::shutdown(m_cDestination.GetHandle(), SHUT_WR);
+                m_bFinished = true;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   この方向の中継が完了したか判定
+         * @arg     なし
+         * @return  結果 true:送信元切断かつ転送完了 false:中継中
+         * @note
+         *****************************************************************************/
+        bool IsFinished() const {
+            return m_bFinished;
+        }
+
+        /******************************************************************************
+         * @brief   送信元の読み込み監視が必要か判定
+         * @arg     なし
+         * @return  結果 true:必要 false:転送ウィンドウが満杯
+         * @note    フロー制御：送信先が詰まっている間は送信元を読まない。
+         *          ヘッダ待ちの場合はヘッダ 1 つ分の空きを要求する
+         *****************************************************************************/
+        bool WantsRead() const {
+            if (m_bSourceEof) {
+                return false;
+            }
+            std::size_t unNeed = m_bInPayload ? 1 : k_unHeaderSize;
+            if (!bSpliceMode()) {
+                return m_unBufferEnd + unNeed <= m_vecBuffer.size();
+            }
+            return m_unInFlight + unNeed <= m_unWindow;
+        }
+
+        /******************************************************************************
+         * @brief   送信先の書き込み監視が必要か判定
+         * @arg     なし
+         * @return  結果 true:未送信データあり false:なし
+         * @note
+         *****************************************************************************/
+        bool WantsWrite() const {
+            return m_unInFlight > 0;
+        }
+
+        /******************************************************************************
+         * @brief   統計値の加算
+         * @arg     stStats (out) 加算先
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void AccumulateStats(RelayStats& stStats) const {
+            stStats.unFrames += m_unFrames;
+            stStats.unSplicedBytes += m_unSplicedBytes;
+            stStats.unCopiedBytes += m_unCopiedBytes;
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   転送用パイプの作成
+         * @arg     なし
+         * @return  結果 true:正常 false:作成失敗（コピー転送を使用）
+         * @note    パイプ容量を転送ウィンドウに合わせる
+         *****************************************************************************/
+        bool bOpenPipe() {
+            int snPipe[2] = {-1, -1};
+            if (::pipe2(snPipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+                return false;
+            }
+            m_hPipeRead = snPipe[0];
+            m_hPipeWrite = snPipe[1];
+            ::fcntl(m_hPipeWrite, F_SETPIPE_SZ, static_cast<int>(m_unWindow));
+            int snActual = ::fcntl(m_hPipeWrite, F_GETPIPE_SZ);
+            if (snActual > 0) {
+                m_unWindow = static_cast<std::size_t>(snActual);
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   転送用パイプのクローズ
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vClosePipe() {
+            if (m_hPipeRead >= 0) {
+                ::close(m_hPipeRead);
+                ::close(m_hPipeWrite);
+                m_hPipeRead = -1;
+                m_hPipeWrite = -1;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   splice による転送中か判定
+         * @arg     なし
+         * @return  結果 true:splice false:バッファコピー
+         * @note
+         *****************************************************************************/
+        bool bSpliceMode() const {
+            return m_hPipeRead >= 0;
+        }
+
+        /******************************************************************************
+         * @brief   送信元からヘッダまたはペイロードを読み込む
+         * @arg     なし
+         * @return  読み込んだバイト数（0:切断 -1:データなし）
+         * @note
+         *****************************************************************************/
+        int64_t snFill() {
+            if (!m_bInPayload) {
+                return snFillHeader();
+            }
+            std::size_t unSpace = bSpliceMode() ? (m_unWindow - m_unInFlight)
+                                                : (m_vecBuffer.size() - m_unBufferEnd);
+            std::size_t unLength = std::min(m_unPayloadRemain, unSpace);
+            int64_t snRead = bSpliceMode() ? snSpliceIn(unLength) : snCopyIn(unLength);
+            if (snRead == 0) {
+                throw std::runtime_error("Relay: source closed inside a frame");
+            }
+            if (snRead > 0) {
+                m_unPayloadRemain -= static_cast<std::size_t>(snRead);
+                m_bInPayload = (m_unPayloadRemain > 0);
+            }
+            return snRead;
+        }
+
+        /******************************************************************************
+         * @brief   フレームヘッダの読み込みと転送キューへの投入
+         * @arg     なし
+         * @return  読み込んだバイト数（0:フレーム境界で切断 -1:データなし）
+         * @note    ヘッダ 4 バイトのみユーザー空間で扱う
+         *****************************************************************************/
+        int64_t snFillHeader() {
+            ssize_t snRead = ::recv(m_cSource.GetHandle(), m_unHeader + m_unHeaderReceived,
+                                    k_unHeaderSize - m_unHeaderReceived, MSG_DONTWAIT);
+            if (snRead == 0) {
+                if (m_unHeaderReceived > 0) {
+                    throw std::runtime_error("Relay: source closed inside a header");
+                }
+                return 0;
+            }
+            if (snRead < 0) {
+                return snCheckAgain("recv");
+            }
+            m_unHeaderReceived += static_cast<std::size_t>(snRead);
+            if (m_unHeaderReceived < k_unHeaderSize) {
+                return snRead;
+            }
+            uint32_t unNetPayloadLen = 0;
+            std::memcpy(&unNetPayloadLen, m_unHeader, k_unHeaderSize);
+            m_unPayloadRemain = ntohl(unNetPayloadLen);
+            if (m_stConfig.unMaxFrameSize != 0 &&
+                k_unHeaderSize + m_unPayloadRemain > m_stConfig.unMaxFrameSize) {
+                throw std::runtime_error("Frame too large");
+            }
+            vQueueHeader();
+            m_unHeaderReceived = 0;
+            m_bInPayload = (m_unPayloadRemain > 0);
+            ++m_unFrames;
+            return snRead;
+        }
+
+        /******************************************************************************
+         * @brief   受信したヘッダを転送キュー（パイプまたはバッファ）へ積む
+         * @arg     なし
+         * @return  なし
+         * @note    ウィンドウにヘッダ分の空きがあることは呼び出し前に保証済み
+         *****************************************************************************/
+        void vQueueHeader() {
+            if (bSpliceMode()) {
+                if (::write(m_hPipeWrite, m_unHeader, k_unHeaderSize) !=
+                    static_cast<ssize_t>(k_unHeaderSize)) {
+                    throw std::system_error(errno, std::system_category(), "write(pipe)");
+                }
+            }
+            else {
+                std::memcpy(m_vecBuffer.data() + m_unBufferEnd, m_unHeader, k_unHeaderSize);
+                m_unBufferEnd += k_unHeaderSize;
+            }
+            m_unInFlight += k_unHeaderSize;
+        }
+
+        /******************************************************************************
+         * @brief   送信元ソケットからパイプへ splice
+         * @arg     unLength (in) 最大バイト数
+         * @return  転送バイト数（0:切断 -1:データなし）
+         * @note    splice 非対応の場合はバッファコピーへ切り替える
+         *****************************************************************************/
+        int64_t snSpliceIn(std::size_t unLength) {
+            ssize_t snMoved = ::splice(m_cSource.GetHandle(), nullptr, m_hPipeWrite, nullptr,
+                                       unLength, SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+            if (snMoved >= 0) {
+                m_unInFlight += static_cast<std::size_t>(snMoved);
+                return snMoved;
+            }
+            if (errno == EINVAL || errno == ENOSYS) {
+                vSwitchToCopy();
+                return snCopyIn(std::min(unLength, m_vecBuffer.size() - m_unBufferEnd));
+            }
+            return snCheckAgain("splice");
+        }
+
+        /******************************************************************************
+         * @brief   送信元ソケットからバッファへコピー受信
+         * @arg     unLength (in) 最大バイト数
+         * @return  受信バイト数（0:切断 -1:データなし）
+         * @note
+         *****************************************************************************/
+        int64_t snCopyIn(std::size_t unLength) {
+            ssize_t snRead = ::recv(m_cSource.GetHandle(), m_vecBuffer.data() + m_unBufferEnd,
+                                    unLength, MSG_DONTWAIT);
+            if (snRead < 0) {
+                return snCheckAgain("recv");
+            }
+            m_unBufferEnd += static_cast<std::size_t>(snRead);
+            m_unInFlight += static_cast<std::size_t>(snRead);
+            return snRead;
+        }
+
+        /******************************************************************************
+         * @brief   転送中データを送信先へ書き出す
+         * @arg     なし
+         * @return  書き出したバイト数
+         * @note
+         *****************************************************************************/
+        std::size_t unDrain() {
+            if (bSpliceMode()) {
+                unsigned int unFlags = SPLICE_F_NONBLOCK | SPLICE_F_MOVE;
+                if (m_bInPayload) {
+                    unFlags |= SPLICE_F_MORE;
+                }
+                ssize_t snMoved = ::splice(m_hPipeRead, nullptr, m_cDestination.GetHandle(),
+                                           nullptr, m_unInFlight, unFlags);
+                if (snMoved < 0) {
+                    snCheckAgain("splice");
+                    return 0;
+                }
+                m_unInFlight -= static_cast<std::size_t>(snMoved);
+                m_unSplicedBytes += static_cast<uint64_t>(snMoved);
+                return static_cast<std::size_t>(snMoved);
+            }
+            ssize_t snSent = ::send(m_cDestination.GetHandle(),
+                                    m_vecBuffer.data() + m_unBufferBegin,
+                                    m_unBufferEnd - m_unBufferBegin,
+                                    MSG_DONTWAIT | k_snSendNoSignal);
+            if (snSent < 0) {
+                snCheckAgain("send");
+                return 0;
+            }
+            m_unBufferBegin += static_cast<std::size_t>(snSent);
+            m_unInFlight -= static_cast<std::size_t>(snSent);
+            m_unCopiedBytes += static_cast<uint64_t>(snSent);
+            if (m_unBufferBegin == m_unBufferEnd) {
+                m_unBufferBegin = 0;
+                m_unBufferEnd = 0;
+            }
+            return static_cast<std::size_t>(snSent);
+        }
+
+        /******************************************************************************
+         * @brief   splice からバッファコピーへの切り替え
+         * @arg     なし
+         * @return  なし
+         * @note    パイプに残っているデータはバッファへ移してから閉じる
+         *****************************************************************************/
+        void vSwitchToCopy() {
+            m_vecBuffer.resize(m_unWindow);
+            m_unBufferBegin = 0;
+            m_unBufferEnd = 0;
+            while (m_unBufferEnd < m_unInFlight) {
+                ssize_t snRead = ::read(m_hPipeRead, m_vecBuffer.data() + m_unBufferEnd,
+                                        m_unInFlight - m_unBufferEnd);
+                if (snRead <= 0) {
+                    throw std::system_error(errno, std::system_category(), "read(pipe)");
+                }
+                m_unBufferEnd += static_cast<std::size_t>(snRead);
+            }
+            vClosePipe();
+        }
+
+        /******************************************************************************
+         * @brief   EAGAIN/EINTR 以外のエラーを例外として送出
+         * @arg     pszApiName (in) API 名
+         * @return  -1（データなし）
+         * @note
+         *****************************************************************************/
+        static int64_t snCheckAgain(const char* pszApiName) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return -1;
+            }
+            throw std::system_error(errno, std::system_category(), pszApiName);
+        }
+
+    private:
+        Socket&              m_cSource;
+        Socket&              m_cDestination;
+        RelayConfig          m_stConfig;
+        int                  m_hPipeRead;
+        int                  m_hPipeWrite;
+        std::size_t          m_unWindow;
+        uint8_t              m_unHeader[k_unHeaderSize] = {};
+        std::size_t          m_unHeaderReceived;
+        std::size_t          m_unPayloadRemain;
+        bool                 m_bInPayload;
+        std::size_t          m_unInFlight;
+        std::vector<uint8_t> m_vecBuffer;
+        std::size_t          m_unBufferBegin;
+        std::size_t          m_unBufferEnd;
+        uint64_t             m_unFrames;
+        uint64_t             m_unSplicedBytes;
+        uint64_t             m_unCopiedBytes;
+        bool                 m_bSourceEof;
+        bool                 m_bFinished;
+    };
+
+    // 双方向中継（イベントループ上で複数の接続ペアを扱う）
+    class Relay {
+    public:
+        using CloseHandler = std::function<void(uint64_t unSessionId)>;
+
+        Relay(EventLoop& cLoop, const RelayConfig& stConfig)
+            : m_cLoop(cLoop), m_stConfig(stConfig), m_unNextId(1) { }
+
+        Relay(const Relay&) = delete;
+        Relay& operator=(const Relay&) = delete;
+
+        /******************************************************************************
+         * @brief   接続ペアの中継開始
+         * @arg     cFirst  (in) 一方の接続済みソケット
+         * @arg     cSecond (in) もう一方の接続済みソケット
+         * @return  中継セッション ID
+         * @note    ループスレッドで呼び出すこと。ソケットはノンブロッキングに設定される
+         *****************************************************************************/
+        uint64_t AddPair(Socket&& cFirst, Socket&& cSecond) {
+            uint64_t unId = m_unNextId++;
+            std::unique_ptr<Session> upSession =
+                std::make_unique<Session>(std::move(cFirst), std::move(cSecond), m_stConfig);
+            upSession->cFirst.SetNonBlocking(true);
+            upSession->cSecond.SetNonBlocking(true);
+            SOCKET hFirst = upSession->cFirst.GetHandle();
+            SOCKET hSecond = upSession->cSecond.GetHandle();
+            m_mapSessions.emplace(unId, std::move(upSession));
+            m_cLoop.Add(hFirst, k_unEventRead, [this, unId](uint32_t) { vOnEvent(unId); });
+            m_cLoop.Add(hSecond, k_unEventRead, [this, unId](uint32_t) { vOnEvent(unId); });
+            return unId;
+        }
+
+        /******************************************************************************
+         * @brief   中継セッション終了時のハンドラ設定
+         * @arg     fnHandler (in) ハンドラ
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void SetCloseHandler(CloseHandler fnHandler) {
+            m_fnOnClose = std::move(fnHandler);
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  現在のセッションの合計
+         * @note    ループスレッドで呼び出すこと
+         *****************************************************************************/
+        RelayStats GetStats() const {
+            RelayStats stStats;
+            for (const auto& [unId, upSession] : m_mapSessions) {
+                upSession->cForward.AccumulateStats(stStats);
+                upSession->cBackward.AccumulateStats(stStats);
+            }
+            stStats.unSessions = m_mapSessions.size();
+            return stStats;
+        }
+
+    private:
+        struct Session {
+            Session(Socket&& cFirstSocket, Socket&& cSecondSocket, const RelayConfig& stConfig)
+                : cFirst(std::move(cFirstSocket)), cSecond(std::move(cSecondSocket)),
+                  cForward(cFirst, cSecond, stConfig), cBackward(cSecond, cFirst, stConfig),
+                  unFirstEvents(k_unEventRead), unSecondEvents(k_unEventRead) { }
+
+            Socket         cFirst;
+            Socket         cSecond;
+            RelayDirection cForward;
+            RelayDirection cBackward;
+            uint32_t       unFirstEvents;
+            uint32_t       unSecondEvents;
+        };
+
+        /******************************************************************************
+         * @brief   セッションのイベント処理
+         * @arg     unId (in) セッション ID
+         * @return  なし
+         * @note    両方向を進めてから監視イベントを更新する
+         *****************************************************************************/
+        void vOnEvent(uint64_t unId) {
+            auto itSession = m_mapSessions.find(unId);
+            if (itSession == m_mapSessions.end()) {
+                return;
+            }
+            Session& stSession = *itSession->second;
+            bool bAlive = false;
+            try {
+                stSession.cForward.Pump();
+                stSession.cBackward.Pump();
+                bAlive = !(stSession.cForward.IsFinished() && stSession.cBackward.IsFinished());
+            }
+            catch (const std::exception&) {
+                bAlive = false;
+            }
+            if (!bAlive) {
+                vCloseSession(unId);
+                return;
+            }
+            vUpdateInterest(stSession.cFirst, stSession.unFirstEvents,
+                            stSession.cForward, stSession.cBackward);
+            vUpdateInterest(stSession.cSecond, stSession.unSecondEvents,
+                            stSession.cBackward, stSession.cForward);
+        }
+
+        /******************************************************************************
+         * @brief   ソケットの監視イベントをフロー制御状態に合わせて更新
+         * @arg     cSocket   (in)     対象ソケット
+         * @arg     unCurrent (in/out) 現在の監視イベント
+         * @arg     cReadDir  (in)     このソケットを送信元とする方向
+         * @arg     cWriteDir (in)     このソケットを送信先とする方向
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vUpdateInterest(Socket& cSocket, uint32_t& unCurrent,
+                             const RelayDirection& cReadDir, const RelayDirection& cWriteDir) {
+            uint32_t unEvents = (cReadDir.WantsRead() ? k_unEventRead : 0) |
+                                (cWriteDir.WantsWrite() ? k_unEventWrite : 0);
+            if (unEvents != unCurrent) {
+                unCurrent = unEvents;
+                m_cLoop.Modify(cSocket.GetHandle(), unEvents);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   セッションのクローズ
+         * @arg     unId (in) セッション ID
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vCloseSession(uint64_t unId) {
+            auto itSession = m_mapSessions.find(unId);
+            if (itSession == m_mapSessions.end()) {
+                return;
+            }
+            m_cLoop.Remove(itSession->second->cFirst.GetHandle());
+            m_cLoop.Remove(itSession->second->cSecond.GetHandle());
+            m_mapSessions.erase(itSession);
+            if (m_fnOnClose) {
+                m_fnOnClose(unId);
+            }
+        }
+
+    private:
+        EventLoop&                                             m_cLoop;
+        RelayConfig                                            m_stConfig;
+        uint64_t                                               m_unNextId;
+        std::unordered_map<uint64_t, std::unique_ptr<Session>> m_mapSessions;
+        CloseHandler                                           m_fnOnClose;
+    };
+
+} // namespace sbdp
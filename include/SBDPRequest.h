@@ -0,0 +1,650 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPRequest.h
+ * @brief   SimpleBinaryDictionaryProtocol Request Layer
+ * @author  Satoh
+ * @note    要求 ID（"$rid"）による要求・応答の対応付けと、遅い応答に備えて
+ *          別の接続へ同じ要求を重ねて送るヘッジング（Linux 専用、Selector を使用）。
+ *          応答側は要求の "$rid" をそのまま応答へ入れて返すこと
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPSelector.h"
+#include "SBDPFieldView.h"
+
+namespace sbdp {
+
+    // 要求 ID のキー（uint64）
+    constexpr const char* k_pszRequestIdKey = "$rid";
+    // 取り消し要求のキー（uint64、"$rid" と組で送る）
+    constexpr const char* k_pszCancelKey = "$cancel";
+
+    /******************************************************************************
+     * @brief   フレームから要求 ID を取得
+     * @arg     vecFrame     (in)  フレーム（ヘッダ含む）
+     * @arg     unRequestId  (out) 要求 ID
+     * @return  結果 true:取得した false:要求 ID がない
+     * @note    デコードせずに 1 キーだけ参照する
+     *****************************************************************************/
+    inline bool GetRequestId(const std::vector<uint8_t>& vecFrame, uint64_t& unRequestId) {
+        FieldView stField;
+        if (!FindField(vecFrame, k_pszRequestIdKey, stField) || stField.eType != TYPE_UINT64) {
+            return false;
+        }
+        unRequestId = stField.AsUInt64();
+        return true;
+    }
+
+    /******************************************************************************
+     * @brief   取り消し要求か判定
+     * @arg     vecFrame (in) フレーム（ヘッダ含む）
+     * @return  結果 true:取り消し要求 false:それ以外
+     * @note    応答側は "$rid" の処理を中止してよい（応答は不要）
+     *****************************************************************************/
+    inline bool IsCancelRequest(const std::vector<uint8_t>& vecFrame) {
+        FieldView stField;
+        return FindField(vecFrame, k_pszCancelKey, stField);
+    }
+
+    // 遅延ヒストグラム（マイクロ秒、対数線形バケット：各 2 の冪を 8 分割、誤差 12.5% 以内）
+    class LatencyHistogram {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     unWindow (in) 件数がこれに達するたびに全体を半減する（0:半減しない）
+         * @return  なし
+         * @note    半減により直近の傾向を追従する
+         *****************************************************************************/
+        explicit LatencyHistogram(uint64_t unWindow = 4096)
+            : m_arrBuckets(), m_unCount(0), m_unWindow(unWindow) { }
+
+        /******************************************************************************
+         * @brief   1 件の記録
+         * @arg     unMicros (in) 遅延（マイクロ秒）
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Record(uint64_t unMicros) {
+            ++m_arrBuckets[unBucketIndex(unMicros)];
+            ++m_unCount;
+            if (m_unWindow != 0 && m_unCount >= m_unWindow) {
+                m_unCount = 0;
+                for (uint64_t& unBucket : m_arrBuckets) {
+                    unBucket /= 2;
+                    m_unCount += unBucket;
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   パーセンタイル値の取得
+         * @arg     dbPercentile (in) 0.0～1.0（例：0.95）
+         * @return  該当バケットの上限値（マイクロ秒） 記録がない場合は 0
+         * @note
+         *****************************************************************************/
+        uint64_t GetPercentile(float64_t dbPercentile) const {
+            if (m_unCount == 0) {
+                return 0;
+            }
+            dbPercentile = std::min(std::max(dbPercentile, 0.0), 1.0);
+            uint64_t unRank = static_cast<uint64_t>(dbPercentile * static_cast<float64_t>(m_unCount - 1)) + 1;
+            uint64_t unSeen = 0;
+            for (std::size_t unIndex = 0; unIndex < k_unBuckets; ++unIndex) {
+                unSeen += m_arrBuckets[unIndex];
+                if (unSeen >= unRank) {
+                    return unBucketUpperBound(unIndex);
+                }
+            }
+            return unBucketUpperBound(k_unBuckets - 1);
+        }
+
+        /******************************************************************************
+         * @brief   記録件数の取得
+         * @arg     なし
+         * @return  件数（半減後の値）
+         * @note
+         *****************************************************************************/
+        uint64_t GetCount() const {
+            return m_unCount;
+        }
+
+        /******************************************************************************
+         * @brief   全記録の破棄
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Clear() {
+            m_arrBuckets.fill(0);
+            m_unCount = 0;
+        }
+
+    private:
+        static constexpr std::size_t k_unSubBits   = 3;
+        static constexpr std::size_t k_unSubCount  = std::size_t(1) << k_unSubBits;
+        static constexpr std::size_t k_unLinearMax = 2 * k_unSubCount;    // これ未満は 1 刻み
+        static constexpr std::size_t k_unBuckets   = k_unLinearMax + (64 - (k_unSubBits + 1)) * k_unSubCount;
+
+        /******************************************************************************
+         * @brief   値からバケット番号を求める
+         * @arg     unValue (in) 値
+         * @return  バケット番号
+         * @note
+         *****************************************************************************/
+        static std::size_t unBucketIndex(uint64_t unValue) {
+            if (unValue < k_unLinearMax) {
+                return static_cast<std::size_t>(unValue);
+            }
+            std::size_t unExponent = 63 - static_cast<std::size_t>(__builtin_clzll(unValue));
+            std::size_t unSub = static_cast<std::size_t>(unValue >> (unExponent - k_unSubBits)) & (k_unSubCount - 1);
+            return k_unLinearMax + (unExponent - (k_unSubBits + 1)) * k_unSubCount + unSub;
+        }
+
+        /******************************************************************************
+         * @brief   バケットの上限値を求める
+         * @arg     unIndex (in) バケット番号
+         * @return  バケットに入る最大値
+         * @note
+         *****************************************************************************/
+        static uint64_t unBucketUpperBound(std::size_t unIndex) {
+            if (unIndex < k_unLinearMax) {
+                return static_cast<uint64_t>(unIndex);
+            }
+            std::size_t unExponent = (unIndex - k_unLinearMax) / k_unSubCount + (k_unSubBits + 1);
+            uint64_t unSub = static_cast<uint64_t>((unIndex - k_unLinearMax) % k_unSubCount);
+            uint64_t unStep = uint64_t(1) << (unExponent - k_unSubBits);
+            return (uint64_t(1) << unExponent) + (unSub + 1) * unStep - 1;
+        }
+
+        std::array<uint64_t, k_unBuckets> m_arrBuckets;
+        uint64_t                          m_unCount;
+        uint64_t                          m_unWindow;
+    };
+
+    // ヘッジング設定
+    struct HedgingConfig {
+        uint64_t  unTimeoutMs        = 1000;    // 要求全体の待ち時間
+        uint64_t  unFixedDelayUs     = 0;       // ヘッジまでの固定遅延（0:ヒストグラムから求める）
+        float64_t dbDelayPercentile  = 0.95;    // ヘッジ遅延に使う送信先の遅延パーセンタイル
+        uint64_t  unMinDelayUs       = 500;     // ヘッジ遅延の下限
+        uint64_t  unInitialDelayUs   = 10000;   // 記録が unMinSamples 未満の間のヘッジ遅延
+        uint64_t  unMinSamples       = 100;
+        float64_t dbMaxHedgeRatio    = 0.05;    // ヘッジの上限（要求数に対する割合）
+        float64_t dbMaxHedgeBurst    = 10.0;    // ヘッジ予算の最大蓄積量（回）
+        bool      bSendCancel        = true;    // 負けた側へ取り消し要求を Urgent で送る
+    };
+
+    // ヘッジング統計
+    struct HedgingStats {
+        uint64_t unRequests      = 0;   // 要求数
+        uint64_t unHedges        = 0;   // 重ねて送った要求数
+        uint64_t unHedgeWins     = 0;   // 重ねて送った側の応答が先に届いた要求数
+        uint64_t unBudgetDenied  = 0;   // 予算不足でヘッジしなかった回数
+        uint64_t unFailovers     = 0;   // 送信先の切断により別の送信先へ送り直した回数
+        uint64_t unTimeouts      = 0;   // 応答なく時間切れになった要求数
+        uint64_t unLateResponses = 0;   // 決着後に届いた応答数（遅延の記録にのみ使う）
+        uint64_t unCancels       = 0;   // 送った取り消し要求数
+    };
+
+    // ヘッジング付き要求クライアント（1 スレッドから使うこと）
+    class HedgingClient {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     stConfig (in) ヘッジング設定
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        explicit HedgingClient(const HedgingConfig& stConfig = HedgingConfig())
+            : m_stConfig(stConfig), m_cSelector(SelectMode::CompleteFrame),
+              m_vecEndpoints(), m_cOverallHistogram(), m_unNextRequestId(0), m_unNextEndpoint(0),
+              m_dbHedgeTokens(stConfig.dbMaxHedgeBurst), m_stStats() { }
+
+        HedgingClient(const HedgingClient&) = delete;
+        HedgingClient& operator=(const HedgingClient&) = delete;
+
+        /******************************************************************************
+         * @brief   送信先（接続済みソケット）の追加
+         * @arg     cSocket (in) 送信先ソケット
+         * @return  送信先番号
+         * @note    ソケットは呼び出し側が所有し、クライアントより長く生存させること。
+         *          同じサーバーへの別接続を追加すれば、接続単位の遅延にも効く。
+         *          Selector への登録に失敗した場合は std::system_error を送出する
+         *****************************************************************************/
+        std::size_t AddEndpoint(Socket& cSocket) {
+            if (!m_cSelector.Add(cSocket)) {
+                throw std::system_error(errno, std::system_category(), "HedgingClient: add endpoint");
+            }
+            m_vecEndpoints.push_back(Endpoint{&cSocket, LatencyHistogram(), {}, false});
+            return m_vecEndpoints.size() - 1;
+        }
+
+        /******************************************************************************
+         * @brief   要求の送信と応答の受信
+         * @arg     msgRequest  (in)  要求（"$rid" は上書きする）
+         * @arg     msgResponse (out) 応答（"$rid" は取り除く）
+         * @return  結果 true:応答を受信した false:時間切れ・全送信先が切断
+         * @note    応答待ちの少ない送信先へ送り、ヘッジ遅延までに応答がなければ
+         *          予算の範囲で次の送信先へ同じ要求を送る。先に届いた応答を返し、
+         *          もう一方には取り消し要求を送る（遅れて届いた応答は読み捨てる）
+         *****************************************************************************/
+        bool Call(const Message& msgRequest, Message& msgResponse) {
+            std::vector<uint8_t> vecResponse;
+            if (!CallFrame(msgRequest, vecResponse)) {
+                return false;
+            }
+            msgResponse = DecodeMessage(vecResponse);
+            msgResponse.erase(k_pszRequestIdKey);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   要求の送信と応答フレームの受信
+         * @arg     msgRequest  (in)  要求（"$rid" は上書きする）
+         * @arg     vecResponse (out) 応答フレーム（ヘッダ含む、デコードしない）
+         * @return  結果 true:応答を受信した false:時間切れ・全送信先が切断
+         * @note    Call と同じ
+         *****************************************************************************/
+        bool CallFrame(const Message& msgRequest, std::vector<uint8_t>& vecResponse) {
+            if (m_vecEndpoints.empty()) {
+                throw std::logic_error("HedgingClient: no endpoint");
+            }
+            ++m_stStats.unRequests;
+            m_dbHedgeTokens = std::min(m_stConfig.dbMaxHedgeBurst, m_dbHedgeTokens + m_stConfig.dbMaxHedgeRatio);
+
+            const uint64_t unRequestId = ++m_unNextRequestId;
+            Message msgSend = msgRequest;
+            msgSend[k_pszRequestIdKey] = unRequestId;
+            const SharedFrame cFrame = SharedFrame::Encode(msgSend);
+
+            const Clock::time_point tpBegin = Clock::now();
+            const Clock::time_point tpDeadline = tpBegin + std::chrono::milliseconds(m_stConfig.unTimeoutMs);
+            vPrunePending(tpBegin);
+
+            std::vector<std::size_t> vecAttempts;
+            std::size_t unPrimary = 0;
+            if (!bSendAttempt(cFrame, unRequestId, vecAttempts, unPrimary)) {
+                return false;
+            }
+            Clock::time_point tpHedge = tpBegin + std::chrono::microseconds(GetHedgeDelayUs(unPrimary));
+            bool bHedgeDecided = false;
+            std::vector<Socket*> vecReady;
+            for (;;) {
+                Clock::time_point tpNow = Clock::now();
+                if (!bHedgeDecided && tpNow >= tpHedge) {
+                    bHedgeDecided = true;
+                    vSendHedge(cFrame, unRequestId, vecAttempts);
+                }
+                if (tpNow >= tpDeadline) {
+                    ++m_stStats.unTimeouts;
+                    vCancelAttempts(unRequestId, vecAttempts, m_vecEndpoints.size());
+                    return false;
+                }
+                Clock::time_point tpWake = bHedgeDecided ? tpDeadline : std::min(tpHedge, tpDeadline);
+                int32_t snWaitMs = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    tpWake - tpNow + std::chrono::microseconds(999)).count());
+                m_cSelector.Wait(vecReady, snWaitMs);
+                if (bCollectResponse(vecReady, unRequestId, vecAttempts, vecResponse)) {
+                    return true;
+                }
+                if (!bResendIfAllClosed(cFrame, unRequestId, vecAttempts)) {
+                    return false;
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   送信先のヘッジ遅延の取得
+         * @arg     unEndpoint (in) 送信先番号
+         * @return  ヘッジまでの遅延（マイクロ秒）
+         * @note    固定遅延がなければ、送信先の遅延ヒストグラムのパーセンタイル値。
+         *          送信先の記録が少ない間は全送信先を合わせたヒストグラムを使う
+         *****************************************************************************/
+        uint64_t GetHedgeDelayUs(std::size_t unEndpoint) const {
+            if (m_stConfig.unFixedDelayUs != 0) {
+                return m_stConfig.unFixedDelayUs;
+            }
+            const LatencyHistogram* pRawHistogram = &m_vecEndpoints.at(unEndpoint).cHistogram;
+            if (pRawHistogram->GetCount() < m_stConfig.unMinSamples) {
+                pRawHistogram = &m_cOverallHistogram;
+            }
+            if (pRawHistogram->GetCount() < m_stConfig.unMinSamples) {
+                return m_stConfig.unInitialDelayUs;
+            }
+            return std::max(m_stConfig.unMinDelayUs, pRawHistogram->GetPercentile(m_stConfig.dbDelayPercentile));
+        }
+
+        /******************************************************************************
+         * @brief   送信先の遅延ヒストグラムの取得
+         * @arg     unEndpoint (in) 送信先番号
+         * @return  ヒストグラム（送信から応答受信まで、ヘッジで負けた応答も含む）
+         * @note
+         *****************************************************************************/
+        const LatencyHistogram& GetHistogram(std::size_t unEndpoint) const {
+            return m_vecEndpoints.at(unEndpoint).cHistogram;
+        }
+
+        /******************************************************************************
+         * @brief   送信先が切断されたか判定
+         * @arg     unEndpoint (in) 送信先番号
+         * @return  結果 true:切断（以降は選ばない） false:使用中
+         * @note
+         *****************************************************************************/
+        bool IsEndpointClosed(std::size_t unEndpoint) const {
+            return m_vecEndpoints.at(unEndpoint).bClosed;
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        const HedgingStats& GetStats() const {
+            return m_stStats;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Endpoint {
+            Socket*                                         pRawSocket;   // 所有しない
+            LatencyHistogram                                cHistogram;
+            std::unordered_map<uint64_t, Clock::time_point> mapPending;   // 要求 ID → 送信時刻
+            bool                                            bClosed;
+        };
+
+        /******************************************************************************
+         * @brief   まだ送っていない送信先を選んで送信
+         * @arg     cFrame      (in)     要求フレーム
+         * @arg     unRequestId (in)     要求 ID
+         * @arg     vecAttempts (in/out) 送信済みの送信先番号
+         * @arg     unEndpoint  (out)    送信した送信先番号
+         * @return  結果 true:送信した false:送れる送信先がない
+         * @note    送信に失敗した送信先は切断扱いとし、次の送信先を試す
+         *****************************************************************************/
+        bool bSendAttempt(const SharedFrame& cFrame, uint64_t unRequestId,
+                          std::vector<std::size_t>& vecAttempts, std::size_t& unEndpoint) {
+            const std::size_t unCount = m_vecEndpoints.size();
+            for (std::size_t unTried = 0; unTried < unCount; ++unTried) {
+                // 応答待ちの最も少ない送信先（同数なら巡回順）を選ぶ。
+                // 遅延中の送信先には応答待ちが残るため、続けて選ばれにくい
+                std::size_t unBest = unCount;
+                for (std::size_t unOffset = 0; unOffset < unCount; ++unOffset) {
+                    std::size_t unIndex = (m_unNextEndpoint + unOffset) % unCount;
+                    const Endpoint& stCandidate = m_vecEndpoints[unIndex];
+                    if (stCandidate.bClosed ||
+                        std::find(vecAttempts.begin(), vecAttempts.end(), unIndex) != vecAttempts.end()) {
+                        continue;
+                    }
+                    if (unBest == unCount ||
+                        stCandidate.mapPending.size() < m_vecEndpoints[unBest].mapPending.size()) {
+                        unBest = unIndex;
+                    }
+                }
+                if (unBest == unCount) {
+                    return false;
+                }
+                unEndpoint = unBest;
+                m_unNextEndpoint = (unBest + 1) % unCount;
+                Endpoint& stEndpoint = m_vecEndpoints[unEndpoint];
+                bool bSent = false;
+                try {
+                    bSent = stEndpoint.pRawSocket->SendFrame(cFrame);
+                }
+                catch (const std::system_error&) {
+                    bSent = false;
+                }
+                if (!bSent) {
+                    vCloseEndpoint(unEndpoint);
+                    continue;
+                }
+                stEndpoint.mapPending[unRequestId] = Clock::now();
+                vecAttempts.push_back(unEndpoint);
+                return true;
+            }
+            return false;
+        }
+
+        /******************************************************************************
+         * @brief   予算の範囲でヘッジ要求を送信
+         * @arg     cFrame      (in)     要求フレーム
+         * @arg     unRequestId (in)     要求 ID
+         * @arg     vecAttempts (in/out) 送信済みの送信先番号
+         * @return  なし
+         * @note    予算が 1 回分に満たなければ送らずに統計へ数える
+         *****************************************************************************/
+        void vSendHedge(const SharedFrame& cFrame, uint64_t unRequestId, std::vector<std::size_t>& vecAttempts) {
+            if (m_dbHedgeTokens < 1.0) {
+                ++m_stStats.unBudgetDenied;
+                return;
+            }
+            std::size_t unHedge = 0;
+            if (bSendAttempt(cFrame, unRequestId, vecAttempts, unHedge)) {
+                m_dbHedgeTokens -= 1.0;
+                ++m_stStats.unHedges;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   受信可能になった送信先から応答を回収
+         * @arg     vecReady    (in)  受信可能なソケット
+         * @arg     unRequestId (in)  待っている要求 ID
+         * @arg     vecAttempts (in)  送信済みの送信先番号
+         * @arg     vecResponse (out) 待っている要求への応答
+         * @return  結果 true:応答を受信した false:未受信
+         * @note    応答を受信したら、残りの送信先へ取り消し要求を送る
+         *****************************************************************************/
+        bool bCollectResponse(const std::vector<Socket*>& vecReady, uint64_t unRequestId,
+                              const std::vector<std::size_t>& vecAttempts, std::vector<uint8_t>& vecResponse) {
+            for (Socket* pRawSocket : vecReady) {
+                std::size_t unEndpoint = unFindEndpoint(pRawSocket);
+                if (bDrainEndpoint(unEndpoint, unRequestId, vecResponse)) {
+                    if (unEndpoint != vecAttempts.front()) {
+                        ++m_stStats.unHedgeWins;
+                    }
+                    vCancelAttempts(unRequestId, vecAttempts, unEndpoint);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /******************************************************************************
+         * @brief   送信中の送信先が全て切断された場合に別の送信先へ送り直す
+         * @arg     cFrame      (in)     要求フレーム
+         * @arg     unRequestId (in)     要求 ID
+         * @arg     vecAttempts (in/out) 送信済みの送信先番号
+         * @return  結果 true:応答を待てる送信先がある false:送れる送信先がない
+         * @note    ヘッジ遅延を待たずに送り直す
+         *****************************************************************************/
+        bool bResendIfAllClosed(const SharedFrame& cFrame, uint64_t unRequestId,
+                                std::vector<std::size_t>& vecAttempts) {
+            auto itAlive = std::find_if(vecAttempts.begin(), vecAttempts.end(),
+                [this](std::size_t unIndex) { return !m_vecEndpoints[unIndex].bClosed; });
+            if (itAlive != vecAttempts.end()) {
+                return true;
+            }
+            std::size_t unRetry = 0;
+            if (!bSendAttempt(cFrame, unRequestId, vecAttempts, unRetry)) {
+                return false;
+            }
+            ++m_stStats.unFailovers;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   送信先の受信済みフレームを全て処理
+         * @arg     unEndpoint  (in)  送信先番号
+         * @arg     unRequestId (in)  待っている要求 ID
+         * @arg     vecResponse (out) 待っている要求への応答
+         * @return  結果 true:待っている要求への応答を受信した false:未受信
+         * @note    相手が切断していれば送信先を切断扱いにする
+         *****************************************************************************/
+        bool bDrainEndpoint(std::size_t unEndpoint, uint64_t unRequestId,
+                            std::vector<uint8_t>& vecResponse) {
+            Endpoint& stEndpoint = m_vecEndpoints[unEndpoint];
+            bool bFound = false;
+            std::vector<uint8_t> vecFrame;
+            for (;;) {
+                while (stEndpoint.pRawSocket->PopFrame(vecFrame)) {
+                    vHandleFrame(stEndpoint, unRequestId, vecFrame, vecResponse, bFound);
+                }
+                if (bFound) {
+                    return true;
+                }
+                // 切断の検出（Selector は切断されたソケットも受信可能として返す）
+                ReceiveResult eResult = ReceiveResult::Closed;
+                try {
+                    eResult = stEndpoint.pRawSocket->ReceiveAvailable();
+                }
+                catch (const std::system_error&) {
+                    eResult = ReceiveResult::Closed;
+                }
+                if (!stEndpoint.pRawSocket->HasBufferedFrame()) {
+                    if (eResult == ReceiveResult::Closed) {
+                        vCloseEndpoint(unEndpoint);
+                    }
+                    return false;
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   受信した 1 フレームの処理
+         * @arg     stEndpoint  (in/out) 送信先
+         * @arg     unRequestId (in)     待っている要求 ID
+         * @arg     vecFrame    (in/out) 受信フレーム（応答として採用した場合は空になる）
+         * @arg     vecResponse (out)    待っている要求への応答
+         * @arg     bFound      (in/out) 応答を採用したか
+         * @return  なし
+         * @note    決着済みの要求への応答は遅延を記録して読み捨てる
+         *****************************************************************************/
+        void vHandleFrame(Endpoint& stEndpoint, uint64_t unRequestId, std::vector<uint8_t>& vecFrame,
+                          std::vector<uint8_t>& vecResponse, bool& bFound) {
+            uint64_t unResponseId = 0;
+            if (!GetRequestId(vecFrame, unResponseId)) {
+                return;
+            }
+            auto itPending = stEndpoint.mapPending.find(unResponseId);
+            if (itPending == stEndpoint.mapPending.end()) {
+                return;
+            }
+            uint64_t unMicros = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - itPending->second).count());
+            stEndpoint.cHistogram.Record(unMicros);
+            m_cOverallHistogram.Record(unMicros);
+            stEndpoint.mapPending.erase(itPending);
+            if (unResponseId == unRequestId && !bFound) {
+                vecResponse.swap(vecFrame);
+                bFound = true;
+            }
+            else {
+                ++m_stStats.unLateResponses;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   応答を待たなくなった送信先へ取り消し要求を送る
+         * @arg     unRequestId (in) 要求 ID
+         * @arg     vecAttempts (in) 送信済みの送信先番号
+         * @arg     unWinner    (in) 応答を受信した送信先番号（取り消さない）
+         * @return  なし
+         * @note    遅延の記録のため、取り消した要求の応答も届けば記録する
+         *****************************************************************************/
+        void vCancelAttempts(uint64_t unRequestId, const std::vector<std::size_t>& vecAttempts,
+                             std::size_t unWinner) {
+            if (!m_stConfig.bSendCancel) {
+                return;
+            }
+            for (std::size_t unEndpoint : vecAttempts) {
+                Endpoint& stEndpoint = m_vecEndpoints[unEndpoint];
+                if (unEndpoint == unWinner || stEndpoint.bClosed) {
+                    continue;
+                }
+                Message msgCancel;
+                msgCancel[k_pszRequestIdKey] = unRequestId;
+                msgCancel[k_pszCancelKey] = static_cast<uint64_t>(1);
+                try {
+                    stEndpoint.pRawSocket->SendMessage(msgCancel, SendPriority::Urgent);
+                    ++m_stStats.unCancels;
+                }
+                catch (const std::system_error&) {
+                    vCloseEndpoint(unEndpoint);
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   応答を待ち続けている古い要求の破棄
+         * @arg     tpNow (in) 現在時刻
+         * @return  なし
+         * @note    取り消しにより応答が来ない要求が溜まらないようにする
+         *****************************************************************************/
+        void vPrunePending(Clock::time_point tpNow) {
+            const Clock::time_point tpExpire = tpNow - std::chrono::milliseconds(m_stConfig.unTimeoutMs);
+            for (Endpoint& stEndpoint : m_vecEndpoints) {
+                for (auto itPending = stEndpoint.mapPending.begin(); itPending != stEndpoint.mapPending.end();) {
+                    if (itPending->second < tpExpire) {
+                        itPending = stEndpoint.mapPending.erase(itPending);
+                    }
+                    else {
+                        ++itPending;
+                    }
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   送信先を切断扱いにする
+         * @arg     unEndpoint (in) 送信先番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vCloseEndpoint(std::size_t unEndpoint) {
+            Endpoint& stEndpoint = m_vecEndpoints[unEndpoint];
+            if (stEndpoint.bClosed) {
+                return;
+            }
+            stEndpoint.bClosed = true;
+            stEndpoint.mapPending.clear();
+            m_cSelector.Remove(*stEndpoint.pRawSocket);
+        }
+
+        /******************************************************************************
+         * @brief   ソケットから送信先番号を求める
+         * @arg     pRawSocket (in) ソケット
+         * @return  送信先番号
+         * @note
+         *****************************************************************************/
+        std::size_t unFindEndpoint(const Socket* pRawSocket) const {
+            for (std::size_t unIndex = 0; unIndex < m_vecEndpoints.size(); ++unIndex) {
+                if (m_vecEndpoints[unIndex].pRawSocket == pRawSocket) {
+                    return unIndex;
+                }
+            }
+            throw std::logic_error("HedgingClient: unknown socket");
+        }
+
+        HedgingConfig         m_stConfig;
+        Selector              m_cSelector;
+        std::vector<Endpoint> m_vecEndpoints;
+        LatencyHistogram      m_cOverallHistogram;  // 全送信先の遅延
+        uint64_t              m_unNextRequestId;
+        std::size_t           m_unNextEndpoint;
+        float64_t             m_dbHedgeTokens;      // ヘッジ予算（要求ごとに dbMaxHedgeRatio 増え、ヘッジで 1 減る）
+        HedgingStats          m_stStats;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,387 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPResponseCache.h
+ * @brief   SimpleBinaryDictionaryProtocol Client Response Cache
+ * @author  Satoh
+ * @note    エンコード済みの要求バイト列（キー順に整列済みで一意）をキーに、
+ *          エンコード済みの応答を保持するクライアント側キャッシュ。
+ *          シャードごとのロックで分割し、TTL とバイト数上限の CLOCK 方式で追い出す。
+ *          ヒット時はデコードするか、SharedFrame を FieldView で参照するだけで済む
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "SBDP.h"
+#include "SBDPHash.h"
+#include "SBDPSharedFrame.h"
+#include "SBDPSingleFlight.h"
+
+namespace sbdp {
+
+    // 1 エントリあたりの管理領域の見積もり（バイト数上限の計算に含める）
+    constexpr std::size_t k_unCacheEntryOverhead = 96;
+
+    // 応答キャッシュ設定
+    struct ResponseCacheConfig {
+        std::size_t unShards   = 16;                  // シャード数（ロックの分割数）
+        std::size_t unMaxBytes = 64 * 1024 * 1024;    // 全体のバイト数上限（シャードに等分する）
+        uint64_t    unTtlMs    = 5000;                // 既定の有効期間
+    };
+
+    // 応答キャッシュ統計
+    struct ResponseCacheStats {
+        uint64_t unHits      = 0;
+        uint64_t unMisses    = 0;   // 期限切れを含む
+        uint64_t unExpired   = 0;   // 期限切れで破棄した数
+        uint64_t unInserts   = 0;
+        uint64_t unEvictions = 0;   // バイト数上限で追い出した数
+        uint64_t unRejected  = 0;   // シャードの上限を超えるため格納しなかった数
+        std::size_t unEntries = 0;
+        std::size_t unBytes   = 0;  // 管理領域の見積もりを含む
+
+        /******************************************************************************
+         * @brief   ヒット率の取得
+         * @arg     なし
+         * @return  ヒット率（0.0～1.0、参照がない場合は 0）
+         * @note
+         *****************************************************************************/
+        float64_t GetHitRatio() const {
+            uint64_t unLookups = unHits + unMisses;
+            return (unLookups == 0) ? 0.0 : static_cast<float64_t>(unHits) / static_cast<float64_t>(unLookups);
+        }
+    };
+
+    // 応答キャッシュ（スレッドセーフ）
+    class ResponseCache {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     stConfig (in) 設定
+         * @return  なし
+         * @note    シャード数が 0 の場合は std::invalid_argument を送出する
+         *****************************************************************************/
+        explicit ResponseCache(const ResponseCacheConfig& stConfig = ResponseCacheConfig())
+            : m_stConfig(stConfig) {
+            if (m_stConfig.unShards == 0) {
+                throw std::invalid_argument("ResponseCacheConfig: no shard");
+            }
+            m_vecShards.reserve(m_stConfig.unShards);
+            for (std::size_t unIndex = 0; unIndex < m_stConfig.unShards; ++unIndex) {
+                m_vecShards.push_back(std::make_unique<Shard>(m_stConfig.unMaxBytes / m_stConfig.unShards));
+            }
+        }
+
+        ResponseCache(const ResponseCache&) = delete;
+        ResponseCache& operator=(const ResponseCache&) = delete;
+
+        /******************************************************************************
+         * @brief   エンコード済み応答の参照
+         * @arg     svKey     (in)  エンコード済みの要求
+         * @arg     cResponse (out) エンコード済みの応答（共有、コピーしない）
+         * @return  結果 true:ヒット false:ミス・期限切れ
+         * @note
+         *****************************************************************************/
+        bool Lookup(std::string_view svKey, SharedFrame& cResponse) {
+            const uint64_t unHash = HashBytes(svKey);
+            Shard& stShard = stSelectShard(unHash);
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            auto itEntry = stShard.mapIndex.find(svKey);
+            if (itEntry == stShard.mapIndex.end()) {
+                ++stShard.stStats.unMisses;
+                return false;
+            }
+            Slot& stSlot = stShard.vecSlots[itEntry->second];
+            if (stSlot.unExpireMs <= unNowMs()) {
+                ++stShard.stStats.unExpired;
+                ++stShard.stStats.unMisses;
+                vRemoveSlot(stShard, itEntry->second);
+                return false;
+            }
+            stSlot.bReferenced = true;
+            cResponse = stSlot.cResponse;
+            ++stShard.stStats.unHits;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   応答の参照（デコードして返す）
+         * @arg     msgRequest  (in)  要求
+         * @arg     msgResponse (out) 応答
+         * @return  結果 true:ヒット false:ミス・期限切れ
+         * @note
+         *****************************************************************************/
+        bool Lookup(const Message& msgRequest, Message& msgResponse) {
+            std::vector<uint8_t> vecKey = EncodeMessage(msgRequest);
+            SharedFrame cResponse;
+            if (!Lookup(svView(vecKey), cResponse)) {
+                return false;
+            }
+            msgResponse = DecodeMessage(cResponse.Bytes());
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   エンコード済み応答の格納
+         * @arg     svKey     (in) エンコード済みの要求
+         * @arg     cResponse (in) エンコード済みの応答
+         * @arg     unTtlMs   (in) 有効期間（0:設定の既定値）
+         * @return  結果 true:格納した false:シャードの上限を超えるため格納しなかった
+         * @note    同じキーがあれば置き換える。上限を超える分は CLOCK 方式で
+         *          期限切れ・参照ビットなしのエントリから追い出す
+         *****************************************************************************/
+        bool Insert(std::string_view svKey, const SharedFrame& cResponse, uint64_t unTtlMs = 0) {
+            const uint64_t unHash = HashBytes(svKey);
+            Shard& stShard = stSelectShard(unHash);
+            const std::size_t unBytes = svKey.size() + cResponse.Size() + k_unCacheEntryOverhead;
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            auto itEntry = stShard.mapIndex.find(svKey);
+            if (itEntry != stShard.mapIndex.end()) {
+                vRemoveSlot(stShard, itEntry->second);
+            }
+            if (unBytes > stShard.unMaxBytes) {
+                ++stShard.stStats.unRejected;
+                return false;
+            }
+            const uint64_t unNow = unNowMs();
+            while (stShard.unBytes + unBytes > stShard.unMaxBytes) {
+                vEvictOne(stShard, unNow);
+            }
+            std::size_t unSlot = 0;
+            if (!stShard.vecFree.empty()) {
+                unSlot = stShard.vecFree.back();
+                stShard.vecFree.pop_back();
+            }
+            else {
+                unSlot = stShard.vecSlots.size();
+                stShard.vecSlots.emplace_back();
+            }
+            Slot& stSlot = stShard.vecSlots[unSlot];
+            stSlot.upKey = std::make_unique<std::string>(svKey);
+            stSlot.cResponse = cResponse;
+            stSlot.unExpireMs = unNow + ((unTtlMs != 0) ? unTtlMs : m_stConfig.unTtlMs);
+            stSlot.unBytes = unBytes;
+            stSlot.bUsed = true;
+            stSlot.bReferenced = false;
+            stShard.mapIndex.emplace(std::string_view(*stSlot.upKey), unSlot);
+            stShard.unBytes += unBytes;
+            ++stShard.stStats.unInserts;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   応答の格納
+         * @arg     msgRequest  (in) 要求
+         * @arg     msgResponse (in) 応答
+         * @arg     unTtlMs     (in) 有効期間（0:設定の既定値）
+         * @return  結果 true:格納した false:格納しなかった
+         * @note
+         *****************************************************************************/
+        bool Insert(const Message& msgRequest, const Message& msgResponse, uint64_t unTtlMs = 0) {
+            std::vector<uint8_t> vecKey = EncodeMessage(msgRequest);
+            return Insert(svView(vecKey), SharedFrame::Encode(msgResponse), unTtlMs);
+        }
+
+        /******************************************************************************
+         * @brief   キャッシュを参照し、ミスなら要求を送って結果を格納
+         * @arg     msgRequest  (in)  要求
+         * @arg     msgResponse (out) 応答
+         * @arg     fnRequest   (in)  ミス時に要求を送る関数
+         * @return  結果 true:正常 false:異常（fnRequest が失敗した、失敗は格納しない）
+         * @note    同時に多数のミスが起きる場合は fnRequest に SingleFlight::Call を渡すとよい
+         *****************************************************************************/
+        bool Call(const Message& msgRequest, Message& msgResponse, const RequestFunction& fnRequest) {
+            std::vector<uint8_t> vecKey = EncodeMessage(msgRequest);
+            SharedFrame cResponse;
+            if (Lookup(svView(vecKey), cResponse)) {
+                msgResponse = DecodeMessage(cResponse.Bytes());
+                return true;
+            }
+            if (!fnRequest(msgRequest, msgResponse)) {
+                return false;
+            }
+            Insert(svView(vecKey), SharedFrame::Encode(msgResponse));
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   エントリの削除
+         * @arg     svKey (in) エンコード済みの要求
+         * @return  結果 true:削除した false:なかった
+         * @note
+         *****************************************************************************/
+        bool Erase(std::string_view svKey) {
+            Shard& stShard = stSelectShard(HashBytes(svKey));
+            std::lock_guard<std::mutex> lock(stShard.mtxShard);
+            auto itEntry = stShard.mapIndex.find(svKey);
+            if (itEntry == stShard.mapIndex.end()) {
+                return false;
+            }
+            vRemoveSlot(stShard, itEntry->second);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   全エントリの削除
+         * @arg     なし
+         * @return  なし
+         * @note    統計は保持する
+         *****************************************************************************/
+        void Clear() {
+            for (std::unique_ptr<Shard>& upShard : m_vecShards) {
+                std::lock_guard<std::mutex> lock(upShard->mtxShard);
+                upShard->mapIndex.clear();
+                upShard->vecSlots.clear();
+                upShard->vecFree.clear();
+                upShard->unBytes = 0;
+                upShard->unHand = 0;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  全シャードの合計
+         * @note
+         *****************************************************************************/
+        ResponseCacheStats GetStats() const {
+            ResponseCacheStats stTotal;
+            for (const std::unique_ptr<Shard>& upShard : m_vecShards) {
+                std::lock_guard<std::mutex> lock(upShard->mtxShard);
+                const ResponseCacheStats& stStats = upShard->stStats;
+                stTotal.unHits += stStats.unHits;
+                stTotal.unMisses += stStats.unMisses;
+                stTotal.unExpired += stStats.unExpired;
+                stTotal.unInserts += stStats.unInserts;
+                stTotal.unEvictions += stStats.unEvictions;
+                stTotal.unRejected += stStats.unRejected;
+                stTotal.unEntries += upShard->mapIndex.size();
+                stTotal.unBytes += upShard->unBytes;
+            }
+            return stTotal;
+        }
+
+    private:
+        // エントリ（キーは mapIndex の string_view が参照するため、アドレスが変わらないよう別確保）
+        struct Slot {
+            std::unique_ptr<std::string> upKey;
+            SharedFrame                  cResponse;
+            uint64_t                     unExpireMs  = 0;
+            std::size_t                  unBytes     = 0;
+            bool                         bUsed       = false;
+            bool                         bReferenced = false;   // CLOCK の参照ビット
+        };
+
+        // string_view 用のハッシュ関数（シャード選択と同じハッシュ）
+        struct KeyHash {
+            std::size_t operator()(std::string_view svKey) const {
+                return static_cast<std::size_t>(HashBytes(svKey));
+            }
+        };
+
+        struct Shard {
+            explicit Shard(std::size_t unMax) : unMaxBytes(unMax), unBytes(0), unHand(0) { }
+
+            std::mutex                                                   mtxShard;
+            std::unordered_map<std::string_view, std::size_t, KeyHash>   mapIndex;  // キー → スロット番号
+            std::vector<Slot>                                            vecSlots;
+            std::vector<std::size_t>                                     vecFree;
+            std::size_t                                                  unMaxBytes;
+            std::size_t                                                  unBytes;
+            std::size_t                                                  unHand;    // CLOCK の針
+            ResponseCacheStats                                           stStats;
+        };
+
+        /******************************************************************************
+         * @brief   バイト列の string_view の取得
+         * @arg     vecData (in) バイト列
+         * @return  string_view
+         * @note
+         *****************************************************************************/
+        static std::string_view svView(const std::vector<uint8_t>& vecData) {
+            return std::string_view(reinterpret_cast<const char*>(vecData.data()), vecData.size());
+        }
+
+        /******************************************************************************
+         * @brief   現在時刻（ミリ秒）の取得
+         * @arg     なし
+         * @return  steady_clock のミリ秒
+         * @note
+         *****************************************************************************/
+        static uint64_t unNowMs() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /******************************************************************************
+         * @brief   ハッシュ値からシャードを選ぶ
+         * @arg     unHash (in) ハッシュ値
+         * @return  シャード
+         * @note    上位ビットを使い、シャード内のハッシュ表のバケット選択と偏らないようにする
+         *****************************************************************************/
+        Shard& stSelectShard(uint64_t unHash) {
+            return *m_vecShards[static_cast<std::size_t>((unHash >> 32) % m_vecShards.size())];
+        }
+
+        /******************************************************************************
+         * @brief   CLOCK 方式で 1 エントリを追い出す
+         * @arg     stShard (in/out) シャード
+         * @arg     unNow   (in)     現在時刻（ミリ秒）
+         * @return  なし
+         * @note    参照ビットが立っているエントリはビットを落として 1 周猶予する。
+         *          期限切れのエントリは参照ビットに関わらず追い出す
+         *****************************************************************************/
+        static void vEvictOne(Shard& stShard, uint64_t unNow) {
+            const std::size_t unSlots = stShard.vecSlots.size();
+            for (std::size_t unStep = 0; unStep < 2 * unSlots + 1; ++unStep) {
+                std::size_t unSlot = stShard.unHand;
+                stShard.unHand = (stShard.unHand + 1) % unSlots;
+                Slot& stSlot = stShard.vecSlots[unSlot];
+                if (!stSlot.bUsed) {
+                    continue;
+                }
+                if (stSlot.unExpireMs <= unNow) {
+                    ++stShard.stStats.unExpired;
+                    vRemoveSlot(stShard, unSlot);
+                    return;
+                }
+                if (stSlot.bReferenced) {
+                    stSlot.bReferenced = false;
+                    continue;
+                }
+                ++stShard.stStats.unEvictions;
+                vRemoveSlot(stShard, unSlot);
+                return;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   エントリの削除
+         * @arg     stShard (in/out) シャード
+         * @arg     unSlot  (in)     スロット番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vRemoveSlot(Shard& stShard, std::size_t unSlot) {
+            Slot& stSlot = stShard.vecSlots[unSlot];
+            stShard.mapIndex.erase(std::string_view(*stSlot.upKey));
+            stShard.unBytes -= stSlot.unBytes;
+            stSlot = Slot();
+            stShard.vecFree.push_back(unSlot);
+        }
+
+        ResponseCacheConfig                 m_stConfig;
+        std::vector<std::unique_ptr<Shard>> m_vecShards;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,528 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPRouter.h
+ * @brief   SimpleBinaryDictionaryProtocol Content-based Router
+ * @author  Satoh
+ * @note    1 キーの値のみを参照して転送先を決め、受信フレームを
+ *          バイト列のまま上流の接続プールへ転送する
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPFieldView.h"
+#include "SBDPHash.h"
+
+namespace sbdp {
+
+    // 転送先なしを表す上流番号
+    constexpr std::size_t k_unNoRoute = std::numeric_limits<std::size_t>::max();
+
+    // 値のバイト列から上流番号を決める関数（k_unNoRoute で転送先なし）
+    using RouteFunction = std::function<std::size_t(const FieldView& stValue)>;
+
+    // 振り分け結果
+    enum class RouteResult : uint8_t {
+        Ok = 0,         // 転送した
+        NoKey,          // キーがなく、既定の転送先もない
+        NoRoute,        // 振り分け関数が転送先なしと判定した
+        SendFailed,     // 上流への送信に失敗した
+        BadFrame,       // フレームが破損している
+    };
+
+    /******************************************************************************
+     * @brief   値を順序保存のバイト列へ変換
+     * @arg     stValue (in) 値
+     * @return  辞書順比較が値の大小と一致するバイト列
+     * @note    uint64 はネットワークバイトオーダーのまま、int64 は符号ビットを反転。
+     *          float64 は負数なら全ビット、それ以外は符号ビットのみ反転する（NaN は対象外）
+     *****************************************************************************/
+    inline std::string ToOrderedBytes(const FieldView& stValue) {
+        std::string strBytes(stValue.AsStringView());
+        if (strBytes.empty()) {
+            return strBytes;
+        }
+        if (stValue.eType == TYPE_INT64) {
+            strBytes[0] = static_cast<char>(static_cast<uint8_t>(strBytes[0]) ^ 0x80);
+        }
+        else if (stValue.eType == TYPE_FLOAT64) {
+            if ((static_cast<uint8_t>(strBytes[0]) & 0x80) != 0) {
+                for (char& chByte : strBytes) {
+                    chByte = static_cast<char>(~static_cast<uint8_t>(chByte));
+                }
+            }
+            else {
+                strBytes[0] = static_cast<char>(static_cast<uint8_t>(strBytes[0]) ^ 0x80);
+            }
+        }
+        return strBytes;
+    }
+
+    // コンシステントハッシュ（仮想ノード付きハッシュリング）
+    class ConsistentHashRing {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     unUpstreamCount (in) 上流数
+         * @arg     unVirtualNodes  (in) 上流あたりの仮想ノード数
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        explicit ConsistentHashRing(std::size_t unUpstreamCount, std::size_t unVirtualNodes = 160) {
+            for (std::size_t unUpstream = 0; unUpstream < unUpstreamCount; ++unUpstream) {
+                AddUpstream(unUpstream, unVirtualNodes);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   上流をリングへ追加
+         * @arg     unUpstream     (in) 上流番号
+         * @arg     unVirtualNodes (in) 仮想ノード数
+         * @return  なし
+         * @note    他の上流に割り当て済みのキーは概ね 1/N のみ移動する
+         *****************************************************************************/
+        void AddUpstream(std::size_t unUpstream, std::size_t unVirtualNodes = 160) {
+            for (std::size_t unNode = 0; unNode < unVirtualNodes; ++unNode) {
+                uint64_t unPoint[2] = {htonll(static_cast<uint64_t>(unUpstream)),
+                                       htonll(static_cast<uint64_t>(unNode))};
+                uint64_t unHash = HashBytes(reinterpret_cast<const uint8_t*>(unPoint), sizeof(unPoint));
+                m_vecRing.emplace_back(unHash, unUpstream);
+            }
+            std::sort(m_vecRing.begin(), m_vecRing.end());
+        }
+
+        /******************************************************************************
+         * @brief   上流をリングから削除
+         * @arg     unUpstream (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void RemoveUpstream(std::size_t unUpstream) {
+            m_vecRing.erase(std::remove_if(m_vecRing.begin(), m_vecRing.end(),
+                                           [unUpstream](const std::pair<uint64_t, std::size_t>& prPoint) {
+                                               return prPoint.second == unUpstream;
+                                           }),
+                            m_vecRing.end());
+        }
+
+        /******************************************************************************
+         * @brief   値から上流番号を決定
+         * @arg     stValue (in) 値
+         * @return  上流番号（リングが空の場合 k_unNoRoute）
+         * @note    値の生バイト列をハッシュする
+         *****************************************************************************/
+        std::size_t operator()(const FieldView& stValue) const {
+            if (m_vecRing.empty()) {
+                return k_unNoRoute;
+            }
+            uint64_t unHash = HashBytes(stValue.pData, stValue.unSize);
+            auto itPoint = std::lower_bound(
+                m_vecRing.begin(), m_vecRing.end(),
+                std::make_pair(unHash, static_cast<std::size_t>(0)));
+            if (itPoint == m_vecRing.end()) {
+                itPoint = m_vecRing.begin();
+            }
+            return itPoint->second;
+        }
+
+    private:
+        std::vector<std::pair<uint64_t, std::size_t>> m_vecRing;
+    };
+
+    // 範囲表（下限値の昇順で区間を定義）
+    class RangeTable {
+    public:
+        /******************************************************************************
+         * @brief   区間の追加（uint64 キー）
+         * @arg     unLowerBound (in) 区間の下限（この値以上）
+         * @arg     unUpstream   (in) 上流番号
+         * @return  なし
+         * @note    次に大きい下限の直前までが区間となる
+         *****************************************************************************/
+        void AddRange(uint64_t unLowerBound, std::size_t unUpstream) {
+            uint64_t unNetValue = htonll(unLowerBound);
+            vAddRange(std::string(reinterpret_cast<const char*>(&unNetValue), sizeof(unNetValue)),
+                      unUpstream);
+        }
+
+        /******************************************************************************
+         * @brief   区間の追加（int64 キー）
+         * @arg     snLowerBound (in) 区間の下限（この値以上）
+         * @arg     unUpstream   (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void AddRange(int64_t snLowerBound, std::size_t unUpstream) {
+            uint64_t unNetValue = htonll(static_cast<uint64_t>(snLowerBound));
+            FieldView stView {TYPE_INT64, reinterpret_cast<const uint8_t*>(&unNetValue),
+                              sizeof(unNetValue)};
+            vAddRange(ToOrderedBytes(stView), unUpstream);
+        }
+
+        /******************************************************************************
+         * @brief   区間の追加（float64 キー）
+         * @arg     dbLowerBound (in) 区間の下限（この値以上）
+         * @arg     unUpstream   (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void AddRange(float64_t dbLowerBound, std::size_t unUpstream) {
+            uint64_t unBits = 0;
+            std::memcpy(&unBits, &dbLowerBound, sizeof(unBits));
+            uint64_t unNetValue = htonll(unBits);
+            FieldView stView {TYPE_FLOAT64, reinterpret_cast<const uint8_t*>(&unNetValue),
+                              sizeof(unNetValue)};
+            vAddRange(ToOrderedBytes(stView), unUpstream);
+        }
+
+        /******************************************************************************
+         * @brief   区間の追加（文字列・バイナリキー、辞書順）
+         * @arg     strLowerBound (in) 区間の下限（この値以上）
+         * @arg     unUpstream    (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void AddRange(const std::string& strLowerBound, std::size_t unUpstream) {
+            vAddRange(strLowerBound, unUpstream);
+        }
+
+        /******************************************************************************
+         * @brief   値から上流番号を決定
+         * @arg     stValue (in) 値
+         * @return  上流番号（最小の下限より小さい場合 k_unNoRoute）
+         * @note
+         *****************************************************************************/
+        std::size_t operator()(const FieldView& stValue) const {
+            std::string strKey = ToOrderedBytes(stValue);
+            auto itRange = std::upper_bound(
+                m_vecRanges.begin(), m_vecRanges.end(), strKey,
+                [](const std::string& strValue, const std::pair<std::string, std::size_t>& prRange) {
+                    return strValue < prRange.first;
+                });
+            if (itRange == m_vecRanges.begin()) {
+                return k_unNoRoute;
+            }
+            return std::prev(itRange)->second;
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   順序保存バイト列の下限で区間を追加
+         * @arg     strLowerBound (in) 下限
+         * @arg     unUpstream    (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vAddRange(std::string strLowerBound, std::size_t unUpstream) {
+            m_vecRanges.emplace_back(std::move(strLowerBound), unUpstream);
+            std::sort(m_vecRanges.begin(), m_vecRanges.end());
+        }
+
+    private:
+        std::vector<std::pair<std::string, std::size_t>> m_vecRanges;
+    };
+
+    // 完全一致表
+    class ExactMatchTable {
+    public:
+        /******************************************************************************
+         * @brief   文字列・バイナリ値の登録
+         * @arg     strValue   (in) 値
+         * @arg     unUpstream (in) 上流番号
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Add(const std::string& strValue, std::size_t unUpstream) {
+            m_mapRoutes[strValue] = unUpstream;
+        }
+
+        /******************************************************************************
+         * @brief   整数値の登録
+         * @arg     unValue    (in) 値（uint64 として比較する）
+         * @arg     unUpstream (in) 上流番号
+         * @return  なし
+         * @note    int64 キーは static_cast<uint64_t> した値で登録する
+         *****************************************************************************/
+        void Add(uint64_t unValue, std::size_t unUpstream) {
+            uint64_t unNetValue = htonll(unValue);
+            m_mapRoutes[std::string(reinterpret_cast<const char*>(&unNetValue), sizeof(unNetValue))] =
+                unUpstream;
+        }
+
+        /******************************************************************************
+         * @brief   値から上流番号を決定
+         * @arg     stValue (in) 値
+         * @return  上流番号（未登録の場合 k_unNoRoute）
+         * @note
+         *****************************************************************************/
+        std::size_t operator()(const FieldView& stValue) const {
+            auto itRoute = m_mapRoutes.find(std::string(stValue.AsStringView()));
+            return (itRoute == m_mapRoutes.end()) ? k_unNoRoute : itRoute->second;
+        }
+
+    private:
+        std::unordered_map<std::string, std::size_t> m_mapRoutes;
+    };
+
+    // 切断した上流接続の再接続を試みる最短間隔（ミリ秒）
+    constexpr uint64_t k_unReconnectIntervalMs = 1000;
+    // 上流への再接続のタイムアウト（ミリ秒）
+    constexpr uint64_t k_unReconnectTimeoutMs  = 1000;
+
+    // 上流の接続プール（接続ごとに排他し、ラウンドロビンで選択）
+    class UpstreamPool {
+    public:
+        UpstreamPool() : m_unNext(0), m_unLive(0) { }
+
+        UpstreamPool(const UpstreamPool&) = delete;
+        UpstreamPool& operator=(const UpstreamPool&) = delete;
+
+        /******************************************************************************
+         * @brief   接続済みソケットの追加
+         * @arg     cSocket (in) 接続済みソケット
+         * @return  なし
+         * @note    転送開始前に追加すること。接続先が不明なため、送信に失敗した後は再接続しない
+         *****************************************************************************/
+        void AddConnection(Socket&& cSocket) {
+            std::unique_ptr<Connection> upConnection = std::make_unique<Connection>();
+            upConnection->cSocket = std::move(cSocket);
+            upConnection->bConnected = true;
+            m_vecConnections.push_back(std::move(upConnection));
+            m_unLive.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /******************************************************************************
+         * @brief   上流へ接続して追加
+         * @arg     strHost (in) 接続先ホスト
+         * @arg     unPort  (in) 接続先ポート
+         * @return  結果 true:接続した false:接続失敗（再接続対象として追加済み）
+         * @note    転送開始前に追加すること。送信に失敗した接続はプールから外し、
+         *          k_unReconnectIntervalMs ごとに再接続を試みる
+         *****************************************************************************/
+        bool AddConnection(const std::string& strHost, unsigned short unPort) {
+            std::unique_ptr<Connection> upConnection = std::make_unique<Connection>();
+            upConnection->strHost = strHost;
+            upConnection->unPort = unPort;
+            bool bConnected = bReconnect(*upConnection);
+            m_vecConnections.push_back(std::move(upConnection));
+            return bConnected;
+        }
+
+        /******************************************************************************
+         * @brief   エンコード済みフレームをそのまま送信
+         * @arg     pFrame      (in) フレーム先頭
+         * @arg     unFrameSize (in) フレーム長
+         * @return  結果 true:正常 false:送信できる接続なし
+         * @note    送信に失敗した接続は送信途中のフレームが残り以後のフレームの境界が崩れるため、
+         *          閉じてプールから外し、同じフレームを次の接続で送り直す
+         *          （閉じた接続の途中までのフレームは相手側で破棄される）
+         *****************************************************************************/
+        bool SendFrame(const uint8_t* pFrame, std::size_t unFrameSize) {
+            const std::size_t unCount = m_vecConnections.size();
+            if (unCount == 0) {
+                return false;
+            }
+            std::size_t unStart = m_unNext.fetch_add(1, std::memory_order_relaxed);
+            for (std::size_t unTry = 0; unTry < unCount; ++unTry) {
+                Connection& stConnection = *m_vecConnections[(unStart + unTry) % unCount];
+                std::unique_lock<std::mutex> lock(stConnection.mtxSend);
+                if (!stConnection.bConnected && !bReconnect(stConnection)) {
+                    continue;
+                }
+                try {
+                    if (stConnection.cSocket.SendAll(pFrame, unFrameSize)) {
+                        return true;
+                    }
+                }
+                catch (const std::system_error&) {
+                    // 下で接続を外す
+                }
+                vEvict(stConnection);
+            }
+            return false;
+        }
+
+        /******************************************************************************
+         * @brief   接続数の取得
+         * @arg     なし
+         * @return  送信に使用中の接続数（プールから外した接続は含まない）
+         * @note
+         *****************************************************************************/
+        std::size_t GetConnectionCount() const {
+            return m_unLive.load(std::memory_order_relaxed);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Connection {
+            std::mutex        mtxSend;
+            Socket            cSocket;
+            bool              bConnected = false;   // false:プールから外している
+            std::string       strHost;              // 再接続先（空:再接続しない）
+            unsigned short    unPort     = 0;
+            Clock::time_point tpRetry;              // 次に再接続を試みる時刻
+        };
+
+        /******************************************************************************
+         * @brief   接続を閉じてプールから外す
+         * @arg     stConnection (in) 接続（mtxSend をロック済みであること）
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vEvict(Connection& stConnection) {
+            stConnection.cSocket.Close();
+            stConnection.bConnected = false;
+            stConnection.tpRetry = Clock::now() + std::chrono::milliseconds(k_unReconnectIntervalMs);
+            m_unLive.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /******************************************************************************
+         * @brief   外した接続の再接続
+         * @arg     stConnection (in) 接続（mtxSend をロック済みであること）
+         * @return  結果 true:接続した false:再接続しない・間隔内・接続失敗
+         * @note
+         *****************************************************************************/
+        bool bReconnect(Connection& stConnection) {
+            if (stConnection.strHost.empty() || Clock::now() < stConnection.tpRetry) {
+                return false;
+            }
+            ConnectOptions stConnect;
+            stConnect.unTimeoutMs = k_unReconnectTimeoutMs;
+            Socket cSocket;
+            if (!cSocket.Connect(stConnection.strHost, stConnection.unPort, stConnect)) {
+                stConnection.tpRetry = Clock::now() + std::chrono::milliseconds(k_unReconnectIntervalMs);
+                return false;
+            }
+            stConnection.cSocket = std::move(cSocket);
+            stConnection.bConnected = true;
+            m_unLive.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::vector<std::unique_ptr<Connection>> m_vecConnections;
+        std::atomic<std::size_t>                 m_unNext;
+        std::atomic<std::size_t>                 m_unLive;
+    };
+
+    // 内容ベースのルーター（キー 1 つだけを遅延参照して転送先を決める）
+    class Router {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     strKey  (in) 振り分けに使うキー
+         * @arg     fnRoute (in) 振り分け関数
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        Router(std::string strKey, RouteFunction fnRoute)
+            : m_strKey(std::move(strKey)), m_fnRoute(std::move(fnRoute)),
+              m_unDefaultUpstream(k_unNoRoute) { }
+
+        Router(const Router&) = delete;
+        Router& operator=(const Router&) = delete;
+
+        /******************************************************************************
+         * @brief   上流プールの追加
+         * @arg     upPool (in) 上流プール
+         * @return  上流番号
+         * @note    転送開始前に追加すること
+         *****************************************************************************/
+        std::size_t AddUpstream(std::unique_ptr<UpstreamPool> upPool) {
+            m_vecUpstreams.push_back(std::move(upPool));
+            return m_vecUpstreams.size() - 1;
+        }
+
+        /******************************************************************************
+         * @brief   キーを持たないフレームの転送先設定
+         * @arg     unUpstream (in) 上流番号（k_unNoRoute で破棄）
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void SetDefaultUpstream(std::size_t unUpstream) {
+            m_unDefaultUpstream = unUpstream;
+        }
+
+        /******************************************************************************
+         * @brief   フレームの転送先を決定
+         * @arg     pFrame      (in)  フレーム先頭
+         * @arg     unFrameSize (in)  フレーム長
+         * @arg     unUpstream  (out) 上流番号
+         * @return  結果
+         * @retval  Ok=決定, NoKey=キーなし, NoRoute=転送先なし, BadFrame=破損
+         * @note    キー以外のフィールドはデコードしない
+         *****************************************************************************/
+        RouteResult Select(const uint8_t* pFrame, std::size_t unFrameSize,
+                           std::size_t& unUpstream) const {
+            FieldView stValue {};
+            bool bFound = false;
+            try {
+                bFound = FindField(pFrame, unFrameSize, m_strKey, stValue);
+            }
+            catch (const std::runtime_error&) {
+                return RouteResult::BadFrame;
+            }
+            unUpstream = bFound ? m_fnRoute(stValue) : m_unDefaultUpstream;
+            if (unUpstream == k_unNoRoute || unUpstream >= m_vecUpstreams.size()) {
+                return bFound ? RouteResult::NoRoute : RouteResult::NoKey;
+            }
+            return RouteResult::Ok;
+        }
+
+        /******************************************************************************
+         * @brief   フレームを振り分けて元のバイト列のまま転送
+         * @arg     vecFrame (in) エンコード済みフレーム
+         * @return  結果
+         * @retval  Ok=転送, NoKey/NoRoute=転送先なし, SendFailed=送信失敗, BadFrame=破損
+         * @note
+         *****************************************************************************/
+        RouteResult Route(const std::vector<uint8_t>& vecFrame) {
+            std::size_t unUpstream = k_unNoRoute;
+            RouteResult eResult = Select(vecFrame.data(), vecFrame.size(), unUpstream);
+            if (eResult != RouteResult::Ok) {
+                return eResult;
+            }
+            if (!m_vecUpstreams[unUpstream]->SendFrame(vecFrame.data(), vecFrame.size())) {
+                return RouteResult::SendFailed;
+            }
+            return RouteResult::Ok;
+        }
+
+        /******************************************************************************
+         * @brief   受信側ソケットから 1 フレーム受信して転送
+         * @arg     cInbound    (in) 受信側ソケット
+         * @arg     unTimeoutMs (in) 受信タイムアウト(ミリ秒)
+         * @return  結果（Route と同じ）
+         * @note    受信エラーは std::system_error / std::runtime_error を送出する
+         *****************************************************************************/
+        RouteResult ForwardOne(Socket& cInbound, uint64_t unTimeoutMs = 0) {
+            std::vector<uint8_t> vecFrame;
+            cInbound.RecvFrame(vecFrame, unTimeoutMs);
+            return Route(vecFrame);
+        }
+
+    private:
+        std::string                                m_strKey;
+        RouteFunction                              m_fnRoute;
+        std::size_t                                m_unDefaultUpstream;
+        std::vector<std::unique_ptr<UpstreamPool>> m_vecUpstreams;
+    };
+
+} // namespace sbdp
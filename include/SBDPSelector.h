@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPSelector.h
+ * @brief   SimpleBinaryDictionaryProtocol Socket Selector
+ * @author  Satoh
+ * @note    多数の Socket から受信可能なものをまとめて待つ（Linux 専用、epoll）。
+ *          返したソケットは従来のブロッキング API（RecvMessage 等）で読める
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#ifndef __linux__
+#error "SBDPSelector.h requires Linux (epoll)"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "SBDPSocket.h"
+
+namespace sbdp {
+
+    // 受信可能と判定する条件
+    enum class SelectMode : uint8_t {
+        Readable = 0,       // 完成済みフレームがあるか、未読データが届いている
+        CompleteFrame,      // 完成済みフレームがある（未読データは受信バッファへ取り込んで判定）
+    };
+
+    // ソケットセレクター（登録・待機は同じスレッドから行うこと）
+    class Selector {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     eMode (in) 受信可能と判定する条件
+         * @return  なし
+         * @note    epoll の生成に失敗した場合は std::system_error を送出する
+         *****************************************************************************/
+        explicit Selector(SelectMode eMode = SelectMode::CompleteFrame)
+            : m_hEpoll(::epoll_create1(EPOLL_CLOEXEC)), m_eMode(eMode) {
+            if (m_hEpoll < 0) {
+                throw std::system_error(errno, std::system_category(), "epoll_create1");
+            }
+        }
+
+        ~Selector() {
+            ::close(m_hEpoll);
+        }
+
+        Selector(const Selector&) = delete;
+        Selector& operator=(const Selector&) = delete;
+
+        /******************************************************************************
+         * @brief   ソケットの登録
+         * @arg     cSocket (in) 登録するソケット
+         * @return  結果 true:正常 false:異常
+         * @note    登録中はソケットをムーブ・クローズしないこと（先に Remove する）
+         *****************************************************************************/
+        bool Add(Socket& cSocket) {
+            epoll_event stEvent {};
+            stEvent.events = EPOLLIN | EPOLLRDHUP;
+            stEvent.data.ptr = &cSocket;
+            if (::epoll_ctl(m_hEpoll, EPOLL_CTL_ADD, cSocket.GetHandle(), &stEvent) != 0) {
+                return false;
+            }
+            m_vecSockets.push_back(&cSocket);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットの登録解除
+         * @arg     cSocket (in) 登録解除するソケット
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Remove(Socket& cSocket) {
+            auto itSocket = std::find(m_vecSockets.begin(), m_vecSockets.end(), &cSocket);
+            if (itSocket == m_vecSockets.end()) {
+                return;
+            }
+            m_vecSockets.erase(itSocket);
+            ::epoll_ctl(m_hEpoll, EPOLL_CTL_DEL, cSocket.GetHandle(), nullptr);
+        }
+
+        /******************************************************************************
+         * @brief   受信可能なソケットを待つ
+         * @arg     vecReady    (out) 受信可能なソケット（クリアしてから追加する）
+         * @arg     snTimeoutMs (in)  待ち時間(ミリ秒) -1:無限
+         * @return  受信可能なソケット数（0:タイムアウト）
+         * @note    既に完成済みフレームを持つソケットがあれば待たずに返す。
+         *          CompleteFrame では、届いたデータをノンブロッキングで受信バッファへ
+         *          取り込み、フレームが完成したソケットと切断されたソケットを返す
+         *          （切断されたソケットは RecvMessage が例外を送出する）。
+         *          受信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        size_t Wait(std::vector<Socket*>& vecReady, int32_t snTimeoutMs) {
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point tpDeadline = Clock::now() + std::chrono::milliseconds(std::max(snTimeoutMs, 0));
+            vecReady.clear();
+            for (Socket* pRawSocket : m_vecSockets) {
+                if (pRawSocket->HasBufferedFrame()) {
+                    vecReady.push_back(pRawSocket);
+                }
+            }
+            for (;;) {
+                int32_t snWaitMs = snTimeoutMs;
+                if (!vecReady.empty()) {
+                    snWaitMs = 0;
+                }
+                else if (snTimeoutMs > 0) {
+                    snWaitMs = static_cast<int32_t>(std::max<int64_t>(0,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(tpDeadline - Clock::now()).count()));
+                }
+                epoll_event stEvents[k_unMaxEventsPerSelect];
+                int snCount = ::epoll_wait(m_hEpoll, stEvents, static_cast<int>(k_unMaxEventsPerSelect), snWaitMs);
+                if (snCount < 0) {
+                    if (errno != EINTR) {
+                        throw std::system_error(errno, std::system_category(), "epoll_wait");
+                    }
+                    snCount = 0;
+                }
+                for (int snIndex = 0; snIndex < snCount; ++snIndex) {
+                    Socket* pRawSocket = static_cast<Socket*>(stEvents[snIndex].data.ptr);
+                    if (pRawSocket->HasBufferedFrame()) {
+                        continue;   // 先頭で追加済み
+                    }
+                    if (m_eMode == SelectMode::Readable ||
+                        pRawSocket->ReceiveAvailable() == ReceiveResult::Closed ||
+                        pRawSocket->HasBufferedFrame()) {
+                        vecReady.push_back(pRawSocket);
+                    }
+                }
+                if (!vecReady.empty() || snWaitMs == 0) {
+                    return vecReady.size();
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   登録数の取得
+         * @arg     なし
+         * @return  登録中のソケット数
+         * @note
+         *****************************************************************************/
+        size_t GetSize() const {
+            return m_vecSockets.size();
+        }
+
+    private:
+        static constexpr std::size_t k_unMaxEventsPerSelect = 256;
+
+        int                  m_hEpoll;
+        SelectMode           m_eMode;
+        std::vector<Socket*> m_vecSockets;
+    };
+
+} // namespace sbdp
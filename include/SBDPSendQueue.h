@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPSendQueue.h
+ * @brief   SimpleBinaryDictionaryProtocol Send Queue
+ * @author  Satoh
+ * @note    接続ごとの送信待ちフレームを SharedFrame の参照で保持する。
+ *          優先度の高いフレームはフレーム境界で低いフレームを追い越す
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "SBDPSharedFrame.h"
+
+namespace sbdp {
+
+    // 送信優先度（値が小さいほど先に送る）
+    enum class SendPriority : uint8_t {
+        Urgent = 0,     // 制御（キャンセル・ハートビートなど）
+        Normal,         // 通常の要求・応答
+        Bulk,           // 大きなデータ転送
+    };
+
+    // 送信優先度の段階数
+    constexpr std::size_t k_unSendPriorities = 3;
+
+    // 低優先度フレーム 1 件が追い越される最大回数の既定値（飢餓防止）
+    constexpr std::size_t k_unDefaultMaxOvertakes = 64;
+
+    // 送信用の非所有バッファ参照（iovec / WSABUF への変換元）
+    struct ConstBuffer {
+        const uint8_t* pData;
+        std::size_t    unSize;
+    };
+
+    // 送信キュー（フレーム本体はコピーせず参照のみ保持）
+    class SendQueue {
+    public:
+        SendQueue() : m_unPendingBytes(0), m_unMaxOvertakes(k_unDefaultMaxOvertakes), m_unNextSequence(0) { }
+
+        /******************************************************************************
+         * @brief   フレームを優先度に応じた位置へ追加
+         * @arg     cFrame     (in) 追加するフレーム
+         * @arg     ePriority  (in) 送信優先度
+         * @return  なし
+         * @note    空フレームは無視する。
+         *          自分より優先度の低い未送信フレームの前へ挿入する。ただし送信途中の
+         *          先頭フレームと、追い越し回数が上限に達したフレームは追い越さない。
+         *          追い越し回数は優先度ごとに最も古いフレームについてのみ数える。
+         *          同じ優先度のフレーム同士は追加順に送る
+         *****************************************************************************/
+        void Push(const SharedFrame& cFrame, SendPriority ePriority = SendPriority::Normal) {
+            if (cFrame.IsEmpty()) {
+                return;
+            }
+            // 末尾から、追い越せるフレームの範囲を探す
+            std::size_t unInsert = m_deqEntries.size();
+            std::size_t unPinned = (!m_deqEntries.empty() && m_deqEntries.front().unOffset > 0) ? 1 : 0;
+            while (unInsert > unPinned) {
+                const Entry& stPrev = m_deqEntries[unInsert - 1];
+                if (stPrev.ePriority <= ePriority || stPrev.unOvertaken >= m_unMaxOvertakes) {
+                    break;
+                }
+                --unInsert;
+            }
+            // 追い越し回数は各優先度の先頭（次に送られる）フレームだけ数える。
+            // 後ろのフレームは同じ優先度の先行フレームを待っているだけで飢餓ではない
+            bool bCounted[k_unSendPriorities] {};
+            for (std::size_t unIndex = unInsert; unIndex < m_deqEntries.size(); ++unIndex) {
+                Entry& stEntry = m_deqEntries[unIndex];
+                std::size_t unLane = static_cast<std::size_t>(stEntry.ePriority);
+                if (!bCounted[unLane]) {
+                    bCounted[unLane] = true;
+                    ++stEntry.unOvertaken;
+                }
+            }
+            m_deqEntries.insert(m_deqEntries.begin() + static_cast<std::ptrdiff_t>(unInsert),
+                                Entry{cFrame, 0, ePriority, 0, m_unNextSequence++});
+            m_unPendingBytes += cFrame.Size();
+        }
+
+        /******************************************************************************
+         * @brief   低優先度フレームが追い越される最大回数の設定
+         * @arg     unMaxOvertakes (in) 最大回数（0:優先度による追い越しを行わない）
+         * @return  なし
+         * @note    上限に達したフレームより後ろには、それ以降のフレームは挿入されない
+         *****************************************************************************/
+        void SetMaxOvertakes(std::size_t unMaxOvertakes) {
+            m_unMaxOvertakes = unMaxOvertakes;
+        }
+
+        /******************************************************************************
+         * @brief   未送信部分のバッファ参照を先頭から収集
+         * @arg     vecBuffers   (out) 収集先（クリアしてから追加する）
+         * @arg     unMaxBuffers (in)  収集する最大数
+         * @return  なし
+         * @note    返却した参照は次の Consume / Push まで有効
+         *****************************************************************************/
+        void Gather(std::vector<ConstBuffer>& vecBuffers,
+                    std::size_t unMaxBuffers) const {
+            vecBuffers.clear();
+            for (const Entry& stEntry : m_deqEntries) {
+                if (vecBuffers.size() >= unMaxBuffers) {
+                    break;
+                }
+                vecBuffers.push_back(ConstBuffer{
+                    stEntry.cFrame.Data() + stEntry.unOffset,
+                    stEntry.cFrame.Size() - stEntry.unOffset});
+            }
+        }
+
+        /******************************************************************************
+         * @brief   先頭からフレーム参照を収集
+         * @arg     vecFrames   (out) 収集先（クリアしてから追加する）
+         * @arg     unMaxFrames (in)  収集する最大数
+         * @return  なし
+         * @note    Gather と同じ範囲のフレームを取得し、送信後も参照を保持する場合に使う
+         *****************************************************************************/
+        void CollectFrames(std::vector<SharedFrame>& vecFrames, std::size_t unMaxFrames) const {
+            vecFrames.clear();
+            for (const Entry& stEntry : m_deqEntries) {
+                if (vecFrames.size() >= unMaxFrames) {
+                    break;
+                }
+                vecFrames.push_back(stEntry.cFrame);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   送信済みバイト数を先頭から消費
+         * @arg     unBytes (in) 送信済みバイト数
+         * @return  なし
+         * @note    送信し終えたフレームの参照はここで解放される
+         *****************************************************************************/
+        void Consume(std::size_t unBytes) {
+            while (unBytes > 0 && !m_deqEntries.empty()) {
+                Entry& stEntry = m_deqEntries.front();
+                std::size_t unRemain = stEntry.cFrame.Size() - stEntry.unOffset;
+                if (unBytes < unRemain) {
+                    stEntry.unOffset += unBytes;
+                    m_unPendingBytes -= unBytes;
+                    return;
+                }
+                unBytes -= unRemain;
+                m_unPendingBytes -= unRemain;
+                m_deqEntries.pop_front();
+            }
+        }
+
+        /******************************************************************************
+         * @brief   未送信のフレームを追加順の古いものから破棄
+         * @arg     unBytes         (in)  確保したいバイト数
+         * @arg     unDroppedFrames (out) 破棄したフレーム数
+         * @return  破棄したバイト数
+         * @note    キューは優先度順に並ぶため、追加時の通番で古さを判定する。
+         *          送信途中の先頭フレームと Urgent のフレームは破棄しない（前者はストリームが壊れるため）
+         *****************************************************************************/
+        std::size_t DropOldest(std::size_t unBytes, std::size_t& unDroppedFrames) {
+            unDroppedFrames = 0;
+            std::size_t unKeep = (!m_deqEntries.empty() && m_deqEntries.front().unOffset > 0) ? 1 : 0;
+            std::vector<std::pair<uint64_t, std::size_t>> vecCandidates;     // 通番と位置
+            for (std::size_t unIndex = unKeep; unIndex < m_deqEntries.size(); ++unIndex) {
+                if (m_deqEntries[unIndex].ePriority != SendPriority::Urgent) {
+                    vecCandidates.emplace_back(m_deqEntries[unIndex].unSequence, unIndex);
+                }
+            }
+            std::sort(vecCandidates.begin(), vecCandidates.end());
+            std::vector<bool> vecDrop(m_deqEntries.size(), false);
+            std::size_t unDropped = 0;
+            for (const std::pair<uint64_t, std::size_t>& prCandidate : vecCandidates) {
+                if (unDropped >= unBytes) {
+                    break;
+                }
+                vecDrop[prCandidate.second] = true;
+                unDropped += m_deqEntries[prCandidate.second].cFrame.Size();
+                ++unDroppedFrames;
+            }
+            std::deque<Entry> deqKept;
+            for (std::size_t unIndex = 0; unIndex < m_deqEntries.size(); ++unIndex) {
+                if (!vecDrop[unIndex]) {
+                    deqKept.push_back(std::move(m_deqEntries[unIndex]));
+                }
+            }
+            m_deqEntries.swap(deqKept);
+            m_unPendingBytes -= unDropped;
+            return unDropped;
+        }
+
+        /******************************************************************************
+         * @brief   キューの全破棄
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Clear() {
+            m_deqEntries.clear();
+            m_unPendingBytes = 0;
+        }
+
+        /******************************************************************************
+         * @brief   キューが空か判定
+         * @arg     なし
+         * @return  結果 true:空 false:送信待ちあり
+         * @note
+         *****************************************************************************/
+        bool IsEmpty() const {
+            return m_deqEntries.empty();
+        }
+
+        /******************************************************************************
+         * @brief   未送信バイト数の取得
+         * @arg     なし
+         * @return  未送信バイト数
+         * @note
+         *****************************************************************************/
+        std::size_t GetPendingBytes() const {
+            return m_unPendingBytes;
+        }
+
+        /******************************************************************************
+         * @brief   未送信フレーム数の取得
+         * @arg     なし
+         * @return  未送信フレーム数（送信途中のフレームを含む）
+         * @note
+         *****************************************************************************/
+        std::size_t GetPendingFrames() const {
+            return m_deqEntries.size();
+        }
+
+    private:
+        struct Entry {
+            SharedFrame  cFrame;
+            std::size_t  unOffset;
+            SendPriority ePriority;
+            std::size_t  unOvertaken;   // 後から追加されたフレームに追い越された回数
+            uint64_t     unSequence;    // 追加順の通番
+        };
+
+        std::deque<Entry> m_deqEntries;
+        std::size_t       m_unPendingBytes;
+        std::size_t       m_unMaxOvertakes;
+        uint64_t          m_unNextSequence;
+    };
+
+} // namespace sbdp
@@ -0,0 +1,913 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPServer.h
+ * @brief   SimpleBinaryDictionaryProtocol Request/Response Server
+ * @author  Satoh
+ * @note    I/O ワーカー（イベントループ）で受信・デコードした要求を待ち行列へ積み、
+ *          ハンドラースレッドで処理して応答を返す（Linux 専用）。
+ *          待ち行列の滞留時間を CoDel 方式で監視し、過負荷時は新しい要求を
+ *          事前エンコード済みのエラーフレームで即座に断る。
+ *          要求の "$rid" は応答へ引き継ぎ、"$cancel" で待ち行列中の要求を取り消せる。
+ *          シャードキーを設定すると、そのキーの値（デコードせずに読む）のハッシュで
+ *          要求をハンドラースレッドごとの待ち行列へ固定的に割り振る（同じキーは常に同じスレッドが
+ *          順に処理するため、ハンドラーはキーごとの状態をロックなしで持てる）。
+ *          ハンドラースレッド数を 0 にすると、I/O ワーカー上で直接ハンドラーを呼ぶ
+ *          （スレッド間の受け渡しがなく最も速いが、受付制御は行わない。短い処理向け）
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "SBDPSocket.h"
+#include "SBDPSharedFrame.h"
+#include "SBDPFieldView.h"
+#include "SBDPEventLoop.h"
+#include "SBDPHash.h"
+#include "SBDPRequest.h"
+
+namespace sbdp {
+
+    // エラー応答のキー（文字列）
+    constexpr const char* k_pszErrorKey = "$error";
+    // 過負荷で断ったことを表すエラー
+    constexpr const char* k_pszErrorOverloaded = "overloaded";
+
+    // 要求ハンドラー（false を返すと応答を送らない。複数スレッドから同時に呼ばれる）
+    using ServerHandler = std::function<bool(const Message& msgRequest, Message& msgResponse)>;
+    // シャード番号付きの要求ハンドラー（unShard はハンドラースレッドの番号、I/O ワーカー上で
+    // 処理する場合はワーカーの番号。シャード分割時は同じ unShard で同時に呼ばれることはない）
+    using ShardedHandler = std::function<bool(std::size_t unShard, const Message& msgRequest,
+                                              Message& msgResponse)>;
+
+    // 受付制御の設定
+    struct AdmissionConfig {
+        bool        bEnabled     = true;
+        uint64_t    unTargetUs   = 5000;      // 許容する滞留時間（最小滞留時間がこれを超え続けると過負荷）
+        uint64_t    unIntervalUs = 100000;    // 最小滞留時間を測る区間、かつ平常時の滞留時間の上限
+        std::size_t unMaxQueue   = 0;         // 待ち行列の上限（0:無制限）
+    };
+
+    // サーバー設定
+    struct ServerConfig {
+        uint16_t        unPort          = 0;
+        AddressFamily   eFamily         = AddressFamily::IPv4;
+        std::size_t     unIoThreads     = 1;                    // I/O ワーカー数
+        std::size_t     unHandlerThreads = 4;                   // ハンドラースレッド数（シャード分割時はシャード数、0:I/O ワーカー上で処理）
+        std::string     strShardKey;                            // シャード分割に使うキー（空:全スレッドで 1 つの待ち行列を共有）
+        std::size_t     unMaxFrameSize  = 16 * 1024 * 1024;
+        uint64_t        unIdleTimeoutMs = 0;                    // 受信のないセッションを閉じるまでの時間（0:無効）
+        AdmissionConfig stAdmission;
+    };
+
+    // サーバー統計
+    struct ServerStats {
+        uint64_t    unReceived      = 0;    // 受信した要求数
+        uint64_t    unHandled       = 0;    // ハンドラーで処理した要求数
+        uint64_t    unShedOnArrival = 0;    // 過負荷のため受信時に断った要求数
+        uint64_t    unShedInQueue   = 0;    // 滞留時間超過のため取り出し時に断った要求数
+        uint64_t    unCancelled     = 0;    // 取り消し要求で破棄した要求数
+        uint64_t    unOverloads     = 0;    // 過負荷と判定した区間数
+        std::size_t unQueueLength   = 0;    // 現在の待ち行列長
+    };
+
+    // CoDel 方式の過負荷判定（区間内の最小滞留時間で待ち行列の定常的な滞留を検出する）
+    class CoDelController {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     unTargetUs   (in) 許容する滞留時間
+         * @arg     unIntervalUs (in) 判定区間
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        CoDelController(uint64_t unTargetUs, uint64_t unIntervalUs)
+            : m_unTargetUs(unTargetUs), m_unIntervalUs(unIntervalUs), m_unWindowEndUs(0),
+              m_unMinSojournUs(std::numeric_limits<uint64_t>::max()), m_bOverloaded(false),
+              m_unOverloads(0) { }
+
+        /******************************************************************************
+         * @brief   取り出した要求の滞留時間を記録し、断るか判定
+         * @arg     unSojournUs (in) 滞留時間
+         * @arg     unNowUs     (in) 現在時刻
+         * @return  結果 true:断る false:処理する
+         * @note    区間が終わるたびに、区間内の最小滞留時間が目標を超えていれば過負荷とする。
+         *          過負荷中は目標を超えて待った要求を、平常時は区間を超えて待った要求を断る
+         *****************************************************************************/
+        bool OnDequeue(uint64_t unSojournUs, uint64_t unNowUs) {
+            vRollWindow(unNowUs);
+            m_unMinSojournUs = std::min(m_unMinSojournUs, unSojournUs);
+            return unSojournUs > (m_bOverloaded ? m_unTargetUs : m_unIntervalUs);
+        }
+
+        /******************************************************************************
+         * @brief   待ち行列が空になったことの記録
+         * @arg     unNowUs (in) 現在時刻
+         * @return  なし
+         * @note    空になった区間は滞留なしとみなす
+         *****************************************************************************/
+        void OnEmpty(uint64_t unNowUs) {
+            vRollWindow(unNowUs);
+            m_unMinSojournUs = 0;
+        }
+
+        /******************************************************************************
+         * @brief   過負荷か判定
+         * @arg     なし
+         * @return  結果 true:過負荷 false:平常
+         * @note
+         *****************************************************************************/
+        bool IsOverloaded() const {
+            return m_bOverloaded;
+        }
+
+        /******************************************************************************
+         * @brief   許容する滞留時間の取得
+         * @arg     なし
+         * @return  滞留時間（マイクロ秒）
+         * @note
+         *****************************************************************************/
+        uint64_t GetTargetUs() const {
+            return m_unTargetUs;
+        }
+
+        /******************************************************************************
+         * @brief   過負荷と判定した区間数の取得
+         * @arg     なし
+         * @return  区間数
+         * @note
+         *****************************************************************************/
+        uint64_t GetOverloads() const {
+            return m_unOverloads;
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   区間の終了処理
+         * @arg     unNowUs (in) 現在時刻
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vRollWindow(uint64_t unNowUs) {
+            if (unNowUs < m_unWindowEndUs) {
+                return;
+            }
+            if (m_unWindowEndUs != 0) {
+                m_bOverloaded = (m_unMinSojournUs != std::numeric_limits<uint64_t>::max() &&
+                                 m_unMinSojournUs > m_unTargetUs);
+                if (m_bOverloaded) {
+                    ++m_unOverloads;
+                }
+            }
+            m_unMinSojournUs = std::numeric_limits<uint64_t>::max();
+            m_unWindowEndUs = unNowUs + m_unIntervalUs;
+        }
+
+        uint64_t m_unTargetUs;
+        uint64_t m_unIntervalUs;
+        uint64_t m_unWindowEndUs;
+        uint64_t m_unMinSojournUs;
+        bool     m_bOverloaded;
+        uint64_t m_unOverloads;
+    };
+
+    // 要求/応答サーバー（I/O ワーカーごとにイベントループを持ち、ハンドラーは共有の待ち行列から取る）
+    class Server {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     stConfig  (in) サーバー設定
+         * @arg     fnHandler (in) 要求ハンドラー
+         * @return  なし
+         * @note    スレッド数が不正な場合（シャード分割時のハンドラースレッド数 0 を含む）は
+         *          std::invalid_argument を送出する
+         *****************************************************************************/
+        Server(const ServerConfig& stConfig, ServerHandler fnHandler)
+            : Server(stConfig, ShardedHandler(
+                  [fnHandler = std::move(fnHandler)](std::size_t, const Message& msgRequest,
+                                                     Message& msgResponse) {
+                      return fnHandler(msgRequest, msgResponse);
+                  })) { }
+
+        /******************************************************************************
+         * @brief   コンストラクタ（シャード番号付きハンドラー）
+         * @arg     stConfig  (in) サーバー設定
+         * @arg     fnHandler (in) 要求ハンドラー
+         * @return  なし
+         * @note    stConfig.strShardKey を設定した場合、ハンドラーはシャード番号ごとに
+         *          状態を持てばよい（例: std::vector<State> を unShard で引く）
+         *****************************************************************************/
+        Server(const ServerConfig& stConfig, ShardedHandler fnHandler)
+            : m_stConfig(stConfig), m_fnHandler(std::move(fnHandler)), m_bRunning(false),
+              m_unNextWorker(0), m_cOverloadedFrame(MakeErrorFrame(k_pszErrorOverloaded)),
+              m_unRequestIdOffset(0), m_unHandled(0) {
+            if (m_stConfig.unIoThreads == 0 || m_stConfig.unIoThreads > k_unMaxWorkers ||
+                (bIsSharded() && m_stConfig.unHandlerThreads == 0)) {
+                throw std::invalid_argument("Server: invalid thread count");
+            }
+            std::size_t unQueues = bIsSharded() ? m_stConfig.unHandlerThreads : 1;
+            for (std::size_t unIndex = 0; unIndex < unQueues; ++unIndex) {
+                m_vecQueues.push_back(std::make_unique<RequestQueue>(m_stConfig.stAdmission));
+            }
+            FieldView stField;
+            FindField(m_cOverloadedFrame.Bytes(), k_pszRequestIdKey, stField);
+            m_unRequestIdOffset = static_cast<std::size_t>(stField.pData - m_cOverloadedFrame.Data());
+        }
+        ~Server() { Stop(); }
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /******************************************************************************
+         * @brief   待ち受けとワーカースレッドの開始
+         * @arg     なし
+         * @return  結果 true:正常 false:ソケット作成・バインド・待ち受け失敗
+         * @note
+         *****************************************************************************/
+        bool Start() {
+            if (m_bRunning) {
+                return true;
+            }
+            SocketOptions stOptions;
+            stOptions.bReuseAddress = true;
+            if (!m_cListener.Create(stOptions, m_stConfig.eFamily) || !m_cListener.Bind(m_stConfig.unPort) ||
+                !m_cListener.Listen() || !m_cListener.SetNonBlocking(true)) {
+                m_cListener.Close();
+                return false;
+            }
+            for (std::unique_ptr<RequestQueue>& upQueue : m_vecQueues) {
+                upQueue->Start();
+            }
+            for (std::size_t unIndex = 0; unIndex < m_stConfig.unIoThreads; ++unIndex) {
+                m_vecWorkers.push_back(std::make_unique<Worker>(*this, unIndex));
+            }
+            Worker& cAcceptor = *m_vecWorkers.front();
+            cAcceptor.m_cLoop.Add(m_cListener.GetHandle(), k_unEventRead,
+                                  [this](uint32_t) { vAcceptPending(); });
+            for (std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                Worker& cWorker = *upWorker;
+                m_vecThreads.emplace_back([&cWorker]() { cWorker.m_cLoop.Run(); });
+            }
+            for (std::size_t unIndex = 0; unIndex < m_stConfig.unHandlerThreads; ++unIndex) {
+                m_vecThreads.emplace_back([this, unIndex]() { vHandlerMain(unIndex); });
+            }
+            m_bRunning = true;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   サーバーの停止
+         * @arg     なし
+         * @return  なし
+         * @note    待ち行列の要求は処理せずに破棄し、全接続をクローズする
+         *****************************************************************************/
+        void Stop() {
+            if (!m_bRunning) {
+                return;
+            }
+            for (std::unique_ptr<RequestQueue>& upQueue : m_vecQueues) {
+                upQueue->Stop();
+            }
+            for (std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                upWorker->m_cLoop.Stop();
+            }
+            for (std::thread& thWorker : m_vecThreads) {
+                thWorker.join();
+            }
+            m_vecThreads.clear();
+            m_vecWorkers.clear();
+            m_cListener.Close();
+            m_bRunning = false;
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note    Start 後、Stop 前に呼び出すこと
+         *****************************************************************************/
+        ServerStats GetStats() const {
+            ServerStats stStats;
+            for (const std::unique_ptr<RequestQueue>& upQueue : m_vecQueues) {
+                ServerStats stQueue = upQueue->GetStats();
+                stStats.unShedInQueue += stQueue.unShedInQueue;
+                stStats.unCancelled += stQueue.unCancelled;
+                stStats.unOverloads += stQueue.unOverloads;
+                stStats.unQueueLength += stQueue.unQueueLength;
+            }
+            stStats.unHandled = m_unHandled.load(std::memory_order_relaxed);
+            for (const std::unique_ptr<Worker>& upWorker : m_vecWorkers) {
+                stStats.unReceived += upWorker->m_unReceived.load(std::memory_order_relaxed);
+                stStats.unShedOnArrival += upWorker->m_unShedOnArrival.load(std::memory_order_relaxed);
+            }
+            return stStats;
+        }
+
+        /******************************************************************************
+         * @brief   エラー応答フレームの生成
+         * @arg     pszError (in) エラー内容
+         * @return  {"$rid": 0, "$error": pszError} のフレーム
+         * @note    "$rid" の値は送信時に書き換える
+         *****************************************************************************/
+        static SharedFrame MakeErrorFrame(const char* pszError) {
+            Message msgError;
+            msgError[k_pszRequestIdKey] = static_cast<uint64_t>(0);
+            msgError[k_pszErrorKey] = std::string(pszError);
+            return SharedFrame::Encode(msgError);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // セッション ID の上位ビットに所属ワーカー番号を格納する
+        static constexpr uint32_t    k_unWorkerShift = 48;
+        static constexpr std::size_t k_unMaxWorkers  = 1024;
+
+        // 待ち行列の要求
+        struct Job {
+            uint64_t          unSessionId;
+            uint64_t          unRequestId;
+            bool              bHasRequestId;
+            Message           msgRequest;
+            Clock::time_point tpEnqueued;   // デコード完了時刻
+        };
+
+        // 受付制御付きの要求待ち行列（複数の I/O ワーカーとハンドラーで共有）
+        class RequestQueue {
+        public:
+            explicit RequestQueue(const AdmissionConfig& stConfig)
+                : m_stConfig(stConfig), m_cCoDel(stConfig.unTargetUs, stConfig.unIntervalUs),
+                  m_bStopped(false), m_unShedInQueue(0), m_unCancelled(0) { }
+
+            /******************************************************************************
+             * @brief   受付の再開
+             * @arg     なし
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void Start() {
+                std::lock_guard<std::mutex> lock(m_mtxQueue);
+                m_bStopped = false;
+            }
+
+            /******************************************************************************
+             * @brief   要求の追加（受付制御）
+             * @arg     stJob (in) 要求
+             * @return  結果 true:追加した false:過負荷のため断った
+             * @note    過負荷中は、先頭の要求が既に目標以上待っていれば新しい要求を断る
+             *          （追加しても目標内には処理されず、取り出し時に断られるため）
+             *****************************************************************************/
+            bool Push(Job&& stJob) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxQueue);
+                    if (m_stConfig.unMaxQueue != 0 && m_deqJobs.size() >= m_stConfig.unMaxQueue) {
+                        return false;
+                    }
+                    if (m_stConfig.bEnabled && m_cCoDel.IsOverloaded() && !m_deqJobs.empty() &&
+                        unElapsedUs(m_deqJobs.front().tpEnqueued, stJob.tpEnqueued) > m_cCoDel.GetTargetUs()) {
+                        return false;
+                    }
+                    m_deqJobs.push_back(std::move(stJob));
+                }
+                m_cvQueue.notify_one();
+                return true;
+            }
+
+            /******************************************************************************
+             * @brief   要求の取り出し（停止まで待つ）
+             * @arg     stJob (out) 要求
+             * @arg     bShed (out) true:滞留時間超過のため断る false:処理する
+             * @return  結果 true:取り出した false:停止した
+             * @note
+             *****************************************************************************/
+            bool Pop(Job& stJob, bool& bShed) {
+                std::unique_lock<std::mutex> lock(m_mtxQueue);
+                if (m_deqJobs.empty() && !m_bStopped) {
+                    m_cCoDel.OnEmpty(unNowUs());
+                    m_cvQueue.wait(lock, [this]() { return m_bStopped || !m_deqJobs.empty(); });
+                }
+                if (m_bStopped) {
+                    return false;
+                }
+                stJob = std::move(m_deqJobs.front());
+                m_deqJobs.pop_front();
+                bShed = false;
+                if (m_stConfig.bEnabled) {
+                    Clock::time_point tpNow = Clock::now();
+                    bShed = m_cCoDel.OnDequeue(unElapsedUs(stJob.tpEnqueued, tpNow), unToUs(tpNow));
+                    if (bShed) {
+                        ++m_unShedInQueue;
+                    }
+                }
+                return true;
+            }
+
+            /******************************************************************************
+             * @brief   待ち行列中の要求の取り消し
+             * @arg     unSessionId (in) セッション ID
+             * @arg     unRequestId (in) 要求 ID
+             * @return  結果 true:取り消した false:見つからない（処理中・処理済み）
+             * @note
+             *****************************************************************************/
+            bool Cancel(uint64_t unSessionId, uint64_t unRequestId) {
+                std::lock_guard<std::mutex> lock(m_mtxQueue);
+                auto itJob = std::find_if(m_deqJobs.begin(), m_deqJobs.end(), [&](const Job& stJob) {
+                    return stJob.unSessionId == unSessionId && stJob.bHasRequestId &&
+                           stJob.unRequestId == unRequestId;
+                });
+                if (itJob == m_deqJobs.end()) {
+                    return false;
+                }
+                m_deqJobs.erase(itJob);
+                ++m_unCancelled;
+                return true;
+            }
+
+            /******************************************************************************
+             * @brief   停止（待っているハンドラーを起こし、残りの要求を破棄する）
+             * @arg     なし
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void Stop() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxQueue);
+                    m_bStopped = true;
+                    m_deqJobs.clear();
+                }
+                m_cvQueue.notify_all();
+            }
+
+            /******************************************************************************
+             * @brief   統計の取得
+             * @arg     なし
+             * @return  待ち行列に関する項目のみ設定した統計
+             * @note
+             *****************************************************************************/
+            ServerStats GetStats() const {
+                std::lock_guard<std::mutex> lock(m_mtxQueue);
+                ServerStats stStats;
+                stStats.unShedInQueue = m_unShedInQueue;
+                stStats.unCancelled = m_unCancelled;
+                stStats.unOverloads = m_cCoDel.GetOverloads();
+                stStats.unQueueLength = m_deqJobs.size();
+                return stStats;
+            }
+
+        private:
+            static uint64_t unToUs(Clock::time_point tpTime) {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    tpTime.time_since_epoch()).count());
+            }
+
+            static uint64_t unNowUs() {
+                return unToUs(Clock::now());
+            }
+
+            static uint64_t unElapsedUs(Clock::time_point tpFrom, Clock::time_point tpTo) {
+                return (tpTo <= tpFrom) ? 0 : static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(tpTo - tpFrom).count());
+            }
+
+            AdmissionConfig         m_stConfig;
+            CoDelController         m_cCoDel;
+            mutable std::mutex      m_mtxQueue;
+            std::condition_variable m_cvQueue;
+            std::deque<Job>         m_deqJobs;
+            bool                    m_bStopped;
+            uint64_t                m_unShedInQueue;
+            uint64_t                m_unCancelled;
+        };
+
+        struct Session {
+            Socket    cSocket;
+            bool      bWantWrite = false;
+            bool      bDirty     = false;
+            TimerNode stIdleTimer;
+        };
+
+        struct Response {
+            uint64_t    unSessionId;
+            SharedFrame cFrame;
+        };
+
+        // I/O ワーカー（1 スレッド・1 イベントループ、所属セッションはこのスレッドのみが操作する）
+        class Worker {
+        public:
+            Worker(Server& cServer, std::size_t unIndex)
+                : m_cLoop(), m_unReceived(0), m_unShedOnArrival(0), m_cServer(cServer),
+                  m_unIndex(unIndex), m_unNextSequence(1) {
+                m_cLoop.AddIterationCallback([this]() { vFlushDirty(); });
+            }
+
+            /******************************************************************************
+             * @brief   受け付けた接続をこのワーカーへ登録
+             * @arg     spSocket (in) 受け付けたソケット
+             * @return  なし
+             * @note    ループスレッドで呼び出すこと
+             *****************************************************************************/
+            void Attach(const std::shared_ptr<Socket>& spSocket) {
+                uint64_t unId = (static_cast<uint64_t>(m_unIndex) << k_unWorkerShift) |
+                                m_unNextSequence++;
+                std::unique_ptr<Session> upSession = std::make_unique<Session>();
+                upSession->cSocket = std::move(*spSocket);
+                upSession->cSocket.SetNonBlocking(true);
+                upSession->cSocket.SetMaxFrameSize(m_cServer.m_stConfig.unMaxFrameSize);
+                // 期限切れ処理の途中でノードを持つセッションを破棄しないよう、クローズは後続タスクで行う
+                upSession->stIdleTimer.fnCallback = [this, unId]() {
+                    m_cLoop.Post([this, unId]() { vCloseSession(unId); });
+                };
+                vArmIdleTimer(*upSession);
+                SocketOptions stOptions = upSession->cSocket.GetOptions();
+                stOptions.bNoDelay = true;
+                upSession->cSocket.SetOptions(stOptions);
+                SOCKET hHandle = upSession->cSocket.GetHandle();
+                m_mapSessions.emplace(unId, std::move(upSession));
+                m_cLoop.Add(hHandle, k_unEventRead,
+                            [this, unId](uint32_t unEvents) { vOnEvent(unId, unEvents); });
+            }
+
+            /******************************************************************************
+             * @brief   応答の引き渡し（ハンドラースレッドから呼ぶ）
+             * @arg     unSessionId (in) セッション ID
+             * @arg     cFrame      (in) 応答フレーム
+             * @return  なし
+             * @note    応答箱が空から非空になったときだけループへタスクを投げる
+             *****************************************************************************/
+            void PostResponse(uint64_t unSessionId, const SharedFrame& cFrame) {
+                bool bWake = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxOutbox);
+                    bWake = m_vecOutbox.empty();
+                    m_vecOutbox.push_back(Response{unSessionId, cFrame});
+                }
+                if (bWake) {
+                    m_cLoop.Post([this]() { vDrainOutbox(); });
+                }
+            }
+
+        private:
+            /******************************************************************************
+             * @brief   セッションのイベント処理
+             * @arg     unId     (in) セッション ID
+             * @arg     unEvents (in) 発生イベント
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vOnEvent(uint64_t unId, uint32_t unEvents) {
+                auto itSession = m_mapSessions.find(unId);
+                if (itSession == m_mapSessions.end()) {
+                    return;
+                }
+                Session& stSession = *itSession->second;
+                try {
+                    if (unEvents & k_unEventWrite) {
+                        vFlushSession(stSession);
+                    }
+                    if (unEvents & (k_unEventRead | k_unEventError)) {
+                        vOnReadable(unId, stSession);
+                    }
+                }
+                catch (const std::exception&) {
+                    vCloseSession(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   受信データの処理
+             * @arg     unId      (in) セッション ID
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note    切断・不正フレームは例外として呼び出し元でクローズする
+             *****************************************************************************/
+            void vOnReadable(uint64_t unId, Session& stSession) {
+                vArmIdleTimer(stSession);
+                bool bClosed = (stSession.cSocket.ReceiveAvailable() == ReceiveResult::Closed);
+                std::vector<uint8_t> vecFrame;
+                while (stSession.cSocket.PopFrame(vecFrame)) {
+                    vHandleFrame(unId, stSession, vecFrame);
+                }
+                if (bClosed) {
+                    vCloseSession(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   1 フレームの処理（取り消し・受付制御・待ち行列への追加）
+             * @arg     unId      (in) セッション ID
+             * @arg     stSession (in) セッション
+             * @arg     vecFrame  (in) 受信フレーム
+             * @return  なし
+             * @note    断った要求には事前エンコード済みのエラーフレームを返す
+             *****************************************************************************/
+            void vHandleFrame(uint64_t unId, Session& stSession, const std::vector<uint8_t>& vecFrame) {
+                Job stJob;
+                stJob.unSessionId = unId;
+                stJob.unRequestId = 0;
+                stJob.bHasRequestId = GetRequestId(vecFrame, stJob.unRequestId);
+                if (IsCancelRequest(vecFrame)) {
+                    if (stJob.bHasRequestId) {
+                        // 取り消し要求はシャードキーを持つとは限らないため全待ち行列を探す
+                        for (std::unique_ptr<RequestQueue>& upQueue : m_cServer.m_vecQueues) {
+                            if (upQueue->Cancel(unId, stJob.unRequestId)) {
+                                break;
+                            }
+                        }
+                    }
+                    return;
+                }
+                m_unReceived.fetch_add(1, std::memory_order_relaxed);
+                if (m_cServer.m_stConfig.unHandlerThreads == 0) {
+                    SharedFrame cResponse;
+                    if (m_cServer.bInvoke(m_unIndex, DecodeMessage(vecFrame), stJob.bHasRequestId,
+                                          stJob.unRequestId, cResponse)) {
+                        vEnqueue(unId, stSession, cResponse);
+                    }
+                    return;
+                }
+                RequestQueue& cQueue = *m_cServer.m_vecQueues[m_cServer.unSelectShard(unId, vecFrame)];
+                stJob.msgRequest = DecodeMessage(vecFrame);
+                stJob.tpEnqueued = Clock::now();
+                uint64_t unRequestId = stJob.unRequestId;
+                if (!cQueue.Push(std::move(stJob))) {
+                    m_unShedOnArrival.fetch_add(1, std::memory_order_relaxed);
+                    vEnqueue(unId, stSession, m_cServer.cMakeOverloaded(unRequestId));
+                }
+            }
+
+            /******************************************************************************
+             * @brief   ハンドラーからの応答をセッションの送信キューへ積む
+             * @arg     なし
+             * @return  なし
+             * @note    ループスレッドで実行される
+             *****************************************************************************/
+            void vDrainOutbox() {
+                std::vector<Response> vecResponses;
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxOutbox);
+                    vecResponses.swap(m_vecOutbox);
+                }
+                for (Response& stResponse : vecResponses) {
+                    auto itSession = m_mapSessions.find(stResponse.unSessionId);
+                    if (itSession == m_mapSessions.end()) {
+                        continue;   // 応答前に切断された
+                    }
+                    vEnqueue(stResponse.unSessionId, *itSession->second, stResponse.cFrame);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   送信キューへ積み、ループ反復の終わりに送出する
+             * @arg     unId      (in) セッション ID
+             * @arg     stSession (in) セッション
+             * @arg     cFrame    (in) 送信フレーム
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vEnqueue(uint64_t unId, Session& stSession, const SharedFrame& cFrame) {
+                stSession.cSocket.EnqueueFrame(cFrame);
+                if (!stSession.bDirty) {
+                    stSession.bDirty = true;
+                    m_vecDirty.push_back(unId);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   ループ反復の終わりに、送信待ちのあるセッションを送出
+             * @arg     なし
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vFlushDirty() {
+                std::vector<uint64_t> vecDirty;
+                vecDirty.swap(m_vecDirty);
+                for (uint64_t unId : vecDirty) {
+                    auto itSession = m_mapSessions.find(unId);
+                    if (itSession == m_mapSessions.end()) {
+                        continue;
+                    }
+                    itSession->second->bDirty = false;
+                    try {
+                        vFlushSession(*itSession->second);
+                    }
+                    catch (const std::exception&) {
+                        vCloseSession(unId);
+                    }
+                }
+            }
+
+            /******************************************************************************
+             * @brief   セッションの送信キューを送出し書き込み監視を切り替える
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note
+             *****************************************************************************/
+            void vFlushSession(Session& stSession) {
+                bool bWantWrite = (stSession.cSocket.FlushSendQueue() == FlushResult::WouldBlock);
+                if (bWantWrite != stSession.bWantWrite) {
+                    stSession.bWantWrite = bWantWrite;
+                    m_cLoop.Modify(stSession.cSocket.GetHandle(),
+                                   bWantWrite ? (k_unEventRead | k_unEventWrite) : k_unEventRead);
+                }
+            }
+
+            /******************************************************************************
+             * @brief   セッションのクローズ
+             * @arg     unId (in) セッション ID
+             * @return  なし
+             * @note    待ち行列に残った要求の応答は、届いた時点で破棄される
+             *****************************************************************************/
+            void vCloseSession(uint64_t unId) {
+                auto itSession = m_mapSessions.find(unId);
+                if (itSession == m_mapSessions.end()) {
+                    return;
+                }
+                std::unique_ptr<Session> upSession = std::move(itSession->second);
+                m_mapSessions.erase(itSession);
+                m_cLoop.Remove(upSession->cSocket.GetHandle());
+                m_cLoop.CancelTimer(upSession->stIdleTimer);
+                upSession->cSocket.Close();
+            }
+
+            /******************************************************************************
+             * @brief   無受信タイマーの再設定
+             * @arg     stSession (in) セッション
+             * @return  なし
+             * @note    設定で無効の場合は何もしない
+             *****************************************************************************/
+            void vArmIdleTimer(Session& stSession) {
+                uint64_t unIdleTimeoutMs = m_cServer.m_stConfig.unIdleTimeoutMs;
+                if (unIdleTimeoutMs != 0) {
+                    m_cLoop.ArmTimer(stSession.stIdleTimer, unIdleTimeoutMs);
+                }
+            }
+
+        public:
+            EventLoop                                              m_cLoop;
+            std::atomic<uint64_t>                                  m_unReceived;
+            std::atomic<uint64_t>                                  m_unShedOnArrival;
+
+        private:
+            Server&                                                m_cServer;
+            std::size_t                                            m_unIndex;
+            uint64_t                                               m_unNextSequence;
+            std::unordered_map<uint64_t, std::unique_ptr<Session>> m_mapSessions;
+            std::vector<uint64_t>                                  m_vecDirty;
+            std::mutex                                             m_mtxOutbox;
+            std::vector<Response>                                  m_vecOutbox;
+        };
+
+        /******************************************************************************
+         * @brief   ハンドラースレッドの本体
+         * @arg     unIndex (in) ハンドラースレッド番号
+         * @return  なし
+         * @note    シャード分割時は自スレッド専用の待ち行列から取り出す。
+         *          滞留時間超過の要求はハンドラーを呼ばずにエラーフレームを返す
+         *****************************************************************************/
+        void vHandlerMain(std::size_t unIndex) {
+            RequestQueue& cQueue = *m_vecQueues[bIsSharded() ? unIndex : 0];
+            Job stJob;
+            bool bShed = false;
+            while (cQueue.Pop(stJob, bShed)) {
+                Worker& cWorker = *m_vecWorkers[static_cast<std::size_t>(stJob.unSessionId >> k_unWorkerShift)];
+                if (bShed) {
+                    cWorker.PostResponse(stJob.unSessionId, cMakeOverloaded(stJob.unRequestId));
+                    continue;
+                }
+                SharedFrame cResponse;
+                if (bInvoke(unIndex, stJob.msgRequest, stJob.bHasRequestId, stJob.unRequestId, cResponse)) {
+                    cWorker.PostResponse(stJob.unSessionId, cResponse);
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   ハンドラーの呼び出しと応答のエンコード
+         * @arg     unShard       (in)  シャード番号
+         * @arg     msgRequest    (in)  要求
+         * @arg     bHasRequestId (in)  要求 ID の有無
+         * @arg     unRequestId   (in)  要求 ID
+         * @arg     cResponse     (out) 応答フレーム
+         * @return  結果 true:応答あり false:応答なし
+         * @note    ハンドラーの例外は応答なしとして扱う
+         *****************************************************************************/
+        bool bInvoke(std::size_t unShard, const Message& msgRequest, bool bHasRequestId,
+                     uint64_t unRequestId, SharedFrame& cResponse) {
+            Message msgResponse;
+            bool bRespond = false;
+            try {
+                bRespond = m_fnHandler(unShard, msgRequest, msgResponse);
+            }
+            catch (const std::exception&) {
+                bRespond = false;
+            }
+            m_unHandled.fetch_add(1, std::memory_order_relaxed);
+            if (!bRespond) {
+                return false;
+            }
+            if (bHasRequestId) {
+                msgResponse[k_pszRequestIdKey] = unRequestId;
+            }
+            cResponse = SharedFrame::Encode(msgResponse);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   シャード分割するか判定
+         * @arg     なし
+         * @return  結果 true:シャード分割 false:共有の待ち行列
+         * @note
+         *****************************************************************************/
+        bool bIsSharded() const {
+            return !m_stConfig.strShardKey.empty();
+        }
+
+        /******************************************************************************
+         * @brief   要求を積む待ち行列の選択
+         * @arg     unSessionId (in) セッション ID
+         * @arg     vecFrame    (in) 受信フレーム
+         * @return  待ち行列の番号
+         * @note    シャードキーの値をデコードせずにフレーム上でハッシュする。
+         *          キーを持たない要求はセッション ID で割り振る（接続内の順序は保たれる）
+         *****************************************************************************/
+        std::size_t unSelectShard(uint64_t unSessionId, const std::vector<uint8_t>& vecFrame) const {
+            if (!bIsSharded()) {
+                return 0;
+            }
+            FieldView stField;
+            uint64_t unHash = FindField(vecFrame, m_stConfig.strShardKey, stField)
+                                  ? HashBytes(stField.pData, stField.unSize)
+                                  : HashBytes(reinterpret_cast<const uint8_t*>(&unSessionId),
+                                              sizeof(unSessionId));
+            return static_cast<std::size_t>(unHash % m_vecQueues.size());
+        }
+
+        /******************************************************************************
+         * @brief   過負荷エラーフレームの取得
+         * @arg     unRequestId (in) 要求 ID
+         * @return  エラーフレーム
+         * @note    要求 ID が 0 なら事前エンコード済みのフレームを共有し、
+         *          それ以外はバイト列を複製して "$rid" の値だけを書き換える（再エンコードしない）
+         *****************************************************************************/
+        SharedFrame cMakeOverloaded(uint64_t unRequestId) const {
+            if (unRequestId == 0) {
+                return m_cOverloadedFrame;
+            }
+            std::vector<uint8_t> vecFrame(m_cOverloadedFrame.Bytes());
+            uint64_t unNetValue = htonll(unRequestId);
+            std::memcpy(vecFrame.data() + m_unRequestIdOffset, &unNetValue, sizeof(unNetValue));
+            return SharedFrame(std::move(vecFrame));
+        }
+
+        /******************************************************************************
+         * @brief   保留中の接続をすべて受け付けてワーカーへ割り振る
+         * @arg     なし
+         * @return  なし
+         * @note    ワーカー 0 のループスレッドで実行される
+         *****************************************************************************/
+        void vAcceptPending() {
+            std::vector<Socket> vecAccepted;
+            try {
+                m_cListener.AcceptMany(vecAccepted);
+            }
+            catch (const std::exception&) {
+                // 受け入れ済みの分は割り振る
+            }
+            for (Socket& cAccepted : vecAccepted) {
+                std::shared_ptr<Socket> spSocket = std::make_shared<Socket>(std::move(cAccepted));
+                Worker& cTarget = *m_vecWorkers[m_unNextWorker];
+                m_unNextWorker = (m_unNextWorker + 1) % m_vecWorkers.size();
+                cTarget.m_cLoop.Post([&cTarget, spSocket]() { cTarget.Attach(spSocket); });
+            }
+        }
+
+    private:
+        ServerConfig                               m_stConfig;
+        ShardedHandler                             m_fnHandler;
+        bool                                       m_bRunning;
+        Socket                                     m_cListener;
+        std::vector<std::unique_ptr<Worker>>       m_vecWorkers;
+        std::vector<std::thread>                   m_vecThreads;
+        std::size_t                                m_unNextWorker;
+        std::vector<std::unique_ptr<RequestQueue>> m_vecQueues;           // シャード分割時はハンドラースレッドごと
+        SharedFrame                                m_cOverloadedFrame;    // {"$rid": 0, "$error": "overloaded"}
+        std::size_t                                m_unRequestIdOffset;   // "$rid" の値の位置
+        std::atomic<uint64_t>                      m_unHandled;
+    };
+
+} // namespace sbdp
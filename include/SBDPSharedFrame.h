@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPSharedFrame.h
+ * @brief   SimpleBinaryDictionaryProtocol Shared Frame
+ * @author  Satoh
+ * @note    エンコード済みフレームを不変・参照カウント付きで共有する
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "SBDP.h"
+
+namespace sbdp {
+
+    // 不変・参照カウント付きエンコード済みフレーム（コピーは参照の共有のみ）
+    class SharedFrame {
+    public:
+        SharedFrame() = default;
+
+        /******************************************************************************
+         * @brief   エンコード済みバイト列からフレームを生成
+         * @arg     vecFrame (in) エンコード済みフレーム（ヘッダ含む）
+         * @return  なし
+         * @note    バッファの所有権を引き取る（コピーしない）
+         *****************************************************************************/
+        explicit SharedFrame(std::vector<uint8_t>&& vecFrame)
+            : m_spFrame(std::make_shared<const std::vector<uint8_t>>(
+                  std::move(vecFrame))) { }
+
+        /******************************************************************************
+         * @brief   メッセージを一度だけエンコードして共有フレームを生成
+         * @arg     msgData (in) エンコードするメッセージ
+         * @return  共有フレーム
+         * @note    同一メッセージを多数の接続へ送る場合に使用する
+         *****************************************************************************/
+        static SharedFrame Encode(const Message& msgData) {
+            return SharedFrame(EncodeMessage(msgData));
+        }
+
+        /******************************************************************************
+         * @brief   フレーム先頭へのポインタ取得
+         * @arg     なし
+         * @return  フレーム先頭（空の場合 nullptr）
+         * @note
+         *****************************************************************************/
+        const uint8_t* Data() const {
+            return m_spFrame ? m_spFrame->data() : nullptr;
+        }
+
+        /******************************************************************************
+         * @brief   フレーム長の取得
+         * @arg     なし
+         * @return  フレーム長（ヘッダ含む）
+         * @note
+         *****************************************************************************/
+        std::size_t Size() const {
+            return m_spFrame ? m_spFrame->size() : 0;
+        }
+
+        /******************************************************************************
+         * @brief   空フレーム判定
+         * @arg     なし
+         * @return  結果 true:空 false:データあり
+         * @note
+         *****************************************************************************/
+        bool IsEmpty() const {
+            return Size() == 0;
+        }
+
+        /******************************************************************************
+         * @brief   フレームを参照している数の取得
+         * @arg     なし
+         * @return  参照数
+         * @note    送信キューに残っている接続数の目安として使用できる
+         *****************************************************************************/
+        std::size_t UseCount() const {
+            return static_cast<std::size_t>(m_spFrame.use_count());
+        }
+
+        /******************************************************************************
+         * @brief   フレームのバイト列参照の取得
+         * @arg     なし
+         * @return  エンコード済みバイト列
+         * @note    空フレームに対して呼び出してはならない
+         *****************************************************************************/
+        const std::vector<uint8_t>& Bytes() const {
+            if (!m_spFrame) {
+                throw std::logic_error("SharedFrame is empty");
+            }
+            return *m_spFrame;
+        }
+
+    private:
+        std::shared_ptr<const std::vector<uint8_t>> m_spFrame;
+    };
+
+} // namespace sbdp
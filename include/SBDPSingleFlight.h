@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPSingleFlight.h
+ * @brief   SimpleBinaryDictionaryProtocol Single-flight Request Coalescing
+ * @author  Satoh
+ * @note    同時に発行された同一内容の要求を 1 件にまとめて送り、
+ *          デコード済みの応答を待っている全スレッドへ配る。
+ *          同一性はエンコード結果（キー順に整列済み）のバイト列で判定する
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SBDP.h"
+#include "SBDPHash.h"
+
+namespace sbdp {
+
+    // 実際に要求を送る関数（複数スレッドから同時に呼ばれる）
+    using RequestFunction = std::function<bool(const Message& msgRequest, Message& msgResponse)>;
+
+    // 統計
+    struct SingleFlightStats {
+        uint64_t unCalls      = 0;  // Call の呼び出し数
+        uint64_t unExecutions = 0;  // 実際に要求を送った数
+        uint64_t unCoalesced  = 0;  // 送信中の同一要求の応答を待った数
+        uint64_t unCollisions = 0;  // ハッシュが一致したが内容が異なった数
+    };
+
+    // 同一要求の集約（スレッドセーフ）
+    class SingleFlight {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     fnRequest (in) 実際に要求を送る関数（スレッドセーフであること）
+         * @return  なし
+         * @note    要求 ID など呼び出しごとに変わる値は fnRequest の中で付与すること
+         *          （付与後のバイト列では同一要求にならないため）
+         *****************************************************************************/
+        explicit SingleFlight(RequestFunction fnRequest)
+            : m_fnRequest(std::move(fnRequest)), m_unCalls(0), m_unExecutions(0),
+              m_unCoalesced(0), m_unCollisions(0) { }
+
+        SingleFlight(const SingleFlight&) = delete;
+        SingleFlight& operator=(const SingleFlight&) = delete;
+
+        /******************************************************************************
+         * @brief   要求の送信（同一要求の送信中はその応答を待つ）
+         * @arg     msgRequest (in) 要求
+         * @return  応答（共有、失敗時は nullptr）
+         * @note    応答は待っていた全スレッドで同じものを共有する（コピーしない）。
+         *          fnRequest が例外を送出した場合は、待っていた全スレッドへ同じ例外を送出する
+         *****************************************************************************/
+        std::shared_ptr<const Message> CallShared(const Message& msgRequest) {
+            m_unCalls.fetch_add(1, std::memory_order_relaxed);
+            std::vector<uint8_t> vecKey = EncodeMessage(msgRequest);
+            const uint64_t unHash = HashBytes(vecKey.data(), vecKey.size());
+
+            std::shared_ptr<Flight> spFlight;
+            {
+                std::unique_lock<std::mutex> lock(m_mtxFlights);
+                auto itFlight = m_mapFlights.find(unHash);
+                if (itFlight != m_mapFlights.end()) {
+                    if (itFlight->second->vecKey == vecKey) {
+                        spFlight = itFlight->second;
+                        m_unCoalesced.fetch_add(1, std::memory_order_relaxed);
+                        spFlight->cvDone.wait(lock, [&spFlight]() { return spFlight->bDone; });
+                        if (spFlight->pException) {
+                            std::rethrow_exception(spFlight->pException);
+                        }
+                        return spFlight->spResponse;
+                    }
+                    // 内容の異なる要求がハッシュ衝突した場合は集約せずに送る
+                    m_unCollisions.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    spFlight = std::make_shared<Flight>();
+                    spFlight->vecKey = std::move(vecKey);
+                    m_mapFlights.emplace(unHash, spFlight);
+                }
+            }
+
+            std::shared_ptr<const Message> spResponse;
+            std::exception_ptr pException;
+            try {
+                spResponse = spExecute(msgRequest);
+            }
+            catch (...) {
+                pException = std::current_exception();
+            }
+            if (spFlight) {
+                std::lock_guard<std::mutex> lock(m_mtxFlights);
+                m_mapFlights.erase(unHash);
+                spFlight->spResponse = spResponse;
+                spFlight->pException = pException;
+                spFlight->bDone = true;
+                spFlight->cvDone.notify_all();
+            }
+            if (pException) {
+                std::rethrow_exception(pException);
+            }
+            return spResponse;
+        }
+
+        /******************************************************************************
+         * @brief   要求の送信（同一要求の送信中はその応答を待つ）
+         * @arg     msgRequest  (in)  要求
+         * @arg     msgResponse (out) 応答
+         * @return  結果 true:正常 false:異常（fnRequest が失敗した）
+         * @note    CallShared の応答をコピーして返す
+         *****************************************************************************/
+        bool Call(const Message& msgRequest, Message& msgResponse) {
+            std::shared_ptr<const Message> spResponse = CallShared(msgRequest);
+            if (!spResponse) {
+                return false;
+            }
+            msgResponse = *spResponse;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   送信中の要求数の取得
+         * @arg     なし
+         * @return  要求数（内容の異なる要求の数）
+         * @note
+         *****************************************************************************/
+        std::size_t GetInFlight() const {
+            std::lock_guard<std::mutex> lock(m_mtxFlights);
+            return m_mapFlights.size();
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        SingleFlightStats GetStats() const {
+            SingleFlightStats stStats;
+            stStats.unCalls = m_unCalls.load(std::memory_order_relaxed);
+            stStats.unExecutions = m_unExecutions.load(std::memory_order_relaxed);
+            stStats.unCoalesced = m_unCoalesced.load(std::memory_order_relaxed);
+            stStats.unCollisions = m_unCollisions.load(std::memory_order_relaxed);
+            return stStats;
+        }
+
+    private:
+        // 送信中の要求
+        struct Flight {
+            std::vector<uint8_t>           vecKey;      // エンコード済みの要求（衝突判定用）
+            std::shared_ptr<const Message> spResponse;
+            std::exception_ptr             pException;
+            bool                           bDone = false;
+            std::condition_variable        cvDone;
+        };
+
+        /******************************************************************************
+         * @brief   要求を実際に送る
+         * @arg     msgRequest (in) 要求
+         * @return  応答（失敗時は nullptr）
+         * @note
+         *****************************************************************************/
+        std::shared_ptr<const Message> spExecute(const Message& msgRequest) {
+            m_unExecutions.fetch_add(1, std::memory_order_relaxed);
+            auto spResponse = std::make_shared<Message>();
+            if (!m_fnRequest(msgRequest, *spResponse)) {
+                return nullptr;
+            }
+            return spResponse;
+        }
+
+        RequestFunction                                      m_fnRequest;
+        mutable std::mutex                                   m_mtxFlights;
+        std::unordered_map<uint64_t, std::shared_ptr<Flight>> m_mapFlights;
+        std::atomic<uint64_t>                                m_unCalls;
+        std::atomic<uint64_t>                                m_unExecutions;
+        std::atomic<uint64_t>                                m_unCoalesced;
+        std::atomic<uint64_t>                                m_unCollisions;
+    };
+
+} // namespace sbdp
@@ -16,6 +16,13 @@
 #include <system_error>
 #include <cerrno>
 #include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
 
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
@@ -29,14 +36,170 @@
     #include <arpa/inet.h>
     #include <unistd.h>
     #include <netdb.h>
+    #include <fcntl.h>
+    #include <sys/uio.h>
+    #include <netinet/tcp.h>
+    #include <poll.h>
+    #ifdef __linux__
+        #include <linux/errqueue.h>
+    #endif
     typedef int SOCKET;
     #define INVALID_SOCKET (-1)
     #define SOCKET_ERROR (-1)
 #endif
 #include "SBDP.h"
+#include "SBDPSharedFrame.h"
+#include "SBDPSendQueue.h"
+#include "SBDPFrameReader.h"
+#include "SBDPSocketOptions.h"
+#include "SBDPThread.h"
+#include "SBDPZeroCopy.h"
 
 namespace sbdp {
 
+#if defined(MSG_NOSIGNAL)
+    constexpr int k_snSendNoSignal = MSG_NOSIGNAL;
+#else
+    constexpr int k_snSendNoSignal = 0;
+#endif
+    // 1 回の送信システムコールでまとめるバッファ数の上限
+    constexpr std::size_t k_unMaxGatherBuffers = 64;
+#if defined(MSG_DONTWAIT)
+    constexpr int k_snRecvDontWait = MSG_DONTWAIT;
+#else
+    constexpr int k_snRecvDontWait = 0;
+#endif
+    // ノンブロッキング受信 1 回あたりの読み込みサイズと 1 呼び出しあたりの上限回数
+    constexpr std::size_t k_unReceiveChunkSize = 64 * 1024;
+    constexpr std::size_t k_unMaxReceiveRounds = 4;
+
+#if defined(MSG_MORE)
+    constexpr int k_snSendMore = MSG_MORE;
+#else
+    constexpr int k_snSendMore = 0;
+#endif
+    // 環境依存のソケットオプション名（-1:未対応）
+#if defined(TCP_QUICKACK)
+    constexpr int k_snOptionQuickAck = TCP_QUICKACK;
+#else
+    constexpr int k_snOptionQuickAck = -1;
+#endif
+#if defined(SO_BUSY_POLL)
+    constexpr int k_snOptionBusyPoll = SO_BUSY_POLL;
+#else
+    constexpr int k_snOptionBusyPoll = -1;
+#endif
+#if defined(TCP_USER_TIMEOUT)
+    constexpr int k_snOptionUserTimeout = TCP_USER_TIMEOUT;
+#else
+    constexpr int k_snOptionUserTimeout = -1;
+#endif
+#if defined(SO_REUSEPORT)
+    constexpr int k_snOptionReusePort = SO_REUSEPORT;
+#else
+    constexpr int k_snOptionReusePort = -1;
+#endif
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    constexpr int k_snOptionKeepIdle     = TCP_KEEPIDLE;
+    constexpr int k_snOptionKeepInterval = TCP_KEEPINTVL;
+    constexpr int k_snOptionKeepCount    = TCP_KEEPCNT;
+#else
+    constexpr int k_snOptionKeepIdle     = -1;
+    constexpr int k_snOptionKeepInterval = -1;
+    constexpr int k_snOptionKeepCount    = -1;
+#endif
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    #define SBDP_HAS_ZEROCOPY 1
+    constexpr int k_snSendZeroCopy   = MSG_ZEROCOPY;
+    constexpr int k_snOptionZeroCopy = SO_ZEROCOPY;
+#else
+    constexpr int k_snSendZeroCopy   = 0;
+    constexpr int k_snOptionZeroCopy = -1;
+#endif
+    // クローズ後に未完了のゼロコピー送信の完了通知を待つ時間の上限（超えたら RST で切断する）
+    constexpr uint64_t k_unZeroCopyReapTimeoutMs = 30000;
+    // 完了待ちのソケットを見回る間隔
+    constexpr uint64_t k_unZeroCopyReapPollMs    = 10;
+
+#if defined(MSG_FASTOPEN)
+    constexpr int k_snSendFastOpen = MSG_FASTOPEN;
+#else
+    constexpr int k_snSendFastOpen = 0;
+#endif
+#if defined(TCP_FASTOPEN)
+    constexpr int k_snOptionFastOpen = TCP_FASTOPEN;
+#else
+    constexpr int k_snOptionFastOpen = -1;
+#endif
+
+    // バッファリング送信の既定フラッシュ閾値（バイト）
+    constexpr std::size_t k_unDefaultFlushThreshold = 16 * 1024;
+
+    // 送信キューのフラッシュ結果
+    enum class FlushResult : uint8_t {
+        Ok = 0,         // 送信キューが空になった
+        WouldBlock,     // ソケットバッファが満杯のため未送信データが残った
+    };
+
+    // 送信キュー上限超過時の動作
+    enum class OverflowPolicy : uint8_t {
+        Block = 0,      // 上限を下回るまで送信しながら待つ（ループスレッドでは使わないこと）
+        DropNewest,     // 追加しようとしたフレームを破棄する
+        DropOldest,     // 未送信のフレームを追加順の古いものから破棄して空きを作る（Urgent は除く）
+        Disconnect,     // ソケットをシャットダウンする
+    };
+
+    // 送信キューの上限（バイト単位のウォーターマーク）
+    struct SendQueueLimits {
+        size_t         unHighWatermark = 0;     // これを超える追加で ePolicy を適用（0:無制限）
+        size_t         unLowWatermark  = 0;     // 超過後、ここまで減ったら書き込み可能を通知
+        OverflowPolicy ePolicy         = OverflowPolicy::Block;
+        uint64_t       unBlockTimeoutMs = 0;    // Block の最大待ち時間（0:無期限）
+        size_t         unMaxOvertakes  = k_unDefaultMaxOvertakes;  // 低優先度フレームが追い越される最大回数
+    };
+
+    // 送信キューへの追加結果
+    enum class EnqueueResult : uint8_t {
+        Queued = 0,     // 追加した（DropOldest で古いフレームを破棄した場合を含む）
+        Dropped,        // DropNewest により破棄した
+        Disconnected,   // Disconnect によりシャットダウンした
+    };
+
+    // ソケット統計
+    struct SocketStats {
+        uint64_t unFramesQueued     = 0;    // 送信キューへ追加したフレーム数
+        uint64_t unBytesSent        = 0;    // 送信キューから送信したバイト数
+        uint64_t unFramesDropped    = 0;    // 上限超過で破棄したフレーム数
+        uint64_t unBytesDropped     = 0;    // 上限超過で破棄したバイト数
+        uint64_t unOverflows        = 0;    // 上限超過の発生回数
+        uint64_t unWritableEvents   = 0;    // 書き込み可能の通知回数
+        uint64_t unAcceptsShed      = 0;    // fd 枯渇時に受け付けて即切断した接続数
+        size_t   unPendingBytes     = 0;    // 現在の未送信バイト数
+        size_t   unPeakPendingBytes = 0;    // 未送信バイト数の最大値
+    };
+
+    // ソケットのアドレスファミリー
+    enum class AddressFamily : uint8_t {
+        IPv4 = 0,       // AF_INET
+        IPv6,           // AF_INET6（IPV6_V6ONLY=1）
+        DualStack,      // AF_INET6（IPV6_V6ONLY=0、IPv4 は ::ffff:a.b.c.d として扱う）
+    };
+
+    // 接続のタイムアウトと並列試行の設定
+    struct ConnectOptions {
+        uint64_t    unTimeoutMs      = 0;       // 接続全体のタイムアウト（0:無期限）
+        uint64_t    unAttemptDelayMs = 250;     // 前の試行が終わらないうちに次のアドレスを試すまでの間隔
+        bool        bFastOpen        = false;   // TCP Fast Open で cFirstFrame を SYN に載せる
+        SharedFrame cFirstFrame;                // 接続直後に送るフレーム（空:なし）
+    };
+
+    // ノンブロッキング受信結果
+    enum class ReceiveResult : uint8_t {
+        Ok = 0,         // 受信可能なデータを読み終えた
+        Closed,         // 相手が接続を閉じた
+    };
+
     /******************************************************************************
      * @brief   ソケット初期化
      * @arg     なし
@@ -64,61 +227,165 @@ namespace sbdp {
     #endif
     }
 
+    class ZeroCopyReaper;
+
     // Socket クラス（コピー禁止、ムーブ可能）
     class Socket {
+        friend class ZeroCopyReaper;
+
     public:
         // コンストラクタ・デストラクタ
-        Socket() : m_hSocket(INVALID_SOCKET), m_bShutdown(false){ }
+        Socket()
+            : m_hSocket(INVALID_SOCKET), m_bShutdown(false), m_bNonBlocking(false),
+              m_cSendQueue(), m_cFrameReader(), m_vecOutput(), m_unFlushThreshold(0),
+              m_stOptions(), m_unSpinBudgetUs(0), m_unRcvLowatCap(0), m_unRcvLowat(1),
+              m_unZeroCopyThreshold(0), m_cZeroCopy(), m_stLimits(),
+              m_bAboveHighWatermark(false), m_fnWritable(), m_stStats(), m_hReserveFd(-1),
+              m_eFamily(AddressFamily::IPv4) { }
         ~Socket() { Close(); }
 
         Socket(const Socket&) = delete;
         Socket& operator=(const Socket&) = delete;
 
-        Socket(Socket&& other) noexcept : m_hSocket(other.m_hSocket) {
+        Socket(Socket&& other) noexcept
+            : m_hSocket(other.m_hSocket),
+              m_bShutdown(other.m_bShutdown.load()),
+              m_bNonBlocking(other.m_bNonBlocking),
+              m_cSendQueue(std::move(other.m_cSendQueue)),
+              m_cFrameReader(std::move(other.m_cFrameReader)),
+              m_vecOutput(std::move(other.m_vecOutput)),
+              m_unFlushThreshold(other.m_unFlushThreshold),
+              m_stOptions(other.m_stOptions),
+              m_unSpinBudgetUs(other.m_unSpinBudgetUs),
+              m_unRcvLowatCap(other.m_unRcvLowatCap),
+              m_unRcvLowat(other.m_unRcvLowat),
+              m_unZeroCopyThreshold(other.m_unZeroCopyThreshold),
+              m_cZeroCopy(std::move(other.m_cZeroCopy)),
+              m_stLimits(other.m_stLimits),
+              m_bAboveHighWatermark(other.m_bAboveHighWatermark),
+              m_fnWritable(std::move(other.m_fnWritable)),
+              m_stStats(other.m_stStats),
+              m_hReserveFd(other.m_hReserveFd),
+              m_eFamily(other.m_eFamily) {
             other.m_hSocket = INVALID_SOCKET;
+            other.m_hReserveFd = -1;
         }
         Socket& operator=(Socket&& other) noexcept {
             if (this != &other) {
                 Close();
                 m_hSocket = other.m_hSocket;
+                m_bShutdown.store(other.m_bShutdown.load());
+                m_bNonBlocking = other.m_bNonBlocking;
+                m_cSendQueue = std::move(other.m_cSendQueue);
+                m_cFrameReader = std::move(other.m_cFrameReader);
+                m_vecOutput = std::move(other.m_vecOutput);
+                m_unFlushThreshold = other.m_unFlushThreshold;
+                m_stOptions = other.m_stOptions;
+                m_unSpinBudgetUs = other.m_unSpinBudgetUs;
+                m_unRcvLowatCap = other.m_unRcvLowatCap;
+                m_unRcvLowat = other.m_unRcvLowat;
+                m_unZeroCopyThreshold = other.m_unZeroCopyThreshold;
+                m_cZeroCopy = std::move(other.m_cZeroCopy);
+                m_stLimits = other.m_stLimits;
+                m_bAboveHighWatermark = other.m_bAboveHighWatermark;
+                m_fnWritable = std::move(other.m_fnWritable);
+                m_stStats = other.m_stStats;
+                m_hReserveFd = other.m_hReserveFd;
+                m_eFamily = other.m_eFamily;
                 other.m_hSocket = INVALID_SOCKET;
+                other.m_hReserveFd = -1;
             }
             return *this;
         }
 
         /******************************************************************************
-         * @brief   ソケット作成（AF_INET, SOCK_STREAM）
-         * @arg     なし
+         * @brief   ソケット作成（SOCK_STREAM）
+         * @arg     stOptions (in) ソケットオプション
+         * @arg     eFamily   (in) アドレスファミリー
          * @return  結果 true:正常 false:異常
-         * @note    
+         * @note    オプションは作成直後に適用し、Accept で受け入れたソケットと
+         *          Connect 成功後にも適用する。未対応・権限不足で適用できなかった
+         *          項目は無視されるため、実際の値は GetEffectiveOptions で確認すること。
+         *          DualStack のリスナーは 1 つのソケットで IPv4 / IPv6 の両方を受け入れる
          *****************************************************************************/
-        bool Create() {
-            m_hSocket = ::socket(AF_INET, SOCK_STREAM, 0);
-            return (m_hSocket != INVALID_SOCKET);
+        bool Create(const SocketOptions& stOptions = SocketOptions(),
+                    AddressFamily eFamily = AddressFamily::IPv4) {
+            m_hSocket = ::socket((eFamily == AddressFamily::IPv4) ? AF_INET : AF_INET6, SOCK_STREAM, 0);
+            if (m_hSocket == INVALID_SOCKET) {
+                return false;
+            }
+            m_eFamily = eFamily;
+            if (eFamily != AddressFamily::IPv4) {
+                // 既定値は OS（net.ipv6.bindv6only、Windows は常に 1）により異なるため明示する
+                int snV6Only = (eFamily == AddressFamily::IPv6) ? 1 : 0;
+                if (::setsockopt(m_hSocket, IPPROTO_IPV6, IPV6_V6ONLY,
+                                 reinterpret_cast<const char*>(&snV6Only), sizeof(snV6Only)) != 0) {
+                    Close();
+                    return false;
+                }
+            }
+            m_stOptions = stOptions;
+            bApplyOptions(m_stOptions);
+            return true;
         }
 
         /******************************************************************************
          * @brief   指定ポートでバインドする（サーバー用）
          * @arg     なし
          * @return  結果 true:正常 false:異常
-         * @note    
+         * @note    全アドレス（IPv4 は INADDR_ANY、IPv6 / DualStack は in6addr_any）で待ち受ける
          *****************************************************************************/
         bool Bind(unsigned short unPort) {
-            sockaddr_in stAddress;
+            sockaddr_storage stAddress;
             std::memset(&stAddress, 0, sizeof(stAddress));
-            stAddress.sin_family = AF_INET;
-            stAddress.sin_addr.s_addr = INADDR_ANY;
-            stAddress.sin_port = htons(unPort);
-            return (::bind(m_hSocket, reinterpret_cast<sockaddr*>(&stAddress), sizeof(stAddress)) != SOCKET_ERROR);
+            int snAddressLength = 0;
+            if (m_eFamily == AddressFamily::IPv4) {
+                sockaddr_in& stAddress4 = reinterpret_cast<sockaddr_in&>(stAddress);
+                stAddress4.sin_family = AF_INET;
+                stAddress4.sin_addr.s_addr = INADDR_ANY;
+                stAddress4.sin_port = htons(unPort);
+                snAddressLength = static_cast<int>(sizeof(sockaddr_in));
+            }
+            else {
+                sockaddr_in6& stAddress6 = reinterpret_cast<sockaddr_in6&>(stAddress);
+                stAddress6.sin6_family = AF_INET6;
+                stAddress6.sin6_addr = in6addr_any;
+                stAddress6.sin6_port = htons(unPort);
+                snAddressLength = static_cast<int>(sizeof(sockaddr_in6));
+            }
+            return (::bind(m_hSocket, reinterpret_cast<sockaddr*>(&stAddress), snAddressLength) != SOCKET_ERROR);
+        }
+
+        /******************************************************************************
+         * @brief   指定アドレス・ポートでバインドする（サーバー用）
+         * @arg     strAddress (in) 数値形式のアドレス（"127.0.0.1"、"::1" 等）
+         * @arg     unPort     (in) ポート
+         * @return  結果 true:正常 false:異常（ソケットのファミリーと合わないアドレスを含む）
+         * @note    DualStack のソケットには IPv4 アドレスを ::ffff:a.b.c.d としてバインドする
+         *****************************************************************************/
+        bool Bind(const std::string& strAddress, unsigned short unPort) {
+            addrinfo stHints {};
+            stHints.ai_flags = AI_PASSIVE | AI_NUMERICHOST;
+            vSetResolveHints(stHints);
+            addrinfo* pstResult = nullptr;
+            std::string strPort = std::to_string(unPort);
+            if (getaddrinfo(strAddress.c_str(), strPort.c_str(), &stHints, &pstResult) != 0) {
+                return false;
+            }
+            bool bBound = (::bind(m_hSocket, pstResult->ai_addr,
+                                  static_cast<int>(pstResult->ai_addrlen)) != SOCKET_ERROR);
+            freeaddrinfo(pstResult);
+            return bBound;
         }
 
         /******************************************************************************
          * @brief   待ち受け開始（サーバー用）
          * @arg     なし
          * @return  結果 true:正常 false:異常
-         * @note    
+         * @note    SocketOptions::snFastOpenQueue が設定されていれば TCP Fast Open を有効にする
          *****************************************************************************/
         bool Listen(int snBacklog = SOMAXCONN) {
+            bApplyOption(m_stOptions.snFastOpenQueue, IPPROTO_TCP, k_snOptionFastOpen);
             return (::listen(m_hSocket, snBacklog) != SOCKET_ERROR);
         }
 
@@ -130,7 +397,7 @@ namespace sbdp {
          *****************************************************************************/
         Socket Accept() {
             Socket cClientSocket;
-            sockaddr_in stClientAddress;
+            sockaddr_storage stClientAddress;
         #ifdef _WIN32
             int snAddressLength = sizeof(stClientAddress);
         #else
@@ -145,20 +412,68 @@ namespace sbdp {
                 }
                 throw std::runtime_error("Accept failed");
             }
+            cClientSocket.m_stOptions = m_stOptions;
+            cClientSocket.m_eFamily = m_eFamily;
+            cClientSocket.bApplyOptions(cClientSocket.m_stOptions);
             return cClientSocket;
         }
 
+        /******************************************************************************
+         * @brief   保留中の接続をまとめて受け入れる（サーバー用）
+         * @arg     vecAccepted (out) 受け入れたソケットの追加先（ノンブロッキング・CLOEXEC）
+         * @arg     unMax       (in)  1 回で受け入れる最大数
+         * @return  追加したソケット数
+         * @note    ノンブロッキングのリスナーで、イベントループの読み込みイベントから呼ぶ。
+         *          Linux では accept4(SOCK_NONBLOCK | SOCK_CLOEXEC) で追加のシステムコールを省く。
+         *          fd 枯渇（EMFILE / ENFILE）時は予備 fd を閉じて 1 件受け付けてすぐ閉じ、
+         *          接続がバックログに残ってリスナーが読み込み可能のまま空回りするのを防ぐ。
+         *          その他の受け入れエラーは std::system_error を送出する
+         *****************************************************************************/
+        size_t AcceptMany(std::vector<Socket>& vecAccepted, size_t unMax = 256) {
+            if (m_hReserveFd < 0) {
+                vOpenReserveFd();
+            }
+            size_t unAccepted = 0;
+            while (unAccepted < unMax) {
+                SOCKET hClient = hAcceptNonBlocking();
+                if (hClient == INVALID_SOCKET) {
+                    if (bIsWouldBlock()) {
+                        break;
+                    }
+                    if (bIsInterrupted() || bIsTransientAcceptError()) {
+                        continue;
+                    }
+                    if (bIsDescriptorExhausted()) {
+                        if (!bShedOneConnection()) {
+                            break;
+                        }
+                        continue;
+                    }
+                    vThrowSocketError("accept");
+                }
+                Socket cClientSocket;
+                cClientSocket.m_hSocket = hClient;
+                cClientSocket.m_bNonBlocking = true;
+                cClientSocket.m_stOptions = m_stOptions;
+                cClientSocket.m_eFamily = m_eFamily;
+                cClientSocket.bApplyOptions(cClientSocket.m_stOptions);
+                vecAccepted.push_back(std::move(cClientSocket));
+                ++unAccepted;
+            }
+            return unAccepted;
+        }
+
         /******************************************************************************
          * @brief   指定ホスト、ポートに接続（クライアント用）
          * @arg     host     (in)  接続先ホスト
          * @arg     port     (in)  接続先ポート
          * @return  クライアントソケット
-         * @note    
+         * @note    Create で指定したファミリーのアドレスへ接続する
+         *          （DualStack は IPv4 アドレスを ::ffff:a.b.c.d として解決する）
          *****************************************************************************/
         bool Connect(const std::string& strHost, unsigned short unPort) {
             addrinfo stHints {};
-            stHints.ai_family = AF_INET;        // IPv4
-            stHints.ai_socktype = SOCK_STREAM;  // TCP
+            vSetResolveHints(stHints);
 
             addrinfo* pstResult = nullptr;
             std::string strPort = std::to_string(unPort);
@@ -177,17 +492,55 @@ namespace sbdp {
             }
 
             freeaddrinfo(pstResult);
+            if (bConnected) {
+                // TCP_QUICKACK 等は接続状態の変化でリセットされるため接続後に再適用する
+                bApplyOptions(m_stOptions);
+            }
             return bConnected;
         }
 
+        /******************************************************************************
+         * @brief   タイムアウト・並列試行付きで接続（クライアント用）
+         * @arg     strHost   (in) 接続先ホスト
+         * @arg     unPort    (in) 接続先ポート
+         * @arg     stConnect (in) 接続設定
+         * @return  結果 true:正常 false:異常（タイムアウトを含む）
+         * @note    名前解決した各アドレスへ unAttemptDelayMs ずつずらしてノンブロッキングで
+         *          接続を開始し（Happy Eyeballs）、最初に確立した接続を採用して残りを閉じる。
+         *          試行が失敗した場合は間隔を待たずに次のアドレスを試す。
+         *          Create 済みのハンドルは採用した接続に置き換える（Create は省略してよい）。
+         *          未作成か DualStack なら IPv4 / IPv6 の両方を解決し、ファミリーを交互に試す。
+         *          bFastOpen では cFirstFrame を MSG_FASTOPEN で SYN に載せる。初回接続は
+         *          Cookie の取得のみでデータは確立後に送るため、効果は再接続時から。
+         *          SYN の再送や並列試行でサーバーが同じフレームを重複して受け取りうるため、
+         *          冪等な要求に限ること。サーバー側は SocketOptions::snFastOpenQueue を設定する。
+         *          cFirstFrame の送信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        bool Connect(const std::string& strHost, unsigned short unPort, const ConnectOptions& stConnect) {
+            const std::chrono::steady_clock::time_point tpBegin = std::chrono::steady_clock::now();
+            addrinfo* pstResult = pstResolveConnect(strHost, unPort);
+            if (pstResult == nullptr) {
+                return false;
+            }
+            size_t unWinnerSent = 0;
+            Socket cWinner = cRaceAttempts(vecInterleaveFamilies(pstResult), stConnect, tpBegin, unWinnerSent);
+            freeaddrinfo(pstResult);
+            if (cWinner.m_hSocket == INVALID_SOCKET) {
+                return false;
+            }
+            vAdoptConnection(cWinner, stConnect.cFirstFrame, unWinnerSent);
+            return true;
+        }
+
         /******************************************************************************
          * @brief   接続先アドレス文字列の取得
          * @arg     なし
          * @return  接続先アドレス文字列
-         * @note    
+         * @note    IPv4 / IPv6 の両方に対応する。DualStack で受け入れた IPv4 接続の
+         *          ::ffff:a.b.c.d は a.b.c.d として返す
          *****************************************************************************/
         std::string GetPeerAddress() const {
-            sockaddr_in stAddress;
+            sockaddr_storage stAddress;
         #ifdef _WIN32
             int snAddressLength = sizeof(stAddress);
         #else
@@ -205,7 +558,13 @@ namespace sbdp {
                             szHost, sizeof(szHost), nullptr, 0, NI_NUMERICHOST) != 0) {
                 return "[unknown]";
             }
-            return std::string(szHost);
+            std::string strHost(szHost);
+            const std::string strMappedPrefix = "::ffff:";
+            if (strHost.compare(0, strMappedPrefix.size(), strMappedPrefix) == 0 &&
+                strHost.find('.') != std::string::npos) {
+                strHost.erase(0, strMappedPrefix.size());
+            }
+            return strHost;
         }
 
         /******************************************************************************
@@ -213,10 +572,22 @@ namespace sbdp {
          * @arg     data    (out) 送信するデータ格納バッファ
          * @arg     len     (in)  送信するデータ長
          * @return  結果 true:正常 false:異常
-         * @note    
+         * @note    バッファリング送信中は出力バッファへ追加し、閾値到達時にフラッシュする。
+         *          送信キューに未送信データがある場合やノンブロッキングソケットでは、
+         *          フレームの途中に割り込まないよう送信キューの末尾へ積んで送る
          *****************************************************************************/
         bool SendAll(const uint8_t* pData, size_t unLength) {
-            return bSendAll(pData, unLength);
+            if (m_unFlushThreshold == 0) {
+                if (!bMustQueue()) {
+                    return bSendAll(pData, unLength);
+                }
+                return bQueueAndFlush(SharedFrame(std::vector<uint8_t>(pData, pData + unLength)));
+            }
+            m_vecOutput.insert(m_vecOutput.end(), pData, pData + unLength);
+            if (m_vecOutput.size() >= m_unFlushThreshold) {
+                Flush();
+            }
+            return true;
         }
 
         /******************************************************************************
@@ -226,8 +597,12 @@ namespace sbdp {
          * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒)
          * @return  結果 true:正常 false:異常
          * @note    unTimeoutMsを0にした場合、タイムアウトなしになります
+         *          SetBusyPoll でスピン予算を設定している場合はビジーポーリングで受信する
          *****************************************************************************/
         bool RecvAll(uint8_t* pBuffer, size_t unLength, uint64_t unTimeoutMs) {
+            if (m_unSpinBudgetUs != 0) {
+                return bRecvAllBusyPoll(pBuffer, unLength, unTimeoutMs);
+            }
             if (unTimeoutMs == 0) {
                 return bRecvAll(pBuffer, unLength);
             }
@@ -245,6 +620,19 @@ namespace sbdp {
             return SendAll(vecData.data(), vecData.size());
         }
 
+        /******************************************************************************
+         * @brief   SBDP プロトコルメッセージを優先度付きで送信
+         * @arg     msgData   (in) 送信するメッセージ
+         * @arg     ePriority (in) 送信優先度
+         * @return  送信結果 true:正常 false:異常（上限超過で破棄・切断した）
+         * @note    送信キューへ優先度に応じて挿入し、Flush で送出する。
+         *          キューに溜まった低優先度のフレームより先に、送信途中のフレームの
+         *          直後で送られる。ノンブロッキングソケットでは残りは FlushSendQueue で送ること
+         *****************************************************************************/
+        bool SendMessage(const Message& msgData, SendPriority ePriority) {
+            return bQueueAndFlush(SharedFrame::Encode(msgData), ePriority);
+        }
+
         /******************************************************************************
          * @brief   SBDP プロトコルメッセージ受信
          * @arg     unTimeoutMs (in) タイムアウト(ミリ秒)
@@ -252,6 +640,22 @@ namespace sbdp {
          * @note    
          *****************************************************************************/
         Message RecvMessage(uint64_t unTimeoutMs = 0) {
+            std::vector<uint8_t> vecBuffer;
+            RecvFrame(vecBuffer, unTimeoutMs);
+            return DecodeMessage(vecBuffer);
+        }
+
+        /******************************************************************************
+         * @brief   エンコード済みフレームのまま受信（デコードしない）
+         * @arg     vecFrame    (out) 受信フレーム（ヘッダ含む）
+         * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒)
+         * @return  結果 true:正常 false:異常
+         * @note    ReceiveAvailable でバッファ済みのデータがあればそれを先に使用する
+         *****************************************************************************/
+        bool RecvFrame(std::vector<uint8_t>& vecFrame, uint64_t unTimeoutMs = 0) {
+            if (m_cFrameReader.GetBufferedBytes() > 0) {
+                return bRecvBufferedFrame(vecFrame, unTimeoutMs);
+            }
             uint8_t unHeader[k_unHeaderSize];
             if (!RecvAll(unHeader, k_unHeaderSize, unTimeoutMs)) {
                 throw std::runtime_error("Header reception failed");
@@ -259,160 +663,1645 @@ namespace sbdp {
             uint32_t unNetPayloadLength;
             std::memcpy(&unNetPayloadLength, unHeader, k_unHeaderSize);
             uint32_t unPayloadLength = ntohl(unNetPayloadLength);
-            std::vector<uint8_t> vecBuffer(k_unHeaderSize + unPayloadLength);
-            std::memcpy(vecBuffer.data(), unHeader, k_unHeaderSize);
-            if (!RecvAll(vecBuffer.data() + k_unHeaderSize, unPayloadLength, unTimeoutMs)) {
+            vecFrame.resize(k_unHeaderSize + unPayloadLength);
+            std::memcpy(vecFrame.data(), unHeader, k_unHeaderSize);
+            if (!RecvAll(vecFrame.data() + k_unHeaderSize, unPayloadLength, unTimeoutMs)) {
                 throw std::runtime_error("Payload reception failed");
             }
-            return DecodeMessage(vecBuffer);
+            return true;
         }
 
         /******************************************************************************
-         * @brief   ソケットのクローズ
+         * @brief   受信可能なデータをノンブロッキングで受信バッファへ読み込む
          * @arg     なし
-         * @return  なし
-         * @note    
+         * @return  結果
+         * @retval  Ok=読み込み完了（データなしを含む）, Closed=相手が切断
+         * @note    イベント駆動での受信に使用する。完成したフレームは
+         *          PopFrame で取り出す。受信エラー時は std::system_error を送出する
          *****************************************************************************/
-        void Close() {
-            if (m_hSocket != INVALID_SOCKET) {
-            #ifdef _WIN32
-                ::closesocket(m_hSocket);
-            #else
-                ::close(m_hSocket);
-            #endif
-                m_hSocket = INVALID_SOCKET;
+        ReceiveResult ReceiveAvailable() {
+            for (size_t unRound = 0; unRound < k_unMaxReceiveRounds; ++unRound) {
+                size_t unChunkSize = k_unReceiveChunkSize;
+                if (m_unRcvLowatCap != 0) {
+                    // 受信中フレームの残りを、受信バッファに収まる範囲（上限の 2 倍）で 1 回で読む
+                    unChunkSize = std::max(unChunkSize, std::min(m_cFrameReader.GetMissingBytes(),
+                                                                 2 * m_unRcvLowatCap));
+                }
+                uint8_t* pBuffer = m_cFrameReader.PrepareWrite(unChunkSize);
+                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer),
+                                      static_cast<int>(unChunkSize), k_snRecvDontWait);
+                if (snReceived > 0) {
+                    m_cFrameReader.CommitWrite(static_cast<size_t>(snReceived));
+                    if (static_cast<size_t>(snReceived) < unChunkSize) {
+                        vUpdateRcvLowat();
+                        return ReceiveResult::Ok;
+                    }
+                    continue;
+                }
+                m_cFrameReader.CommitWrite(0);
+                if (snReceived == 0) {
+                    return ReceiveResult::Closed;
+                }
+                if (bIsWouldBlock()) {
+                    vUpdateRcvLowat();
+                    return ReceiveResult::Ok;
+                }
+                if (!bIsInterrupted()) {
+                    vThrowSocketError("recv");
+                }
             }
+            vUpdateRcvLowat();
+            return ReceiveResult::Ok;
         }
 
         /******************************************************************************
-         * @brief   ソケットのシャットダウン
-         * @arg     なし
-         * @return  なし
+         * @brief   受信バッファから完成したフレームを取り出す
+         * @arg     vecFrame (out) 取り出したフレーム（ヘッダ含む）
+         * @return  結果 true:取り出した false:完全なフレームなし
          * @note
          *****************************************************************************/
-        void Shutdown() {
-            if (m_hSocket != INVALID_SOCKET) {
-#ifdef _WIN32
-                ::shutdown(m_hSocket, SD_BOTH);
-#else
-                ::shutdown(m_hSocket, SHUT_RDWR);
-#endif
-				m_bShutdown.store(true);
+        bool PopFrame(std::vector<uint8_t>& vecFrame) {
+            if (!m_cFrameReader.PopFrame(vecFrame)) {
+                return false;
             }
+            vUpdateRcvLowat();
+            return true;
         }
 
-    private:
         /******************************************************************************
-         * @brief   ソケットエラーを例外として送出
-         * @arg     pszApiName (in) API名
-         * @return  なし
-         * @note    
+         * @brief   受信バッファに完成したフレームがあるか判定
+         * @arg     なし
+         * @return  結果 true:あり false:なし
+         * @note
          *****************************************************************************/
-        static void vThrowSocketError(const char* pszApiName) {
-#ifdef _WIN32
-            throw std::system_error(WSAGetLastError(), std::system_category(), pszApiName);
-#else
-            throw std::system_error(errno, std::system_category(), pszApiName);
-#endif
+        bool HasBufferedFrame() const {
+            return m_cFrameReader.HasFrame();
         }
 
         /******************************************************************************
-         * @brief   バッファ内の全データを送信（ブロッキング）
-         * @arg     pData    (in) 送信するデータ
-         * @arg     unLength (in) 送信するデータ長
-         * @return  結果 true:正常 false:異常
-         * @note    
+         * @brief   受信フレームの最大長を設定
+         * @arg     unMaxFrameSize (in) 最大フレーム長（0:無制限）
+         * @return  なし
+         * @note    ReceiveAvailable で超過ヘッダを受信すると std::runtime_error
          *****************************************************************************/
-        bool bSendAll(const uint8_t* pData, size_t unLength) {
-            size_t unTotalSent = 0;
-            while (unTotalSent < unLength) {
-                if (m_bShutdown.load()) {
-                    throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
-                }
+        void SetMaxFrameSize(size_t unMaxFrameSize) {
+            m_cFrameReader.SetMaxFrameSize(unMaxFrameSize);
+        }
 
-                int snSent = send(m_hSocket, reinterpret_cast<const char*>(pData + unTotalSent),
-                                  static_cast<int>(unLength - unTotalSent), 0);
-                if (snSent == SOCKET_ERROR || snSent <= 0) {
-                    vThrowSocketError("send");
+        /******************************************************************************
+         * @brief   エンコード済みフレームの送信（ブロッキング）
+         * @arg     cFrame (in) 送信するフレーム
+         * @return  送信結果 true:正常 false:異常
+         * @note    同一フレームを複数ソケットへ送る場合もエンコードは不要。
+         *          バッファリング中でも閾値以上のフレームはコピーせず参照で送る。
+         *          ゼロコピー送信の閾値以上のフレームは送信キュー経由で MSG_ZEROCOPY で送る
+         *****************************************************************************/
+        bool SendFrame(const SharedFrame& cFrame) {
+            if ((m_unFlushThreshold != 0 && cFrame.Size() >= m_unFlushThreshold) ||
+                (m_unZeroCopyThreshold != 0 && cFrame.Size() >= m_unZeroCopyThreshold) ||
+                (m_unFlushThreshold == 0 && bMustQueue())) {
+                if (eQueueOutput() != EnqueueResult::Queued) {
+                    return false;
                 }
-                unTotalSent += static_cast<size_t>(snSent);
+                return bQueueAndFlush(cFrame);
             }
-            return true;
+            return SendAll(cFrame.Data(), cFrame.Size());
         }
 
         /******************************************************************************
-         * @brief   指定バイト数を受信（ブロッキング）
-         * @arg     hSocket  (in)  受信に使用するソケット
-         * @arg     pBuffer  (out) 受信するデータ格納バッファ
-         * @arg     unLength (in)  受信するデータ長
-         * @return  結果 true:正常 false:異常
-         * @note    
+         * @brief   複数バッファをまとめて送信（ブロッキング）
+         * @arg     vecBuffers (in) 送信するバッファ群
+         * @return  送信結果 true:正常 false:異常
+         * @note    writev 相当のシステムコールで k_unMaxGatherBuffers 個ずつ送り、
+         *          部分送信時は続きを送る。送信エラー時は std::system_error を送出する
          *****************************************************************************/
-        bool bRecvAll(uint8_t* pBuffer, size_t unLength) {
-            size_t unTotalReceived = 0;
-            while (unTotalReceived < unLength) {
+        bool SendBuffers(std::vector<ConstBuffer> vecBuffers) {
+            while (!vecBuffers.empty()) {
                 if (m_bShutdown.load()) {
                     throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
                 }
-
-                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer + unTotalReceived),
-                                      static_cast<int>(unLength - unTotalReceived), 0);
-                if (snReceived <= 0) {
-                    vThrowSocketError("recv");
+                int64_t snSent = snSendGather(vecBuffers, true);
+                if (snSent < 0) {
+                    vWaitWritable();
+                    continue;
+                }
+                size_t unSent = static_cast<size_t>(snSent);
+                size_t unDone = 0;
+                while (unDone < vecBuffers.size() && unSent >= vecBuffers[unDone].unSize) {
+                    unSent -= vecBuffers[unDone].unSize;
+                    ++unDone;
+                }
+                vecBuffers.erase(vecBuffers.begin(), vecBuffers.begin() + static_cast<std::ptrdiff_t>(unDone));
+                if (!vecBuffers.empty()) {
+                    vecBuffers.front().pData += unSent;
+                    vecBuffers.front().unSize -= unSent;
                 }
-                unTotalReceived += static_cast<size_t>(snReceived);
             }
             return true;
         }
 
         /******************************************************************************
-         * @brief   タイムアウト付き指定バイト数を受信 （ミリ秒単位）
-         * @arg     pBuffer     (out) 受信するデータ格納バッファ
-         * @arg     unLength    (in)  受信するデータ長
-         * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒)
-         * @return  結果 true:正常 false:異常
-         * @note    
+         * @brief   エンコード済みフレームを送信キューへ追加
+         * @arg     cFrame    (in) 送信するフレーム
+         * @arg     ePriority (in) 送信優先度
+         * @return  結果
+         * @retval  Queued=追加した, Dropped=破棄した, Disconnected=シャットダウンした
+         * @note    送信は FlushSendQueue で行う。キューは参照のみ保持する。
+         *          優先度の高いフレームはフレーム境界で低いフレームを追い越す。
+         *          上限超過時は SetSendQueueLimits のポリシーに従う（Urgent は常に追加する）
          *****************************************************************************/
-        bool bRecvAllWithTimeout(uint8_t* pBuffer, size_t unLength, uint64_t unTimeoutMs) {
-            size_t unTotalReceived = 0;
-            while (unTotalReceived < unLength) {
-                fd_set stReadFds;
-                FD_ZERO(&stReadFds);
-                FD_SET(m_hSocket, &stReadFds);
+        EnqueueResult EnqueueFrame(const SharedFrame& cFrame, SendPriority ePriority = SendPriority::Normal) {
+            return ePushFrame(cFrame, ePriority);
+        }
 
-                struct timeval stTimeout {};
-                stTimeout.tv_sec = static_cast<long>(  unTimeoutMs / 1000);
-                stTimeout.tv_usec = static_cast<long>((unTimeoutMs % 1000) * 1000);
+        /******************************************************************************
+         * @brief   送信キューの上限の設定
+         * @arg     stLimits (in) 上限とポリシー
+         * @return  なし
+         * @note    低ウォーターマークが高ウォーターマークを超える場合は高ウォーターマークに揃える
+         *****************************************************************************/
+        void SetSendQueueLimits(const SendQueueLimits& stLimits) {
+            m_stLimits = stLimits;
+            m_stLimits.unLowWatermark = std::min(m_stLimits.unLowWatermark, m_stLimits.unHighWatermark);
+            m_cSendQueue.SetMaxOvertakes(m_stLimits.unMaxOvertakes);
+        }
 
-                int snSelectResult = select(static_cast<int>(m_hSocket) + 1,
-                                            &stReadFds, nullptr, nullptr, &stTimeout);
-                if (snSelectResult < 0) {
-                    vThrowSocketError("select");
+        /******************************************************************************
+         * @brief   書き込み可能通知ハンドラの設定
+         * @arg     fnWritable (in) ハンドラ
+         * @return  なし
+         * @note    高ウォーターマークに達した後、未送信バイト数が低ウォーターマーク以下に
+         *          なった時点で FlushSendQueue の中から 1 回呼び出される
+         *****************************************************************************/
+        void SetWritableHandler(std::function<void()> fnWritable) {
+            m_fnWritable = std::move(fnWritable);
+        }
+
+        /******************************************************************************
+         * @brief   送信キューに空きがあるか判定
+         * @arg     なし
+         * @return  結果 true:追加可能 false:高ウォーターマーク到達後、低ウォーターマークまで未回復
+         * @note    生産者側はこれが false の間は追加を控え、書き込み可能通知を待つ
+         *****************************************************************************/
+        bool IsWritable() const {
+            return !m_bAboveHighWatermark;
+        }
+
+        /******************************************************************************
+         * @brief   ソケット統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        SocketStats GetStats() const {
+            SocketStats stStats = m_stStats;
+            stStats.unPendingBytes = m_cSendQueue.GetPendingBytes();
+            return stStats;
+        }
+
+        /******************************************************************************
+         * @brief   送信キューをノンブロッキングで送出
+         * @arg     なし
+         * @return  結果
+         * @retval  Ok=キューが空になった, WouldBlock=未送信データが残った
+         * @note    複数フレームを writev 相当でまとめて送信する。
+         *          1 回の送信量がゼロコピー送信の閾値以上なら MSG_ZEROCOPY で送り、
+         *          含まれるフレームの参照を完了通知まで保持する。
+         *          Windows ではソケットをノンブロッキングに設定して使用すること。
+         *          送信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        FlushResult FlushSendQueue() {
+            if (m_unZeroCopyThreshold != 0) {
+                ProcessZeroCopyCompletions();
+            }
+            std::vector<ConstBuffer> vecBuffers;
+            std::vector<SharedFrame> vecFrames;
+            vecBuffers.reserve(k_unMaxGatherBuffers);
+            while (!m_cSendQueue.IsEmpty()) {
+                if (m_bShutdown.load()) {
+                    throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
                 }
-                if (snSelectResult == 0) {
-                    throw std::system_error( static_cast<int>(std::errc::timed_out), std::generic_category(), "select timeout");
+                m_cSendQueue.Gather(vecBuffers, k_unMaxGatherBuffers);
+                // 続きのフレームが確定している間は MSG_MORE で部分セグメントの送出を抑える
+                bool bMore = (m_cSendQueue.GetPendingFrames() > vecBuffers.size());
+                bool bZeroCopy = false;
+                if (m_unZeroCopyThreshold != 0) {
+                    size_t unGathered = 0;
+                    for (const ConstBuffer& stBuffer : vecBuffers) {
+                        unGathered += stBuffer.unSize;
+                    }
+                    bZeroCopy = (unGathered >= m_unZeroCopyThreshold);
                 }
-                if(m_bShutdown.load()) {
-                    throw std::system_error( static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
-				}
-                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer + unTotalReceived),
-                                      static_cast<int>(unLength - unTotalReceived), 0);
-                if (snReceived <= 0) {
-                    vThrowSocketError("recv");
+                int64_t snSent = snSendGather(vecBuffers, false, bMore, &bZeroCopy);
+                if (snSent < 0) {
+                    return FlushResult::WouldBlock;
                 }
-                unTotalReceived += static_cast<size_t>(snReceived);
+                if (bZeroCopy) {
+                    m_cSendQueue.CollectFrames(vecFrames, vecBuffers.size());
+                    m_cZeroCopy.Record(std::move(vecFrames));
+                    vecFrames = std::vector<SharedFrame>();
+                }
+                m_cSendQueue.Consume(static_cast<size_t>(snSent));
+                m_stStats.unBytesSent += static_cast<uint64_t>(snSent);
+                vCheckWritable();
             }
-            return true;
+            return FlushResult::Ok;
         }
-        
-    private:
-        SOCKET           m_hSocket;
-        std::atomic_bool m_bShutdown;
-    };
 
-    /******************************************************************************
-     * @brief   接続先アドレス文字列の取得
-     * @arg     socket (in) ソケット
+        /******************************************************************************
+         * @brief   ゼロコピー送信（MSG_ZEROCOPY）の設定
+         * @arg     unThreshold (in) ゼロコピーで送る 1 回の送信量の下限（バイト） 0:無効
+         * @return  結果 true:正常 false:異常（未対応環境を含む）
+         * @note    送信キュー経由の送信（SendFrame / EnqueueFrame + FlushSendQueue）が対象。
+         *          ページ固定と完了通知のコストがあるため、閾値は数百 KiB 程度が目安。
+         *          完了通知はソケットのエラーキューに届き、EPOLLERR として通知される。
+         *          イベントループでは EPOLLERR で ProcessZeroCopyCompletions を呼ぶこと
+         *****************************************************************************/
+        bool EnableZeroCopy(size_t unThreshold) {
+            if (unThreshold == 0) {
+                m_unZeroCopyThreshold = 0;
+                return true;
+            }
+            std::optional<bool> oEnable = true;
+            if (!bApplyOption(oEnable, SOL_SOCKET, k_snOptionZeroCopy)) {
+                return false;
+            }
+            m_unZeroCopyThreshold = unThreshold;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ゼロコピー送信の完了通知の処理
+         * @arg     なし
+         * @return  完了した送信数
+         * @note    エラーキューを読み切り、カーネルが使い終えた送信のフレーム参照を
+         *          解放する（ノンブロッキング）
+         *****************************************************************************/
+        size_t ProcessZeroCopyCompletions() {
+            size_t unCompleted = 0;
+        #ifdef SBDP_HAS_ZEROCOPY
+            for (;;) {
+                alignas(cmsghdr) char szControl[CMSG_SPACE(sizeof(sock_extended_err)) + 64];
+                msghdr stMsg {};
+                stMsg.msg_control = szControl;
+                stMsg.msg_controllen = sizeof(szControl);
+                if (::recvmsg(m_hSocket, &stMsg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                    if (bIsInterrupted()) {
+                        continue;
+                    }
+                    break;
+                }
+                for (cmsghdr* pstHeader = CMSG_FIRSTHDR(&stMsg); pstHeader != nullptr;
+                     pstHeader = CMSG_NXTHDR(&stMsg, pstHeader)) {
+                    bool bRecvErr = (pstHeader->cmsg_level == SOL_IP && pstHeader->cmsg_type == IP_RECVERR) ||
+                                    (pstHeader->cmsg_level == SOL_IPV6 && pstHeader->cmsg_type == IPV6_RECVERR);
+                    if (!bRecvErr) {
+                        continue;
+                    }
+                    sock_extended_err stError;
+                    std::memcpy(&stError, CMSG_DATA(pstHeader), sizeof(stError));
+                    if (stError.ee_errno != 0 || stError.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                        continue;
+                    }
+                    bool bCopied = ((stError.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+                    unCompleted += m_cZeroCopy.Complete(stError.ee_info, stError.ee_data, bCopied);
+                }
+            }
+        #endif
+            return unCompleted;
+        }
+
+        /******************************************************************************
+         * @brief   ゼロコピー送信の完了通知ハンドラの設定
+         * @arg     fnCompletion (in) ハンドラ（送信番号の範囲、コピーへのフォールバック有無）
+         * @return  なし
+         * @note    ProcessZeroCopyCompletions から、フレーム参照の解放後に呼び出される
+         *****************************************************************************/
+        void SetZeroCopyCompletionHandler(ZeroCopyTracker::CompletionHandler fnCompletion) {
+            m_cZeroCopy.SetCompletionHandler(std::move(fnCompletion));
+        }
+
+        /******************************************************************************
+         * @brief   完了待ちのゼロコピー送信数の取得
+         * @arg     なし
+         * @return  送信数
+         * @note    0 になるまでは送信したフレームの参照が保持される
+         *****************************************************************************/
+        size_t GetZeroCopyPendingSends() const {
+            return m_cZeroCopy.GetPendingSends();
+        }
+
+        /******************************************************************************
+         * @brief   ゼロコピー送信の統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note    unCopied が多い場合（ループバック等）はゼロコピーの効果がない
+         *****************************************************************************/
+        const ZeroCopyStats& GetZeroCopyStats() const {
+            return m_cZeroCopy.GetStats();
+        }
+
+        /******************************************************************************
+         * @brief   送信キューの未送信バイト数の取得
+         * @arg     なし
+         * @return  未送信バイト数
+         * @note
+         *****************************************************************************/
+        size_t GetPendingSendBytes() const {
+            return m_cSendQueue.GetPendingBytes();
+        }
+
+        /******************************************************************************
+         * @brief   ビジーポーリング受信モードの設定
+         * @arg     unSpinBudgetUs (in) データ待ち 1 回あたりのスピン時間(マイクロ秒) 0:無効
+         * @return  結果 true:SO_BUSY_POLL も設定できた false:スピンのみ（未対応・権限不足）
+         * @note    RecvAll / RecvFrame / RecvMessage がノンブロッキング recv を
+         *          スピン予算の間だけ繰り返し、尽きたら通常の待機へ戻る。
+         *          スピンは CPU を 1 コア占有するため、PinCurrentThread で受信スレッドを
+         *          専用コアへ固定して使うこと。
+         *          Windows ではソケットをノンブロッキングに設定して使用すること
+         *****************************************************************************/
+        bool SetBusyPoll(uint64_t unSpinBudgetUs) {
+            m_unSpinBudgetUs = unSpinBudgetUs;
+            if (unSpinBudgetUs == 0) {
+                return true;
+            }
+            std::optional<int32_t> oBusyPollUs = static_cast<int32_t>(
+                std::min<uint64_t>(unSpinBudgetUs, static_cast<uint64_t>(INT32_MAX)));
+            return bApplyOption(oBusyPollUs, SOL_SOCKET, k_snOptionBusyPoll);
+        }
+
+        /******************************************************************************
+         * @brief   受信中フレームに合わせた SO_RCVLOWAT 調整の設定
+         * @arg     unMaxLowat (in) SO_RCVLOWAT の上限（バイト） 0:無効
+         * @return  結果 true:正常 false:異常（SO_RCVLOWAT を変更できない環境を含む）
+         * @note    ReceiveAvailable / PopFrame の後、ヘッダ受信済みで未完成のフレームが
+         *          あれば SO_RCVLOWAT をその残りバイト数に設定し、フレーム全体が
+         *          読めるようになるまでイベントループを起こさないようにする。
+         *          それ以外は 1 に戻す。受信バッファに収まらない値では永久に
+         *          起床しないため、上限は SO_RCVBUF の半分でも制限する
+         *****************************************************************************/
+        bool SetAdaptiveRcvLowat(size_t unMaxLowat) {
+            if (unMaxLowat == 0) {
+                m_unRcvLowatCap = 0;
+                return bSetRcvLowat(1);
+            }
+            std::optional<int32_t> oRecvBuffer;
+            vReadOption(oRecvBuffer, SOL_SOCKET, SO_RCVBUF);
+            int32_t snRecvBuffer = oRecvBuffer.value_or(0);
+            if (snRecvBuffer <= 0) {
+                return false;
+            }
+            m_unRcvLowatCap = std::min(unMaxLowat, static_cast<size_t>(snRecvBuffer) / 2);
+            if (!bSetRcvLowat(1)) {
+                m_unRcvLowatCap = 0;
+                return false;
+            }
+            vUpdateRcvLowat();
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットオプションの設定
+         * @arg     stOptions (in) ソケットオプション
+         * @return  結果 true:全項目を適用した false:適用できない項目があった
+         * @note    以後の Accept / Connect でもこのオプションを適用する。
+         *          適用できない項目があっても残りの項目は適用する
+         *****************************************************************************/
+        bool SetOptions(const SocketOptions& stOptions) {
+            m_stOptions = stOptions;
+            return bApplyOptions(m_stOptions);
+        }
+
+        /******************************************************************************
+         * @brief   設定済みソケットオプションの取得
+         * @arg     なし
+         * @return  Create / SetOptions で指定したオプション
+         * @note    一部の項目だけ変更する場合は、取得した値を変更して SetOptions に渡す
+         *****************************************************************************/
+        const SocketOptions& GetOptions() const {
+            return m_stOptions;
+        }
+
+        /******************************************************************************
+         * @brief   カーネル上の実効オプション値の取得
+         * @arg     なし
+         * @return  オプション（取得できない項目は未設定）
+         * @note    Linux の SO_SNDBUF / SO_RCVBUF は管理領域を含む値
+         *          （指定値の 2 倍、上限は net.core.wmem_max / rmem_max）が返る
+         *****************************************************************************/
+        SocketOptions GetEffectiveOptions() const {
+            SocketOptions stOptions;
+            vReadOption(stOptions.bNoDelay, IPPROTO_TCP, TCP_NODELAY);
+            vReadOption(stOptions.bQuickAck, IPPROTO_TCP, k_snOptionQuickAck);
+            vReadOption(stOptions.bKeepAlive, SOL_SOCKET, SO_KEEPALIVE);
+            vReadOption(stOptions.snKeepIdleSec, IPPROTO_TCP, k_snOptionKeepIdle);
+            vReadOption(stOptions.snKeepIntervalSec, IPPROTO_TCP, k_snOptionKeepInterval);
+            vReadOption(stOptions.snKeepCount, IPPROTO_TCP, k_snOptionKeepCount);
+            vReadOption(stOptions.snSendBufferBytes, SOL_SOCKET, SO_SNDBUF);
+            vReadOption(stOptions.snRecvBufferBytes, SOL_SOCKET, SO_RCVBUF);
+            vReadOption(stOptions.snBusyPollUs, SOL_SOCKET, k_snOptionBusyPoll);
+            vReadOption(stOptions.snUserTimeoutMs, IPPROTO_TCP, k_snOptionUserTimeout);
+            vReadOption(stOptions.bReuseAddress, SOL_SOCKET, SO_REUSEADDR);
+            vReadOption(stOptions.bReusePort, SOL_SOCKET, k_snOptionReusePort);
+            vReadOption(stOptions.snFastOpenQueue, IPPROTO_TCP, k_snOptionFastOpen);
+            return stOptions;
+        }
+
+        /******************************************************************************
+         * @brief   バッファリング送信モードの設定
+         * @arg     unFlushThreshold (in) フラッシュ閾値（バイト） 0:バッファリングしない
+         * @return  なし
+         * @note    バッファリング中の SendMessage / SendFrame / SendAll は出力バッファへ
+         *          追加するだけで、閾値到達時・Flush 呼び出し時・EventLoop::ScheduleFlush
+         *          で登録したループ反復の終了時にまとめて送信する。
+         *          無効化時は残っている出力をフラッシュする
+         *****************************************************************************/
+        void SetBufferedSend(size_t unFlushThreshold) {
+            if (unFlushThreshold == 0 && m_unFlushThreshold != 0) {
+                Flush();
+            }
+            m_unFlushThreshold = unFlushThreshold;
+            if (m_unFlushThreshold != 0) {
+                m_vecOutput.reserve(m_unFlushThreshold);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   出力バッファの送出
+         * @arg     なし
+         * @return  結果
+         * @retval  Ok=送信し終えた, WouldBlock=ノンブロッキングソケットで未送信データが残った
+         * @note    出力バッファを 1 フレームとして送信キュー末尾へ移し、まとめて送る。
+         *          ブロッキングソケットでは全て送り終えるまで待つ。
+         *          送信エラー時、および上限超過で出力バッファを送信キューへ積めない場合は
+         *          std::system_error を送出する（出力バッファは破棄しない）
+         *****************************************************************************/
+        FlushResult Flush() {
+            EnqueueResult eQueued = eQueueOutput();
+            if (eQueued == EnqueueResult::Disconnected) {
+                throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
+            }
+            if (eQueued == EnqueueResult::Dropped) {
+                throw std::system_error(static_cast<int>(std::errc::no_buffer_space), std::generic_category(), "send queue full");
+            }
+            for (;;) {
+                FlushResult eResult = FlushSendQueue();
+                if (eResult == FlushResult::Ok || m_bNonBlocking) {
+                    return eResult;
+                }
+                vWaitWritable();
+            }
+        }
+
+        /******************************************************************************
+         * @brief   出力バッファの未送信バイト数の取得
+         * @arg     なし
+         * @return  バイト数（送信キューの分は含まない）
+         * @note
+         *****************************************************************************/
+        size_t GetBufferedSendBytes() const {
+            return m_vecOutput.size();
+        }
+
+        /******************************************************************************
+         * @brief   TCP_CORK の設定
+         * @arg     bCork (in) true:部分セグメントを送らず保留 false:解除して送出
+         * @return  結果 true:正常 false:異常（未対応環境を含む）
+         * @note    複数回の送信を 1 つのセグメント列にまとめたい場合に使用する。
+         *          解除するまで最大 200ms 送信が保留されるため、必ず対で呼ぶこと
+         *****************************************************************************/
+        bool SetCork(bool bCork) {
+        #if defined(TCP_CORK)
+            int snValue = bCork ? 1 : 0;
+            return (::setsockopt(m_hSocket, IPPROTO_TCP, TCP_CORK, &snValue, sizeof(snValue)) == 0);
+        #else
+            (void)bCork;
+            return false;
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   ノンブロッキングモードの設定
+         * @arg     bNonBlocking (in) true:ノンブロッキング false:ブロッキング
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool SetNonBlocking(bool bNonBlocking) {
+        #ifdef _WIN32
+            u_long unMode = bNonBlocking ? 1 : 0;
+            if (::ioctlsocket(m_hSocket, FIONBIO, &unMode) != 0) {
+                return false;
+            }
+        #else
+            int snFlags = ::fcntl(m_hSocket, F_GETFL, 0);
+            if (snFlags < 0) {
+                return false;
+            }
+            snFlags = bNonBlocking ? (snFlags | O_NONBLOCK) : (snFlags & ~O_NONBLOCK);
+            if (::fcntl(m_hSocket, F_SETFL, snFlags) != 0) {
+                return false;
+            }
+        #endif
+            m_bNonBlocking = bNonBlocking;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   アドレスファミリーの取得
+         * @arg     なし
+         * @return  アドレスファミリー（Connect で置き換えた接続はそのファミリー）
+         * @note
+         *****************************************************************************/
+        AddressFamily GetAddressFamily() const {
+            return m_eFamily;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットハンドルの取得
+         * @arg     なし
+         * @return  ソケットハンドル
+         * @note    イベントループへの登録等に使用する
+         *****************************************************************************/
+        SOCKET GetHandle() const {
+            return m_hSocket;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットのクローズ
+         * @arg     なし
+         * @return  なし
+         * @note    待たずに戻る。ゼロコピー送信が未完了の場合は、ハンドルと送信フレームを
+         *          ZeroCopyReaper へ引き渡し、完了通知が届いてから閉じて解放する
+         *****************************************************************************/
+        void Close() {
+            if (m_hSocket != INVALID_SOCKET && m_cZeroCopy.GetPendingSends() != 0) {
+                ProcessZeroCopyCompletions();
+            }
+            ZeroCopyTracker cPending = m_cZeroCopy.TakePending();
+            if (m_hSocket != INVALID_SOCKET && cPending.GetPendingSends() != 0) {
+                vHandOverZeroCopy(std::move(cPending));
+            }
+            if (m_hSocket != INVALID_SOCKET) {
+            #ifdef _WIN32
+                ::closesocket(m_hSocket);
+            #else
+                ::close(m_hSocket);
+            #endif
+                m_hSocket = INVALID_SOCKET;
+            }
+        #ifndef _WIN32
+            if (m_hReserveFd >= 0) {
+                ::close(m_hReserveFd);
+                m_hReserveFd = -1;
+            }
+        #endif
+            m_cSendQueue.Clear();
+            m_bAboveHighWatermark = false;
+            m_cFrameReader.Clear();
+            m_vecOutput.clear();
+        }
+
+        /******************************************************************************
+         * @brief   ソケットのシャットダウン
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void Shutdown() {
+            if (m_hSocket != INVALID_SOCKET) {
+#ifdef _WIN32
+                ::shutdown(m_hSocket, SD_BOTH);
+#else
+                ::shutdown(m_hSocket, SHUT_RDWR);
+#endif
+				m_bShutdown.store(true);
+            }
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   未完了のゼロコピー送信をハンドルごと ZeroCopyReaper へ引き渡す
+         * @arg     cPending (in) 完了待ちの送信
+         * @return  なし
+         * @note    ハンドルは無効になる。定義は ZeroCopyReaper の後
+         *****************************************************************************/
+        void vHandOverZeroCopy(ZeroCopyTracker&& cPending);
+
+        /******************************************************************************
+         * @brief   完了通知を待たずに RST で切断して閉じる
+         * @arg     なし
+         * @return  なし
+         * @note    SO_LINGER を 0 秒にして閉じると未送信データは破棄され、以後送出されないため、
+         *          完了待ちのフレームを解放する
+         *****************************************************************************/
+        void vAbortZeroCopy() {
+            linger stLinger {};
+            stLinger.l_onoff = 1;
+            stLinger.l_linger = 0;
+            ::setsockopt(m_hSocket, SOL_SOCKET, SO_LINGER, reinterpret_cast<const char*>(&stLinger), sizeof(stLinger));
+            m_cZeroCopy.TakePending();
+            Close();
+        }
+
+        /******************************************************************************
+         * @brief   ソケットエラーを例外として送出
+         * @arg     pszApiName (in) API名
+         * @return  なし
+         * @note    
+         *****************************************************************************/
+        static void vThrowSocketError(const char* pszApiName) {
+#ifdef _WIN32
+            throw std::system_error(WSAGetLastError(), std::system_category(), pszApiName);
+#else
+            throw std::system_error(errno, std::system_category(), pszApiName);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   バッファ内の全データを送信（ブロッキング）
+         * @arg     pData    (in) 送信するデータ
+         * @arg     unLength (in) 送信するデータ長
+         * @return  結果 true:正常 false:異常
+         * @note    
+         *****************************************************************************/
+        bool bSendAll(const uint8_t* pData, size_t unLength) {
+            size_t unTotalSent = 0;
+            while (unTotalSent < unLength) {
+                if (m_bShutdown.load()) {
+                    throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
+                }
+
+                int snSent = send(m_hSocket, reinterpret_cast<const char*>(pData + unTotalSent),
+                                  static_cast<int>(unLength - unTotalSent), 0);
+                if (snSent == SOCKET_ERROR || snSent <= 0) {
+                    vThrowSocketError("send");
+                }
+                unTotalSent += static_cast<size_t>(snSent);
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   直前のソケットエラーがブロッキング不可によるものか判定
+         * @arg     なし
+         * @return  結果 true:EWOULDBLOCK/EAGAIN false:その他
+         * @note
+         *****************************************************************************/
+        static bool bIsWouldBlock() {
+#ifdef _WIN32
+            return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+            return (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   直前のソケットエラーがシグナル割り込みによるものか判定
+         * @arg     なし
+         * @return  結果 true:EINTR false:その他
+         * @note
+         *****************************************************************************/
+        static bool bIsInterrupted() {
+#ifdef _WIN32
+            return (WSAGetLastError() == WSAEINTR);
+#else
+            return (errno == EINTR);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   受信バッファの残りを補ってフレームを受信
+         * @arg     vecFrame    (out) 受信フレーム（ヘッダ含む）
+         * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒)
+         * @return  結果 true:正常 false:異常
+         * @note    ブロッキングで不足分のみを受信する
+         *****************************************************************************/
+        bool bRecvBufferedFrame(std::vector<uint8_t>& vecFrame, uint64_t unTimeoutMs) {
+            while (!m_cFrameReader.HasFrame()) {
+                size_t unMissing = m_cFrameReader.GetMissingBytes();
+                uint8_t* pBuffer = m_cFrameReader.PrepareWrite(unMissing);
+                bool bReceived = false;
+                try {
+                    bReceived = RecvAll(pBuffer, unMissing, unTimeoutMs);
+                }
+                catch (...) {
+                    m_cFrameReader.CommitWrite(0);
+                    throw;
+                }
+                m_cFrameReader.CommitWrite(bReceived ? unMissing : 0);
+                if (!bReceived) {
+                    throw std::runtime_error("Frame reception failed");
+                }
+            }
+            return m_cFrameReader.PopFrame(vecFrame);
+        }
+
+        /******************************************************************************
+         * @brief   受信中フレームの残りに合わせて SO_RCVLOWAT を更新
+         * @arg     なし
+         * @return  なし
+         * @note    値が変わる場合のみ setsockopt を呼ぶ
+         *****************************************************************************/
+        void vUpdateRcvLowat() {
+            if (m_unRcvLowatCap == 0) {
+                return;
+            }
+            size_t unLowat = 1;
+            if (m_cFrameReader.GetBufferedBytes() >= k_unHeaderSize) {
+                unLowat = std::max<size_t>(1, std::min(m_cFrameReader.GetMissingBytes(), m_unRcvLowatCap));
+            }
+            if (unLowat != m_unRcvLowat) {
+                bSetRcvLowat(unLowat);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   SO_RCVLOWAT の設定
+         * @arg     unLowat (in) 起床に必要な受信済みバイト数
+         * @return  結果 true:正常 false:異常
+         * @note
+         *****************************************************************************/
+        bool bSetRcvLowat(size_t unLowat) {
+            std::optional<int32_t> oLowat = static_cast<int32_t>(unLowat);
+            if (!bApplyOption(oLowat, SOL_SOCKET, SO_RCVLOWAT)) {
+                return false;
+            }
+            m_unRcvLowat = unLowat;
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットオプションの適用
+         * @arg     stOptions (in) ソケットオプション
+         * @return  結果 true:全項目を適用した false:適用できない項目があった
+         * @note
+         *****************************************************************************/
+        bool bApplyOptions(const SocketOptions& stOptions) {
+            bool bResult = true;
+            bResult &= bApplyOption(stOptions.bReuseAddress, SOL_SOCKET, SO_REUSEADDR);
+            bResult &= bApplyOption(stOptions.bReusePort, SOL_SOCKET, k_snOptionReusePort);
+            bResult &= bApplyOption(stOptions.snSendBufferBytes, SOL_SOCKET, SO_SNDBUF);
+            bResult &= bApplyOption(stOptions.snRecvBufferBytes, SOL_SOCKET, SO_RCVBUF);
+            bResult &= bApplyOption(stOptions.bKeepAlive, SOL_SOCKET, SO_KEEPALIVE);
+            bResult &= bApplyOption(stOptions.snKeepIdleSec, IPPROTO_TCP, k_snOptionKeepIdle);
+            bResult &= bApplyOption(stOptions.snKeepIntervalSec, IPPROTO_TCP, k_snOptionKeepInterval);
+            bResult &= bApplyOption(stOptions.snKeepCount, IPPROTO_TCP, k_snOptionKeepCount);
+            bResult &= bApplyOption(stOptions.bNoDelay, IPPROTO_TCP, TCP_NODELAY);
+            bResult &= bApplyOption(stOptions.bQuickAck, IPPROTO_TCP, k_snOptionQuickAck);
+            bResult &= bApplyOption(stOptions.snBusyPollUs, SOL_SOCKET, k_snOptionBusyPoll);
+            bResult &= bApplyOption(stOptions.snUserTimeoutMs, IPPROTO_TCP, k_snOptionUserTimeout);
+            return bResult;
+        }
+
+        /******************************************************************************
+         * @brief   ソケットオプション 1 項目の適用
+         * @arg     oValue  (in) 値（未設定なら何もしない）
+         * @arg     snLevel (in) レベル
+         * @arg     snName  (in) オプション名（-1:未対応）
+         * @return  結果 true:正常（未設定を含む） false:異常
+         * @note
+         *****************************************************************************/
+        template<class T_>
+        bool bApplyOption(const std::optional<T_>& oValue, int snLevel, int snName) {
+            if (!oValue.has_value()) {
+                return true;
+            }
+            if (snName < 0) {
+                return false;
+            }
+            int snValue = static_cast<int>(*oValue);
+            return (::setsockopt(m_hSocket, snLevel, snName,
+                                 reinterpret_cast<const char*>(&snValue), sizeof(snValue)) == 0);
+        }
+
+        /******************************************************************************
+         * @brief   名前解決のヒントにソケットのファミリーを設定
+         * @arg     stHints (in/out) ヒント
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vSetResolveHints(addrinfo& stHints) const {
+            stHints.ai_socktype = SOCK_STREAM;
+            switch (m_eFamily) {
+            case AddressFamily::IPv4:
+                stHints.ai_family = AF_INET;
+                break;
+            case AddressFamily::IPv6:
+                stHints.ai_family = AF_INET6;
+                break;
+            case AddressFamily::DualStack:
+                stHints.ai_family = AF_INET6;
+                stHints.ai_flags |= AI_V4MAPPED | AI_ALL;
+                break;
+            }
+        }
+
+        /******************************************************************************
+         * @brief   解決結果をファミリーが交互になるよう並べ替え
+         * @arg     pstResult (in) getaddrinfo の結果
+         * @return  試行順のアドレス
+         * @note    RFC 8305 に従い、先頭（OS の優先順位で最上位）のファミリーから
+         *          交互に並べ、一方のファミリーが全滅しても待たされないようにする
+         *****************************************************************************/
+        static std::vector<const addrinfo*> vecInterleaveFamilies(const addrinfo* pstResult) {
+            std::vector<const addrinfo*> vecPrimary;
+            std::vector<const addrinfo*> vecSecondary;
+            for (const addrinfo* pstCurrent = pstResult; pstCurrent != nullptr; pstCurrent = pstCurrent->ai_next) {
+                if (pstCurrent->ai_family == pstResult->ai_family) {
+                    vecPrimary.push_back(pstCurrent);
+                }
+                else {
+                    vecSecondary.push_back(pstCurrent);
+                }
+            }
+            std::vector<const addrinfo*> vecAddresses;
+            vecAddresses.reserve(vecPrimary.size() + vecSecondary.size());
+            for (size_t unIndex = 0; unIndex < std::max(vecPrimary.size(), vecSecondary.size()); ++unIndex) {
+                if (unIndex < vecPrimary.size()) {
+                    vecAddresses.push_back(vecPrimary[unIndex]);
+                }
+                if (unIndex < vecSecondary.size()) {
+                    vecAddresses.push_back(vecSecondary[unIndex]);
+                }
+            }
+            return vecAddresses;
+        }
+
+        /******************************************************************************
+         * @brief   並列接続用の名前解決
+         * @arg     strHost (in) 接続先ホスト
+         * @arg     unPort  (in) 接続先ポート
+         * @return  getaddrinfo の結果（nullptr:失敗、成功時は freeaddrinfo で解放する）
+         * @note    未作成か DualStack なら IPv4 / IPv6 の両方を解決する
+         *****************************************************************************/
+        addrinfo* pstResolveConnect(const std::string& strHost, unsigned short unPort) const {
+            addrinfo stHints {};
+            stHints.ai_socktype = SOCK_STREAM;  // TCP
+            if (m_hSocket == INVALID_SOCKET || m_eFamily == AddressFamily::DualStack) {
+                stHints.ai_family = AF_UNSPEC;
+            }
+            else {
+                stHints.ai_family = (m_eFamily == AddressFamily::IPv4) ? AF_INET : AF_INET6;
+            }
+            addrinfo* pstResult = nullptr;
+            std::string strPort = std::to_string(unPort);
+            if (getaddrinfo(strHost.c_str(), strPort.c_str(), &stHints, &pstResult) != 0) {
+                return nullptr;
+            }
+            return pstResult;
+        }
+
+        /******************************************************************************
+         * @brief   各アドレスへ間隔をずらして接続を試し、最初に確立した接続を取得
+         * @arg     vecAddresses (in)  試行順のアドレス
+         * @arg     stConnect    (in)  接続設定
+         * @arg     tpBegin      (in)  接続開始時刻（タイムアウトの起点）
+         * @arg     unWinnerSent (out) 採用した接続の SYN に載せたバイト数
+         * @return  採用した接続（無効:全アドレス失敗かタイムアウト）
+         * @note    採用しなかった試行は戻る前に閉じる
+         *****************************************************************************/
+        Socket cRaceAttempts(const std::vector<const addrinfo*>& vecAddresses, const ConnectOptions& stConnect,
+                             std::chrono::steady_clock::time_point tpBegin, size_t& unWinnerSent) const {
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point tpDeadline = tpBegin + std::chrono::milliseconds(stConnect.unTimeoutMs);
+            std::vector<Socket> vecAttempts;    // 接続中の試行
+            std::vector<size_t> vecSent;        // 試行ごとの SYN に載せたバイト数
+            Socket cWinner;
+            size_t unNext = 0;
+            Clock::time_point tpNextAttempt = tpBegin;
+            while (cWinner.m_hSocket == INVALID_SOCKET) {
+                Clock::time_point tpNow = Clock::now();
+                if (stConnect.unTimeoutMs != 0 && tpNow >= tpDeadline) {
+                    break;
+                }
+                if (unNext < vecAddresses.size() && (vecAttempts.empty() || tpNow >= tpNextAttempt)) {
+                    Socket cAttempt;
+                    size_t unSent = 0;
+                    int snState = snStartAttempt(*vecAddresses[unNext++], stConnect, cAttempt, unSent);
+                    if (snState > 0) {
+                        cWinner = std::move(cAttempt);
+                        unWinnerSent = unSent;
+                    }
+                    else if (snState == 0) {
+                        vecAttempts.push_back(std::move(cAttempt));
+                        vecSent.push_back(unSent);
+                        tpNextAttempt = tpNow + std::chrono::milliseconds(stConnect.unAttemptDelayMs);
+                    }
+                    continue;
+                }
+                if (vecAttempts.empty()) {
+                    break;      // 全アドレスが失敗
+                }
+
+                // 次の試行開始・タイムアウトのうち早い方まで、いずれかの試行の完了を待つ
+                int64_t snWaitMs = -1;
+                if (unNext < vecAddresses.size()) {
+                    snWaitMs = std::chrono::duration_cast<std::chrono::milliseconds>(tpNextAttempt - tpNow).count() + 1;
+                }
+                if (stConnect.unTimeoutMs != 0) {
+                    int64_t snRemainMs = std::chrono::duration_cast<std::chrono::milliseconds>(tpDeadline - tpNow).count() + 1;
+                    snWaitMs = (snWaitMs < 0) ? snRemainMs : std::min(snWaitMs, snRemainMs);
+                }
+                bool bAttemptFailed = false;
+                if (!bPollAttempts(vecAttempts, vecSent, snWaitMs, cWinner, unWinnerSent, bAttemptFailed)) {
+                    break;
+                }
+                if (bAttemptFailed) {
+                    tpNextAttempt = tpNow;      // 失敗したら次のアドレスをすぐ試す
+                }
+            }
+            return cWinner;
+        }
+
+        /******************************************************************************
+         * @brief   接続中の試行の完了待ちと結果の回収
+         * @arg     vecAttempts    (in/out) 接続中の試行（完了したものは取り除く）
+         * @arg     vecSent        (in/out) 試行ごとの SYN に載せたバイト数
+         * @arg     snWaitMs       (in)     待ち時間(ミリ秒) -1:無期限
+         * @arg     cWinner        (in/out) 採用した接続（未採用なら確立した試行を格納）
+         * @arg     unWinnerSent   (out)    採用した接続の SYN に載せたバイト数
+         * @arg     bAttemptFailed (out)    失敗した試行があったか
+         * @return  結果 true:正常 false:待ちの異常
+         * @note    同時に複数確立した場合は 1 つだけ採用し、残りは閉じる
+         *****************************************************************************/
+        static bool bPollAttempts(std::vector<Socket>& vecAttempts, std::vector<size_t>& vecSent, int64_t snWaitMs,
+                                  Socket& cWinner, size_t& unWinnerSent, bool& bAttemptFailed) {
+            std::vector<pollfd> vecPoll(vecAttempts.size(), pollfd {});
+            for (size_t unIndex = 0; unIndex < vecAttempts.size(); ++unIndex) {
+                vecPoll[unIndex].fd = vecAttempts[unIndex].m_hSocket;
+                vecPoll[unIndex].events = POLLOUT;
+            }
+            int snReady = snPoll(vecPoll, static_cast<int>(std::max<int64_t>(snWaitMs, -1)));
+            if (snReady < 0 && !bIsInterrupted()) {
+                return false;
+            }
+            for (size_t unIndex = vecAttempts.size(); unIndex-- > 0; ) {
+                if (vecPoll[unIndex].revents == 0) {
+                    continue;
+                }
+                if (cWinner.m_hSocket == INVALID_SOCKET && vecAttempts[unIndex].snGetSocketError() == 0) {
+                    cWinner = std::move(vecAttempts[unIndex]);
+                    unWinnerSent = vecSent[unIndex];
+                }
+                else {
+                    bAttemptFailed = true;
+                }
+                vecAttempts.erase(vecAttempts.begin() + static_cast<std::ptrdiff_t>(unIndex));
+                vecSent.erase(vecSent.begin() + static_cast<std::ptrdiff_t>(unIndex));
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   採用した接続へのハンドルの置き換え
+         * @arg     cWinner      (in/out) 採用した接続（ハンドルを引き取る）
+         * @arg     cFirstFrame  (in)     接続直後に送るフレーム
+         * @arg     unWinnerSent (in)     SYN に載せたバイト数
+         * @return  なし
+         * @note    元のブロッキングモードに戻し、SYN に載せきれなかった残りを送る。
+         *          送信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        void vAdoptConnection(Socket& cWinner, const SharedFrame& cFirstFrame, size_t unWinnerSent) {
+            bool bNonBlocking = m_bNonBlocking;
+            if (m_hSocket != INVALID_SOCKET) {
+            #ifdef _WIN32
+                ::closesocket(m_hSocket);
+            #else
+                ::close(m_hSocket);
+            #endif
+            }
+            m_hSocket = cWinner.m_hSocket;
+            m_eFamily = cWinner.m_eFamily;
+            cWinner.m_hSocket = INVALID_SOCKET;
+            SetNonBlocking(false);
+            // TCP_QUICKACK 等は接続状態の変化でリセットされるため接続後に再適用する
+            bApplyOptions(m_stOptions);
+            if (cFirstFrame.Size() > unWinnerSent) {
+                SendAll(cFirstFrame.Data() + unWinnerSent, cFirstFrame.Size() - unWinnerSent);
+            }
+            if (bNonBlocking) {
+                SetNonBlocking(true);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   1 アドレスへのノンブロッキング接続の開始
+         * @arg     stAddress (in)  接続先アドレス
+         * @arg     stConnect (in)  接続設定
+         * @arg     cAttempt  (out) 試行用ソケット（このソケットのオプションを適用する）
+         * @arg     unSent    (out) SYN に載せたバイト数
+         * @return  結果 1:接続完了 0:接続中 -1:失敗
+         * @note    TCP Fast Open が使えない環境・設定では通常の connect にフォールバックする
+         *****************************************************************************/
+        int snStartAttempt(const addrinfo& stAddress, const ConnectOptions& stConnect,
+                           Socket& cAttempt, size_t& unSent) const {
+            cAttempt.m_hSocket = ::socket(stAddress.ai_family, stAddress.ai_socktype, stAddress.ai_protocol);
+            if (cAttempt.m_hSocket == INVALID_SOCKET) {
+                return -1;
+            }
+            cAttempt.m_eFamily = (stAddress.ai_family == AF_INET6) ? AddressFamily::IPv6 : AddressFamily::IPv4;
+            cAttempt.m_stOptions = m_stOptions;
+            cAttempt.bApplyOptions(cAttempt.m_stOptions);
+            if (!cAttempt.SetNonBlocking(true)) {
+                return -1;
+            }
+            unSent = 0;
+            const SharedFrame& cFirstFrame = stConnect.cFirstFrame;
+            if (stConnect.bFastOpen && k_snSendFastOpen != 0 && cFirstFrame.Size() != 0) {
+                // Cookie があれば SYN にデータを載せ、なければ Cookie を要求して接続のみ開始する
+                int snSent = static_cast<int>(::sendto(cAttempt.m_hSocket,
+                                                       reinterpret_cast<const char*>(cFirstFrame.Data()),
+                                                       static_cast<int>(cFirstFrame.Size()),
+                                                       k_snSendFastOpen | k_snSendNoSignal,
+                                                       stAddress.ai_addr,
+                                                       static_cast<int>(stAddress.ai_addrlen)));
+                if (snSent >= 0) {
+                    unSent = static_cast<size_t>(snSent);
+                    return 0;
+                }
+                if (bIsConnectInProgress()) {
+                    return 0;
+                }
+                if (errno != EOPNOTSUPP) {
+                    return -1;
+                }
+                // クライアント側の TFO が無効（net.ipv4.tcp_fastopen）
+            }
+            if (::connect(cAttempt.m_hSocket, stAddress.ai_addr,
+                          static_cast<int>(stAddress.ai_addrlen)) != SOCKET_ERROR) {
+                return 1;
+            }
+            return bIsConnectInProgress() ? 0 : -1;
+        }
+
+        /******************************************************************************
+         * @brief   直前のソケットエラーがノンブロッキング接続の継続中によるものか判定
+         * @arg     なし
+         * @return  結果 true:EINPROGRESS false:その他
+         * @note
+         *****************************************************************************/
+        static bool bIsConnectInProgress() {
+#ifdef _WIN32
+            return (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+            return (errno == EINPROGRESS || errno == EINTR);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   保留中のソケットエラーの取得（SO_ERROR）
+         * @arg     なし
+         * @return  エラー番号（0:エラーなし）
+         * @note    ノンブロッキング接続の結果の確認に使用する
+         *****************************************************************************/
+        int snGetSocketError() const {
+            int snError = 0;
+        #ifdef _WIN32
+            int snLength = sizeof(snError);
+        #else
+            socklen_t snLength = sizeof(snError);
+        #endif
+            if (::getsockopt(m_hSocket, SOL_SOCKET, SO_ERROR,
+                             reinterpret_cast<char*>(&snError), &snLength) != 0) {
+                return -1;
+            }
+            return snError;
+        }
+
+        /******************************************************************************
+         * @brief   複数ソケットのイベント待ち
+         * @arg     vecPoll     (in/out) 対象ソケットと待つイベント
+         * @arg     snTimeoutMs (in)     タイムアウト(ミリ秒) -1:無期限
+         * @return  イベントのあったソケット数（0:タイムアウト、負:エラー）
+         * @note
+         *****************************************************************************/
+        static int snPoll(std::vector<pollfd>& vecPoll, int snTimeoutMs) {
+        #ifdef _WIN32
+            return ::WSAPoll(vecPoll.data(), static_cast<ULONG>(vecPoll.size()), snTimeoutMs);
+        #else
+            return ::poll(vecPoll.data(), static_cast<nfds_t>(vecPoll.size()), snTimeoutMs);
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   ソケットオプション 1 項目の読み出し
+         * @arg     oValue  (out) 値（取得できない場合は変更しない）
+         * @arg     snLevel (in)  レベル
+         * @arg     snName  (in)  オプション名（-1:未対応）
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        template<class T_>
+        void vReadOption(std::optional<T_>& oValue, int snLevel, int snName) const {
+            if (snName < 0) {
+                return;
+            }
+            int snValue = 0;
+        #ifdef _WIN32
+            int snLength = sizeof(snValue);
+        #else
+            socklen_t snLength = sizeof(snValue);
+        #endif
+            if (::getsockopt(m_hSocket, snLevel, snName,
+                             reinterpret_cast<char*>(&snValue), &snLength) == 0) {
+                if constexpr (std::is_same_v<T_, bool>) {
+                    oValue = (snValue != 0);
+                }
+                else {
+                    oValue = static_cast<T_>(snValue);
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   出力バッファを 1 フレームとして送信キュー末尾へ移す
+         * @arg     なし
+         * @return  結果（出力バッファが空の場合は Queued）
+         * @note    送信キューが受け付けなかった場合は出力バッファをそのまま残す
+         *****************************************************************************/
+        EnqueueResult eQueueOutput() {
+            if (m_vecOutput.empty()) {
+                return EnqueueResult::Queued;
+            }
+            SharedFrame cOutput(std::move(m_vecOutput));
+            m_vecOutput = std::vector<uint8_t>();
+            EnqueueResult eResult = ePushFrame(cOutput);
+            if (eResult != EnqueueResult::Queued) {
+                m_vecOutput.assign(cOutput.Data(), cOutput.Data() + cOutput.Size());
+                return eResult;
+            }
+            m_vecOutput.reserve(m_unFlushThreshold);
+            return eResult;
+        }
+
+        /******************************************************************************
+         * @brief   直接送信せず送信キューを経由する必要があるか判定
+         * @arg     なし
+         * @return  結果 true:送信キュー経由 false:直接送信してよい
+         * @note    送信キューに送信途中のフレームが残っている間に直接送ると、そのフレームの
+         *          途中にデータが混ざる。ノンブロッキングソケットは EAGAIN で残りを保持する必要がある
+         *****************************************************************************/
+        bool bMustQueue() const {
+            return m_bNonBlocking || !m_cSendQueue.IsEmpty();
+        }
+
+        /******************************************************************************
+         * @brief   フレームを送信キュー末尾へ積んで送出
+         * @arg     cFrame    (in) 送信するフレーム
+         * @arg     ePriority (in) 送信優先度
+         * @return  結果 true:正常 false:上限超過で破棄・切断した
+         * @note    ブロッキングソケットでは送り終えるまで待つ。
+         *          ノンブロッキングソケットでは残りは FlushSendQueue で送ること
+         *****************************************************************************/
+        bool bQueueAndFlush(const SharedFrame& cFrame, SendPriority ePriority = SendPriority::Normal) {
+            if (ePushFrame(cFrame, ePriority) != EnqueueResult::Queued) {
+                return false;
+            }
+            Flush();
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ノンブロッキング・CLOEXEC のソケットとして 1 件受け入れる
+         * @arg     なし
+         * @return  受け入れたソケット（INVALID_SOCKET:失敗、原因はエラー番号）
+         * @note
+         *****************************************************************************/
+        SOCKET hAcceptNonBlocking() {
+        #if defined(__linux__)
+            return ::accept4(m_hSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        #elif defined(_WIN32)
+            SOCKET hClient = ::accept(m_hSocket, nullptr, nullptr);
+            if (hClient != INVALID_SOCKET) {
+                u_long unMode = 1;
+                ::ioctlsocket(hClient, FIONBIO, &unMode);
+            }
+            return hClient;
+        #else
+            SOCKET hClient = ::accept(m_hSocket, nullptr, nullptr);
+            if (hClient != INVALID_SOCKET) {
+                ::fcntl(hClient, F_SETFL, ::fcntl(hClient, F_GETFL, 0) | O_NONBLOCK);
+                ::fcntl(hClient, F_SETFD, FD_CLOEXEC);
+            }
+            return hClient;
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   直前の受け入れエラーが接続側の事情による一時的なものか判定
+         * @arg     なし
+         * @return  結果 true:次の接続を受け入れてよい false:その他
+         * @note    受け入れ前に相手が切断した場合等
+         *****************************************************************************/
+        static bool bIsTransientAcceptError() {
+#ifdef _WIN32
+            return (WSAGetLastError() == WSAECONNRESET);
+#else
+            return (errno == ECONNABORTED || errno == EPROTO || errno == EPERM);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   直前のエラーが fd 枯渇によるものか判定
+         * @arg     なし
+         * @return  結果 true:EMFILE / ENFILE false:その他
+         * @note
+         *****************************************************************************/
+        static bool bIsDescriptorExhausted() {
+#ifdef _WIN32
+            return (WSAGetLastError() == WSAEMFILE);
+#else
+            return (errno == EMFILE || errno == ENFILE);
+#endif
+        }
+
+        /******************************************************************************
+         * @brief   予備 fd の確保
+         * @arg     なし
+         * @return  なし
+         * @note    fd 枯渇時に 1 件分の空きを作るために保持する
+         *****************************************************************************/
+        void vOpenReserveFd() {
+        #ifndef _WIN32
+            m_hReserveFd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   fd 枯渇時に保留中の接続を 1 件受け付けて即座に閉じる
+         * @arg     なし
+         * @return  結果 true:1 件閉じた false:予備 fd がなく処理できない
+         * @note    相手には接続直後の切断として見え、再試行を促せる
+         *****************************************************************************/
+        bool bShedOneConnection() {
+        #ifdef _WIN32
+            return false;
+        #else
+            if (m_hReserveFd < 0) {
+                return false;
+            }
+            ::close(m_hReserveFd);
+            m_hReserveFd = -1;
+            SOCKET hClient = ::accept(m_hSocket, nullptr, nullptr);
+            if (hClient != INVALID_SOCKET) {
+                ::close(hClient);
+                ++m_stStats.unAcceptsShed;
+            }
+            vOpenReserveFd();
+            return (hClient != INVALID_SOCKET);
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   ソケットが書き込み可能になるまで待機
+         * @arg     なし
+         * @return  なし
+         * @note    ノンブロッキングソケットへのブロッキング送信時に使用する
+         *****************************************************************************/
+        void vWaitWritable() {
+            bWaitWritable(0);
+        }
+
+        /******************************************************************************
+         * @brief   タイムアウト付きでソケットが書き込み可能になるまで待機
+         * @arg     unTimeoutMs (in) タイムアウト(ミリ秒) 0:なし
+         * @return  結果 true:書き込み可能（またはシグナル割り込み） false:タイムアウト
+         * @note
+         *****************************************************************************/
+        bool bWaitWritable(uint64_t unTimeoutMs) {
+            fd_set stWriteFds;
+            FD_ZERO(&stWriteFds);
+            FD_SET(m_hSocket, &stWriteFds);
+            struct timeval stTimeout {};
+            stTimeout.tv_sec = static_cast<long>(unTimeoutMs / 1000);
+            stTimeout.tv_usec = static_cast<long>((unTimeoutMs % 1000) * 1000);
+            int snSelectResult = select(static_cast<int>(m_hSocket) + 1, nullptr, &stWriteFds, nullptr,
+                                        (unTimeoutMs == 0) ? nullptr : &stTimeout);
+            if (snSelectResult < 0 && !bIsInterrupted()) {
+                vThrowSocketError("select");
+            }
+            return (snSelectResult != 0);
+        }
+
+        /******************************************************************************
+         * @brief   上限とポリシーに従い送信キューへフレームを追加
+         * @arg     cFrame    (in) 追加するフレーム
+         * @arg     ePriority (in) 送信優先度
+         * @return  結果
+         * @note    キューが空なら上限を超えるフレームでも追加する（送れなくなるため）。
+         *          Urgent は溜まったデータに関わらず届ける必要があるため上限を適用しない
+         *****************************************************************************/
+        EnqueueResult ePushFrame(const SharedFrame& cFrame, SendPriority ePriority = SendPriority::Normal) {
+            const size_t unHigh = m_stLimits.unHighWatermark;
+            if (unHigh != 0 && ePriority != SendPriority::Urgent && !m_cSendQueue.IsEmpty() &&
+                m_cSendQueue.GetPendingBytes() + cFrame.Size() > unHigh) {
+                ++m_stStats.unOverflows;
+                m_bAboveHighWatermark = true;
+                switch (m_stLimits.ePolicy) {
+                case OverflowPolicy::Block:
+                    vBlockUntilBelow(unHigh - std::min(unHigh, cFrame.Size()));
+                    break;
+                case OverflowPolicy::DropNewest:
+                    ++m_stStats.unFramesDropped;
+                    m_stStats.unBytesDropped += cFrame.Size();
+                    return EnqueueResult::Dropped;
+                case OverflowPolicy::DropOldest: {
+                    size_t unNeeded = m_cSendQueue.GetPendingBytes() + cFrame.Size() - unHigh;
+                    size_t unDroppedFrames = 0;
+                    m_stStats.unBytesDropped += m_cSendQueue.DropOldest(unNeeded, unDroppedFrames);
+                    m_stStats.unFramesDropped += unDroppedFrames;
+                    break;
+                }
+                case OverflowPolicy::Disconnect:
+                    Shutdown();
+                    return EnqueueResult::Disconnected;
+                }
+            }
+            m_cSendQueue.Push(cFrame, ePriority);
+            ++m_stStats.unFramesQueued;
+            size_t unPending = m_cSendQueue.GetPendingBytes();
+            m_stStats.unPeakPendingBytes = std::max(m_stStats.unPeakPendingBytes, unPending);
+            if (unHigh != 0 && unPending >= unHigh) {
+                m_bAboveHighWatermark = true;
+            }
+            return EnqueueResult::Queued;
+        }
+
+        /******************************************************************************
+         * @brief   未送信バイト数が指定値以下になるまで送信しながら待つ
+         * @arg     unTarget (in) 目標の未送信バイト数
+         * @return  なし
+         * @note    Block ポリシー用。unBlockTimeoutMs を過ぎた場合は std::system_error を送出する
+         *****************************************************************************/
+        void vBlockUntilBelow(size_t unTarget) {
+            using Clock = std::chrono::steady_clock;
+            const uint64_t unTimeoutMs = m_stLimits.unBlockTimeoutMs;
+            const Clock::time_point tpDeadline = Clock::now() + std::chrono::milliseconds(unTimeoutMs);
+            while (!m_cSendQueue.IsEmpty() && m_cSendQueue.GetPendingBytes() > unTarget) {
+                if (FlushSendQueue() == FlushResult::Ok) {
+                    return;
+                }
+                uint64_t unWaitMs = 0;
+                if (unTimeoutMs != 0) {
+                    Clock::time_point tpNow = Clock::now();
+                    if (tpNow >= tpDeadline) {
+                        throw std::system_error(static_cast<int>(std::errc::timed_out), std::generic_category(), "send queue full");
+                    }
+                    unWaitMs = std::max<uint64_t>(1, static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::milliseconds>(tpDeadline - tpNow).count()));
+                }
+                bWaitWritable(unWaitMs);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   低ウォーターマークまで回復したら書き込み可能を通知
+         * @arg     なし
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        void vCheckWritable() {
+            if (!m_bAboveHighWatermark ||
+                m_cSendQueue.GetPendingBytes() > m_stLimits.unLowWatermark) {
+                return;
+            }
+            m_bAboveHighWatermark = false;
+            ++m_stStats.unWritableEvents;
+            if (m_fnWritable) {
+                m_fnWritable();
+            }
+        }
+
+        /******************************************************************************
+         * @brief   複数バッファをまとめて送信
+         * @arg     vecBuffers (in) 送信するバッファ群
+         * @arg     bBlocking  (in) true:ソケットのモードに従う false:ノンブロッキング
+         * @arg     bMore      (in) true:後続データあり（MSG_MORE）
+         * @arg     pbZeroCopy (in/out) true:MSG_ZEROCOPY で送る（メモリ制限で使えず
+         *                     コピー送信した場合は false に戻す） nullptr:使わない
+         * @return  送信バイト数（-1:ソケットバッファ満杯）
+         * @note    先頭から k_unMaxGatherBuffers 個までを送る。
+         *          送信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        int64_t snSendGather(const std::vector<ConstBuffer>& vecBuffers, bool bBlocking,
+                             bool bMore = false, bool* pbZeroCopy = nullptr) {
+        #ifdef _WIN32
+            (void)bBlocking;
+            (void)bMore;
+            if (pbZeroCopy != nullptr) {
+                *pbZeroCopy = false;
+            }
+            WSABUF stWsaBuffers[k_unMaxGatherBuffers];
+            DWORD unCount = 0;
+            for (const ConstBuffer& stBuffer : vecBuffers) {
+                if (unCount == k_unMaxGatherBuffers) {
+                    break;
+                }
+                stWsaBuffers[unCount].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(stBuffer.pData));
+                stWsaBuffers[unCount].len = static_cast<ULONG>(stBuffer.unSize);
+                ++unCount;
+            }
+            DWORD unSent = 0;
+            if (::WSASend(m_hSocket, stWsaBuffers, unCount, &unSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+                if (bIsWouldBlock()) {
+                    return -1;
+                }
+                vThrowSocketError("WSASend");
+            }
+            return static_cast<int64_t>(unSent);
+        #else
+            iovec stIoVecs[k_unMaxGatherBuffers];
+            size_t unCount = 0;
+            for (const ConstBuffer& stBuffer : vecBuffers) {
+                if (unCount == k_unMaxGatherBuffers) {
+                    break;
+                }
+                stIoVecs[unCount].iov_base = const_cast<uint8_t*>(stBuffer.pData);
+                stIoVecs[unCount].iov_len = stBuffer.unSize;
+                ++unCount;
+            }
+            msghdr stMsg {};
+            stMsg.msg_iov = stIoVecs;
+            stMsg.msg_iovlen = unCount;
+            int snFlags = bBlocking ? k_snSendNoSignal : (MSG_DONTWAIT | k_snSendNoSignal);
+            if (bMore) {
+                snFlags |= k_snSendMore;
+            }
+            bool bZeroCopy = (pbZeroCopy != nullptr && *pbZeroCopy && k_snSendZeroCopy != 0);
+            ssize_t snSent = ::sendmsg(m_hSocket, &stMsg, bZeroCopy ? (snFlags | k_snSendZeroCopy) : snFlags);
+            if (snSent < 0 && bZeroCopy && errno == ENOBUFS) {
+                // ページ固定のメモリ上限（optmem / RLIMIT_MEMLOCK）超過時はコピー送信する
+                bZeroCopy = false;
+                snSent = ::sendmsg(m_hSocket, &stMsg, snFlags);
+            }
+            if (pbZeroCopy != nullptr) {
+                *pbZeroCopy = (bZeroCopy && snSent >= 0);
+            }
+            if (snSent < 0) {
+                if (bIsWouldBlock()) {
+                    return -1;
+                }
+                if (bIsInterrupted()) {
+                    return 0;
+                }
+                vThrowSocketError("sendmsg");
+            }
+            return static_cast<int64_t>(snSent);
+        #endif
+        }
+
+        /******************************************************************************
+         * @brief   指定バイト数を受信（ブロッキング）
+         * @arg     hSocket  (in)  受信に使用するソケット
+         * @arg     pBuffer  (out) 受信するデータ格納バッファ
+         * @arg     unLength (in)  受信するデータ長
+         * @return  結果 true:正常 false:異常
+         * @note    
+         *****************************************************************************/
+        bool bRecvAll(uint8_t* pBuffer, size_t unLength) {
+            size_t unTotalReceived = 0;
+            while (unTotalReceived < unLength) {
+                if (m_bShutdown.load()) {
+                    throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
+                }
+
+                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer + unTotalReceived),
+                                      static_cast<int>(unLength - unTotalReceived), 0);
+                if (snReceived <= 0) {
+                    vThrowSocketError("recv");
+                }
+                unTotalReceived += static_cast<size_t>(snReceived);
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   ビジーポーリングで指定バイト数を受信
+         * @arg     pBuffer     (out) 受信するデータ格納バッファ
+         * @arg     unLength    (in)  受信するデータ長
+         * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒) 0:なし
+         * @return  結果 true:正常 false:異常
+         * @note    データが途切れるたびにスピン予算を使い切るまで recv を繰り返し、
+         *          尽きたら select で待機する（待機から戻ると再びスピンする）
+         *****************************************************************************/
+        bool bRecvAllBusyPoll(uint8_t* pBuffer, size_t unLength, uint64_t unTimeoutMs) {
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point tpDeadline = Clock::now() + std::chrono::milliseconds(unTimeoutMs);
+            const std::chrono::microseconds durSpinBudget(m_unSpinBudgetUs);
+            size_t unTotalReceived = 0;
+            Clock::time_point tpSpinBegin = Clock::now();
+            while (unTotalReceived < unLength) {
+                if (m_bShutdown.load()) {
+                    throw std::system_error(static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
+                }
+                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer + unTotalReceived),
+                                      static_cast<int>(unLength - unTotalReceived), k_snRecvDontWait);
+                if (snReceived > 0) {
+                    unTotalReceived += static_cast<size_t>(snReceived);
+                    tpSpinBegin = Clock::now();
+                    continue;
+                }
+                if (snReceived == 0 || (!bIsWouldBlock() && !bIsInterrupted())) {
+                    vThrowSocketError("recv");
+                }
+                Clock::time_point tpNow = Clock::now();
+                if (unTimeoutMs != 0 && tpNow >= tpDeadline) {
+                    throw std::system_error(static_cast<int>(std::errc::timed_out), std::generic_category(), "busy poll timeout");
+                }
+                if (tpNow - tpSpinBegin < durSpinBudget) {
+                    CpuRelax();
+                    continue;
+                }
+
+                // スピン予算切れ：データ到着まで待機
+                fd_set stReadFds;
+                FD_ZERO(&stReadFds);
+                FD_SET(m_hSocket, &stReadFds);
+                struct timeval stTimeout {};
+                struct timeval* pstTimeout = nullptr;
+                if (unTimeoutMs != 0) {
+                    int64_t snRemainUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                        tpDeadline - tpNow).count();
+                    stTimeout.tv_sec = static_cast<long>(snRemainUs / 1000000);
+                    stTimeout.tv_usec = static_cast<long>(snRemainUs % 1000000);
+                    pstTimeout = &stTimeout;
+                }
+                int snSelectResult = select(static_cast<int>(m_hSocket) + 1,
+                                            &stReadFds, nullptr, nullptr, pstTimeout);
+                if (snSelectResult < 0 && !bIsInterrupted()) {
+                    vThrowSocketError("select");
+                }
+                tpSpinBegin = Clock::now();
+            }
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   タイムアウト付き指定バイト数を受信 （ミリ秒単位）
+         * @arg     pBuffer     (out) 受信するデータ格納バッファ
+         * @arg     unLength    (in)  受信するデータ長
+         * @arg     unTimeoutMs (in)  タイムアウト(ミリ秒)
+         * @return  結果 true:正常 false:異常
+         * @note    
+         *****************************************************************************/
+        bool bRecvAllWithTimeout(uint8_t* pBuffer, size_t unLength, uint64_t unTimeoutMs) {
+            size_t unTotalReceived = 0;
+            while (unTotalReceived < unLength) {
+                fd_set stReadFds;
+                FD_ZERO(&stReadFds);
+                FD_SET(m_hSocket, &stReadFds);
+
+                struct timeval stTimeout {};
+                stTimeout.tv_sec = static_cast<long>(  unTimeoutMs / 1000);
+                stTimeout.tv_usec = static_cast<long>((unTimeoutMs % 1000) * 1000);
+
+                int snSelectResult = select(static_cast<int>(m_hSocket) + 1,
+                                            &stReadFds, nullptr, nullptr, &stTimeout);
+                if (snSelectResult < 0) {
+                    vThrowSocketError("select");
+                }
+                if (snSelectResult == 0) {
+                    throw std::system_error( static_cast<int>(std::errc::timed_out), std::generic_category(), "select timeout");
+                }
+                if(m_bShutdown.load()) {
+                    throw std::system_error( static_cast<int>(std::errc::operation_canceled), std::generic_category(), "socket shutdown");
+				}
+                int snReceived = recv(m_hSocket, reinterpret_cast<char*>(pBuffer + unTotalReceived),
+                                      static_cast<int>(unLength - unTotalReceived), 0);
+                if (snReceived <= 0) {
+                    vThrowSocketError("recv");
+                }
+                unTotalReceived += static_cast<size_t>(snReceived);
+            }
+            return true;
+        }
+        
+    private:
+        SOCKET               m_hSocket;
+        std::atomic_bool     m_bShutdown;
+        bool                 m_bNonBlocking;
+        SendQueue            m_cSendQueue;
+        FrameReader          m_cFrameReader;
+        std::vector<uint8_t> m_vecOutput;           // バッファリング送信の出力バッファ
+        size_t               m_unFlushThreshold;    // 0:バッファリングしない
+        SocketOptions        m_stOptions;
+        uint64_t             m_unSpinBudgetUs;      // 0:ビジーポーリングしない
+        size_t               m_unRcvLowatCap;       // 0:SO_RCVLOWAT を調整しない
+        size_t               m_unRcvLowat;          // 現在の SO_RCVLOWAT
+        size_t               m_unZeroCopyThreshold; // 0:ゼロコピー送信しない
+        ZeroCopyTracker      m_cZeroCopy;
+        SendQueueLimits      m_stLimits;
+        bool                 m_bAboveHighWatermark;
+        std::function<void()> m_fnWritable;
+        SocketStats          m_stStats;
+        int                  m_hReserveFd;          // fd 枯渇対策の予備 fd（リスナーのみ）
+        AddressFamily        m_eFamily;
+    };
+
+    /******************************************************************************
+     * @brief   接続先アドレス文字列の取得
+     * @arg     socket (in) ソケット
      * @return  接続先アドレス文字列
      * @note    
      *****************************************************************************/
@@ -431,6 +2320,18 @@ namespace sbdp {
         return cSocket.SendMessage(msgData);
     }
 
+    /******************************************************************************
+     * @brief   SBDP プロトコルメッセージを優先度付きで送信
+     * @arg     cSocket   (in) 送信に使用するソケット
+     * @arg     msgData   (in) 送信するメッセージ
+     * @arg     ePriority (in) 送信優先度
+     * @return  送信結果 true:正常 false:異常
+     * @note
+     *****************************************************************************/
+    inline bool SendMessage(Socket& cSocket, const Message& msgData, SendPriority ePriority) {
+        return cSocket.SendMessage(msgData, ePriority);
+    }
+
     /******************************************************************************
      * @brief   SBDP プロトコルメッセージ受信
      * @arg     cSocket     (in) 受信に使用するソケット
@@ -441,4 +2342,140 @@ namespace sbdp {
     inline Message RecvMessage(Socket& cSocket, uint64_t unTimeoutMs = 0) {
         return cSocket.RecvMessage(unTimeoutMs);
     }
+
+    /******************************************************************************
+     * @brief   同一メッセージを複数ソケットへ送信（一度だけエンコード）
+     * @arg     vecSockets (in) 送信先ソケット群
+     * @arg     msgData    (in) 送信するメッセージ
+     * @return  未送信データが残ったソケット数
+     * @note    各ソケットの送信キューへ共有フレームの参照を積み、
+     *          ノンブロッキングで送出する。送信の遅いソケットは参照のみを保持し、
+     *          残りは各ソケットの FlushSendQueue で送出すること。
+     *          送信エラーとなったソケットは Shutdown して残りの送信を継続する
+     *****************************************************************************/
+    inline size_t Broadcast(const std::vector<std::reference_wrapper<Socket>>& vecSockets,
+                            const Message& msgData) {
+        SharedFrame cFrame = SharedFrame::Encode(msgData);
+        size_t unPendingCount = 0;
+        for (Socket& cSocket : vecSockets) {
+            try {
+                cSocket.EnqueueFrame(cFrame);
+                if (cSocket.FlushSendQueue() == FlushResult::WouldBlock) {
+                    ++unPendingCount;
+                }
+            }
+            catch (const std::system_error&) {
+                cSocket.Shutdown();
+            }
+        }
+        return unPendingCount;
+    }
+#ifdef SBDP_HAS_ZEROCOPY
+    // クローズ後に完了通知を待つゼロコピー送信の引き取り先（完了を待つ間だけ見回りスレッドが動く）
+    class ZeroCopyReaper {
+    public:
+        /******************************************************************************
+         * @brief   唯一のインスタンスの取得
+         * @arg     なし
+         * @return  インスタンス
+         * @note    静的オブジェクトの破棄中に閉じられるソケットも引き取れるよう破棄しない
+         *****************************************************************************/
+        static ZeroCopyReaper& Instance() {
+            static ZeroCopyReaper* s_pRawReaper = new ZeroCopyReaper();
+            return *s_pRawReaper;
+        }
+
+        /******************************************************************************
+         * @brief   完了待ちのソケットの引き取り
+         * @arg     cSocket (in) 完了待ちの送信を持つソケット
+         * @return  なし
+         * @note    完了通知がそろえば閉じてフレームを解放する。
+         *          k_unZeroCopyReapTimeoutMs を過ぎたら RST で切断して解放する
+         *****************************************************************************/
+        void Adopt(Socket&& cSocket) {
+            std::lock_guard<std::mutex> lock(m_mtxSockets);
+            m_vecSockets.push_back(Adopted{std::move(cSocket),
+                                           Clock::now() + std::chrono::milliseconds(k_unZeroCopyReapTimeoutMs)});
+            if (!m_bRunning) {
+                m_bRunning = true;
+                std::thread([this]() { vRun(); }).detach();
+            }
+        }
+
+        /******************************************************************************
+         * @brief   引き取り中のソケット数の取得
+         * @arg     なし
+         * @return  ソケット数
+         * @note
+         *****************************************************************************/
+        std::size_t GetAdoptedCount() const {
+            std::lock_guard<std::mutex> lock(m_mtxSockets);
+            return m_vecSockets.size();
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Adopted {
+            Socket            cSocket;
+            Clock::time_point tpDeadline;
+        };
+
+        ZeroCopyReaper() : m_bRunning(false) { }
+
+        /******************************************************************************
+         * @brief   見回りスレッド
+         * @arg     なし
+         * @return  なし
+         * @note    エラーキューの通知を POLLERR で待って読み、引き取り中のソケットがなくなれば終わる
+         *****************************************************************************/
+        void vRun() {
+            std::vector<pollfd> vecPoll;
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtxSockets);
+                    if (m_vecSockets.empty()) {
+                        m_bRunning = false;
+                        return;
+                    }
+                    vecPoll.assign(m_vecSockets.size(), pollfd {});
+                    for (std::size_t unIndex = 0; unIndex < m_vecSockets.size(); ++unIndex) {
+                        vecPoll[unIndex].fd = m_vecSockets[unIndex].cSocket.GetHandle();
+                    }
+                }
+                ::poll(vecPoll.data(), static_cast<nfds_t>(vecPoll.size()), static_cast<int>(k_unZeroCopyReapPollMs));
+                std::lock_guard<std::mutex> lock(m_mtxSockets);
+                Clock::time_point tpNow = Clock::now();
+                for (std::size_t unIndex = m_vecSockets.size(); unIndex-- > 0; ) {
+                    Adopted& stAdopted = m_vecSockets[unIndex];
+                    stAdopted.cSocket.ProcessZeroCopyCompletions();
+                    if (stAdopted.cSocket.GetZeroCopyPendingSends() == 0) {
+                        stAdopted.cSocket.Close();
+                    }
+                    else if (tpNow >= stAdopted.tpDeadline) {
+                        stAdopted.cSocket.vAbortZeroCopy();
+                    }
+                    else {
+                        continue;
+                    }
+                    m_vecSockets.erase(m_vecSockets.begin() + static_cast<std::ptrdiff_t>(unIndex));
+                }
+            }
+        }
+
+        mutable std::mutex   m_mtxSockets;
+        std::vector<Adopted> m_vecSockets;
+        bool                 m_bRunning;
+    };
+
+    inline void Socket::vHandOverZeroCopy(ZeroCopyTracker&& cPending) {
+        Socket cOrphan;
+        cOrphan.m_hSocket = m_hSocket;
+        cOrphan.m_cZeroCopy = std::move(cPending);
+        m_hSocket = INVALID_SOCKET;
+        ZeroCopyReaper::Instance().Adopt(std::move(cOrphan));
+    }
+#else
+    inline void Socket::vHandOverZeroCopy(ZeroCopyTracker&&) { }
+#endif
 } // namespace sbdp
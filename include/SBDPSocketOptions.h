@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPSocketOptions.h
+ * @brief   SimpleBinaryDictionaryProtocol Socket Options
+ * @author  Satoh
+ * @note    遅延・スループット調整用のソケットオプション
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace sbdp {
+
+    // ソケットオプション（未設定の項目はカーネルの既定値のまま変更しない）
+    struct SocketOptions {
+        std::optional<bool>    bNoDelay;            // TCP_NODELAY
+        std::optional<bool>    bQuickAck;           // TCP_QUICKACK（Linux のみ、遅延 ACK を抑止）
+        std::optional<bool>    bKeepAlive;          // SO_KEEPALIVE
+        std::optional<int32_t> snKeepIdleSec;       // TCP_KEEPIDLE
+        std::optional<int32_t> snKeepIntervalSec;   // TCP_KEEPINTVL
+        std::optional<int32_t> snKeepCount;         // TCP_KEEPCNT
+        std::optional<int32_t> snSendBufferBytes;   // SO_SNDBUF
+        std::optional<int32_t> snRecvBufferBytes;   // SO_RCVBUF
+        std::optional<int32_t> snBusyPollUs;        // SO_BUSY_POLL（Linux のみ）
+        std::optional<int32_t> snUserTimeoutMs;     // TCP_USER_TIMEOUT（Linux のみ）
+        std::optional<bool>    bReuseAddress;       // SO_REUSEADDR（Bind 前に適用）
+        std::optional<bool>    bReusePort;          // SO_REUSEPORT（Bind 前に適用）
+        std::optional<int32_t> snFastOpenQueue;     // TCP_FASTOPEN（リスナーの保留キュー長、Listen で適用）
+
+        /******************************************************************************
+         * @brief   低遅延向けプリセット
+         * @arg     なし
+         * @return  オプション
+         * @note    小さなリクエスト／レスポンスの往復を想定。
+         *          SO_BUSY_POLL は権限（CAP_NET_ADMIN）がないと適用されない場合がある
+         *****************************************************************************/
+        static SocketOptions LowLatency() {
+            SocketOptions stOptions;
+            stOptions.bNoDelay = true;
+            stOptions.bQuickAck = true;
+            stOptions.snBusyPollUs = 50;
+            return stOptions;
+        }
+
+        /******************************************************************************
+         * @brief   大量転送向けプリセット
+         * @arg     なし
+         * @return  オプション
+         * @note    大きなフレームの連続送信を想定。バッファを広げ、Nagle は有効のまま
+         *****************************************************************************/
+        static SocketOptions BulkThroughput() {
+            SocketOptions stOptions;
+            stOptions.bNoDelay = false;
+            stOptions.snSendBufferBytes = 4 * 1024 * 1024;
+            stOptions.snRecvBufferBytes = 4 * 1024 * 1024;
+            return stOptions;
+        }
+    };
+
+} // namespace sbdp
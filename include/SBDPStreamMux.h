@@ -0,0 +1,474 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPStreamMux.h
+ * @brief   SimpleBinaryDictionaryProtocol Stream Multiplexer
+ * @author  Satoh
+ * @note    1 接続上の論理ストリーム多重化（任意のフレーミング層）。
+ *          送信フレームをストリーム ID 付きのチャンクに分割し、優先度順・
+ *          同一優先度内はラウンドロビンで交互に送ることで、巨大フレームの後ろで
+ *          小さなフレームが待たされる（ヘッドオブラインブロッキング）のを防ぐ。
+ *          受信側はチャンクを元の SBDP フレームへ組み立て直す。
+ *
+ *          チャンクも SBDP フレームで、"$" で始まるキーを予約する。
+ *            データ: {"$s": ストリーム ID, "$d": 断片, "$e": 1（最終チャンクのみ）}
+ *            窓更新: {"$s": ストリーム ID, "$w": 追加するクレジット(バイト)}
+ *          "$s" を含まないフレームは多重化されていない通常フレームとして扱う
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "SBDP.h"
+#include "SBDPFieldView.h"
+#include "SBDPSharedFrame.h"
+#include "SBDPSocket.h"
+
+namespace sbdp {
+
+    // ストリーム多重化の設定（両端で同じ値を使うこと）
+    struct StreamMuxConfig {
+        std::size_t unChunkSize      = 16 * 1024;           // 1 チャンクのデータ長の上限
+        std::size_t unInitialWindow  = 256 * 1024;          // ストリームごとの初期送信窓（バイト）
+        std::size_t unMaxFrameSize   = 1024 * 1024 * 1024;  // 組み立てるフレームの最大長（0:無制限）
+        std::size_t unMaxRecvStreams = 1024;                // 同時に組み立て中の受信ストリーム数の上限
+    };
+
+    // ストリーム多重化の統計
+    struct StreamMuxStats {
+        uint64_t unFramesSent      = 0;     // 送信を終えたフレーム数
+        uint64_t unFramesReceived  = 0;     // 組み立てを終えたフレーム数（通常フレームを含む）
+        uint64_t unChunksSent      = 0;     // 送信したデータチャンク数
+        uint64_t unChunksReceived  = 0;     // 受信したデータチャンク数
+        uint64_t unWindowUpdates   = 0;     // 送信した窓更新数
+        uint64_t unWindowStalls    = 0;     // 送信窓が尽きてストリームが止まった回数
+    };
+
+    // ストリーム多重化（スレッドセーフではない。ソケットはノンブロッキングで使う）
+    class StreamMux {
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     cSocket  (in) 接続済みソケット（StreamMux より長く生存すること）
+         * @arg     stConfig (in) 設定
+         * @return  なし
+         * @note    ソケットの最大受信フレーム長はチャンクと通常フレームの大きい方に設定する。
+         *          窓の終わりの小さなチャンクが Nagle により相手の遅延 ACK を待たされ、
+         *          窓更新の往復が止まるのを防ぐため TCP_NODELAY を有効にする
+         *****************************************************************************/
+        explicit StreamMux(Socket& cSocket, const StreamMuxConfig& stConfig = StreamMuxConfig())
+            : m_cSocket(cSocket), m_stConfig(stConfig), m_unNextStreamId(1), m_stStats() {
+            if (m_stConfig.unChunkSize == 0) {
+                m_stConfig.unChunkSize = 1;
+            }
+            std::size_t unChunkFrameLimit = unChunkOverhead() + m_stConfig.unChunkSize;
+            m_cSocket.SetMaxFrameSize((m_stConfig.unMaxFrameSize == 0) ? 0 :
+                                      std::max(unChunkFrameLimit, m_stConfig.unMaxFrameSize));
+            SocketOptions stOptions = m_cSocket.GetOptions();
+            stOptions.bNoDelay = true;
+            m_cSocket.SetOptions(stOptions);
+        }
+
+        StreamMux(const StreamMux&) = delete;
+        StreamMux& operator=(const StreamMux&) = delete;
+
+        /******************************************************************************
+         * @brief   フレームを新しいストリームで送信待ちに追加
+         * @arg     cFrame     (in) 送信するフレーム（ヘッダ含む）
+         * @arg     unPriority (in) 優先度（0 が最優先）
+         * @return  ストリーム ID
+         * @note    送信は Flush で行う。フレームは参照のみ保持する
+         *****************************************************************************/
+        uint32_t Send(const SharedFrame& cFrame, uint8_t unPriority = 0) {
+            uint32_t unStreamId = m_unNextStreamId++;
+            if (m_unNextStreamId == 0) {
+                m_unNextStreamId = 1;
+            }
+            SendStream& stStream = m_mapSendStreams[unStreamId];
+            stStream.cFrame = cFrame;
+            stStream.unOffset = 0;
+            stStream.unWindow = m_stConfig.unInitialWindow;
+            m_mapReady[unPriority].push_back(unStreamId);
+            return unStreamId;
+        }
+
+        /******************************************************************************
+         * @brief   メッセージを新しいストリームで送信待ちに追加
+         * @arg     msgData    (in) 送信するメッセージ
+         * @arg     unPriority (in) 優先度（0 が最優先）
+         * @return  ストリーム ID
+         * @note
+         *****************************************************************************/
+        uint32_t SendMessage(const Message& msgData, uint8_t unPriority = 0) {
+            return Send(SharedFrame::Encode(msgData), unPriority);
+        }
+
+        /******************************************************************************
+         * @brief   チャンクを優先度順にノンブロッキングで送出
+         * @arg     なし
+         * @return  結果
+         * @retval  Ok=送れるチャンクがなくなった（窓待ちのストリームを含む）,
+         *          WouldBlock=ソケットバッファが満杯
+         * @note    ソケットの送信キューが空になるたびに次のチャンクを 1 つだけ積むため、
+         *          後から追加した高優先度のフレームは最大 1 チャンク分しか待たない。
+         *          書き込み可能イベントと、ReceiveAvailable の後に呼び出す。
+         *          送信エラー時は std::system_error を送出する
+         *****************************************************************************/
+        FlushResult Flush() {
+            for (;;) {
+                if (m_cSocket.FlushSendQueue() == FlushResult::WouldBlock) {
+                    return FlushResult::WouldBlock;
+                }
+                uint32_t unStreamId = 0;
+                uint8_t unPriority = 0;
+                if (!bSelectStream(unStreamId, unPriority)) {
+                    return FlushResult::Ok;
+                }
+                SendStream& stStream = m_mapSendStreams[unStreamId];
+                std::size_t unRemaining = stStream.cFrame.Size() - stStream.unOffset;
+                std::size_t unLength = std::min(std::min(unRemaining, m_stConfig.unChunkSize), stStream.unWindow);
+                bool bFinal = (unLength == unRemaining);
+                m_cSocket.EnqueueFrame(cBuildDataChunk(unStreamId, stStream.cFrame.Data() + stStream.unOffset,
+                                                       unLength, bFinal));
+                ++m_stStats.unChunksSent;
+                if (bFinal) {
+                    m_mapSendStreams.erase(unStreamId);
+                    ++m_stStats.unFramesSent;
+                    continue;
+                }
+                stStream.unOffset += unLength;
+                stStream.unWindow -= unLength;
+                if (stStream.unWindow == 0) {
+                    ++m_stStats.unWindowStalls;
+                }
+                m_mapReady[unPriority].push_back(unStreamId);
+            }
+        }
+
+        /******************************************************************************
+         * @brief   受信可能なチャンクをノンブロッキングで読み込み、フレームを組み立てる
+         * @arg     なし
+         * @return  結果
+         * @retval  Ok=読み込み完了（データなしを含む）, Closed=相手が切断
+         * @note    完成したフレームは PopFrame で取り出す。受け取ったチャンク分の
+         *          窓更新を返し、相手からの窓更新で送信を再開できる場合は Flush する。
+         *          受信エラー時は std::system_error、上限超過・不正なチャンクは
+         *          std::runtime_error を送出する
+         *****************************************************************************/
+        ReceiveResult ReceiveAvailable() {
+            ReceiveResult eResult = m_cSocket.ReceiveAvailable();
+            bool bFlush = false;
+            while (m_cSocket.PopFrame(m_vecChunk)) {
+                bFlush |= bProcessChunk(m_vecChunk);
+            }
+            if (bFlush && eResult == ReceiveResult::Ok) {
+                Flush();
+            }
+            return eResult;
+        }
+
+        /******************************************************************************
+         * @brief   組み立て済みのフレームを取り出す
+         * @arg     vecFrame (out) フレーム（ヘッダ含む）
+         * @return  結果 true:取り出した false:なし
+         * @note    ストリーム間の順序は最終チャンクの到着順
+         *****************************************************************************/
+        bool PopFrame(std::vector<uint8_t>& vecFrame) {
+            if (m_deqCompleted.empty()) {
+                return false;
+            }
+            vecFrame = std::move(m_deqCompleted.front());
+            m_deqCompleted.pop_front();
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   組み立て済みのメッセージを取り出す
+         * @arg     msgData (out) メッセージ
+         * @return  結果 true:取り出した false:なし
+         * @note    デコードエラー時は std::runtime_error を送出する
+         *****************************************************************************/
+        bool PopMessage(Message& msgData) {
+            std::vector<uint8_t> vecFrame;
+            if (!PopFrame(vecFrame)) {
+                return false;
+            }
+            msgData = DecodeMessage(vecFrame);
+            return true;
+        }
+
+        /******************************************************************************
+         * @brief   送信中のストリーム数の取得
+         * @arg     なし
+         * @return  ストリーム数（窓待ちを含む）
+         * @note
+         *****************************************************************************/
+        std::size_t GetSendStreams() const {
+            return m_mapSendStreams.size();
+        }
+
+        /******************************************************************************
+         * @brief   組み立て中の受信ストリーム数の取得
+         * @arg     なし
+         * @return  ストリーム数
+         * @note
+         *****************************************************************************/
+        std::size_t GetRecvStreams() const {
+            return m_mapRecvStreams.size();
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        const StreamMuxStats& GetStats() const {
+            return m_stStats;
+        }
+
+    private:
+        // 送信中のストリーム
+        struct SendStream {
+            SharedFrame cFrame;
+            std::size_t unOffset = 0;   // 送信済みバイト数
+            std::size_t unWindow = 0;   // 残りの送信窓
+        };
+
+        // 組み立て中の受信ストリーム
+        struct RecvStream {
+            std::vector<uint8_t> vecFrame;
+            std::size_t          unUnacked = 0;     // 窓更新をまだ返していないバイト数
+        };
+
+        /******************************************************************************
+         * @brief   次にチャンクを送るストリームの選択
+         * @arg     unStreamId (out) ストリーム ID
+         * @arg     unPriority (out) 優先度
+         * @return  結果 true:選択した false:送れるストリームなし
+         * @note    高優先度から順に、送信窓の残っているストリームを先頭から探す。
+         *          選んだストリームは待ち行列から外す（送り終えていなければ呼び出し側が末尾へ戻す）
+         *****************************************************************************/
+        bool bSelectStream(uint32_t& unStreamId, uint8_t& unPriority) {
+            for (auto itReady = m_mapReady.begin(); itReady != m_mapReady.end(); ) {
+                std::deque<uint32_t>& deqReady = itReady->second;
+                for (std::size_t unScan = deqReady.size(); unScan > 0; --unScan) {
+                    uint32_t unCandidate = deqReady.front();
+                    deqReady.pop_front();
+                    if (m_mapSendStreams[unCandidate].unWindow != 0) {
+                        unStreamId = unCandidate;
+                        unPriority = itReady->first;
+                        if (deqReady.empty()) {
+                            m_mapReady.erase(itReady);
+                        }
+                        return true;
+                    }
+                    deqReady.push_back(unCandidate);
+                }
+                if (deqReady.empty()) {
+                    itReady = m_mapReady.erase(itReady);
+                }
+                else {
+                    ++itReady;
+                }
+            }
+            return false;
+        }
+
+        /******************************************************************************
+         * @brief   受信フレーム 1 つの処理
+         * @arg     vecFrame (in) 受信フレーム
+         * @return  結果 true:送信窓が開いた false:その他
+         * @note
+         *****************************************************************************/
+        bool bProcessChunk(std::vector<uint8_t>& vecFrame) {
+            FieldView stStreamId;
+            if (!FindField(vecFrame, "$s", stStreamId)) {
+                // 多重化されていない通常フレーム
+                m_deqCompleted.push_back(std::move(vecFrame));
+                ++m_stStats.unFramesReceived;
+                return false;
+            }
+            uint32_t unStreamId = static_cast<uint32_t>(stStreamId.AsUInt64());
+            FieldView stField;
+            if (FindField(vecFrame, "$w", stField)) {
+                auto itStream = m_mapSendStreams.find(unStreamId);
+                if (itStream == m_mapSendStreams.end()) {
+                    return false;   // 送信済みのストリーム
+                }
+                bool bOpened = (itStream->second.unWindow == 0);
+                itStream->second.unWindow += static_cast<std::size_t>(stField.AsUInt64());
+                return bOpened;
+            }
+            if (!FindField(vecFrame, "$d", stField) || stField.eType != TYPE_BINARY) {
+                throw std::runtime_error("Invalid stream chunk");
+            }
+            ++m_stStats.unChunksReceived;
+            auto itStream = m_mapRecvStreams.find(unStreamId);
+            if (itStream == m_mapRecvStreams.end()) {
+                if (m_mapRecvStreams.size() >= m_stConfig.unMaxRecvStreams) {
+                    throw std::runtime_error("Too many concurrent streams");
+                }
+                itStream = m_mapRecvStreams.emplace(unStreamId, RecvStream()).first;
+            }
+            RecvStream& stStream = itStream->second;
+            if (stStream.vecFrame.empty() && stField.unSize >= k_unHeaderSize) {
+                // 先頭チャンクの長さヘッダから全体長を知り、組み立て中の再確保をなくす
+                uint32_t unNetPayloadLen = 0;
+                std::memcpy(&unNetPayloadLen, stField.pData, k_unHeaderSize);
+                std::size_t unFrameSize = k_unHeaderSize + ntohl(unNetPayloadLen);
+                if (m_stConfig.unMaxFrameSize != 0 && unFrameSize > m_stConfig.unMaxFrameSize) {
+                    throw std::runtime_error("Stream frame too large");
+                }
+                stStream.vecFrame.reserve(unFrameSize);
+            }
+            if (m_stConfig.unMaxFrameSize != 0 &&
+                stStream.vecFrame.size() + stField.unSize > m_stConfig.unMaxFrameSize) {
+                throw std::runtime_error("Stream frame too large");
+            }
+            stStream.vecFrame.insert(stStream.vecFrame.end(), stField.pData, stField.pData + stField.unSize);
+
+            FieldView stFinal;
+            if (FindField(vecFrame, "$e", stFinal)) {
+                std::vector<uint8_t> vecCompleted = std::move(stStream.vecFrame);
+                m_mapRecvStreams.erase(itStream);
+                if (!bIsCompleteFrame(vecCompleted)) {
+                    throw std::runtime_error("Invalid reassembled frame");
+                }
+                m_deqCompleted.push_back(std::move(vecCompleted));
+                ++m_stStats.unFramesReceived;
+                return false;
+            }
+            // 窓の半分を受け取るごとにクレジットを返す
+            stStream.unUnacked += stField.unSize;
+            if (stStream.unUnacked * 2 >= m_stConfig.unInitialWindow) {
+                m_cSocket.EnqueueFrame(cBuildWindowUpdate(unStreamId, stStream.unUnacked));
+                stStream.unUnacked = 0;
+                ++m_stStats.unWindowUpdates;
+                return true;    // 窓更新を送り出す
+            }
+            return false;
+        }
+
+        /******************************************************************************
+         * @brief   組み立てたフレームの長さヘッダ検証
+         * @arg     vecFrame (in) フレーム
+         * @return  結果 true:正常 false:不一致
+         * @note
+         *****************************************************************************/
+        static bool bIsCompleteFrame(const std::vector<uint8_t>& vecFrame) {
+            if (vecFrame.size() < k_unHeaderSize) {
+                return false;
+            }
+            uint32_t unNetPayloadLen = 0;
+            std::memcpy(&unNetPayloadLen, vecFrame.data(), k_unHeaderSize);
+            return (k_unHeaderSize + ntohl(unNetPayloadLen) == vecFrame.size());
+        }
+
+        /******************************************************************************
+         * @brief   キーと型コードの追加
+         * @arg     vecBuffer (in) バッファ
+         * @arg     pszKey    (in) キー（2 文字）
+         * @arg     eType     (in) 型コード
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vAppendKey(std::vector<uint8_t>& vecBuffer, const char* pszKey, ValueType eType) {
+            AppendBytes(vecBuffer, htons(static_cast<uint16_t>(2)));
+            vecBuffer.insert(vecBuffer.end(), pszKey, pszKey + 2);
+            vecBuffer.push_back(static_cast<uint8_t>(eType));
+        }
+
+        /******************************************************************************
+         * @brief   uint64 値のフィールドの追加
+         * @arg     vecBuffer (in) バッファ
+         * @arg     pszKey    (in) キー（2 文字）
+         * @arg     unValue   (in) 値
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vAppendUInt64(std::vector<uint8_t>& vecBuffer, const char* pszKey, uint64_t unValue) {
+            vAppendKey(vecBuffer, pszKey, TYPE_UINT64);
+            AppendBytes(vecBuffer, htonll(unValue));
+        }
+
+        /******************************************************************************
+         * @brief   ペイロード長ヘッダの書き込み
+         * @arg     vecBuffer (in) 先頭 k_unHeaderSize バイトを確保済みのバッファ
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vWriteHeader(std::vector<uint8_t>& vecBuffer) {
+            uint32_t unNetPayloadLen = htonl(static_cast<uint32_t>(vecBuffer.size() - k_unHeaderSize));
+            std::memcpy(vecBuffer.data(), &unNetPayloadLen, k_unHeaderSize);
+        }
+
+        /******************************************************************************
+         * @brief   データチャンクのフレーム長からデータ長を除いたバイト数
+         * @arg     なし
+         * @return  バイト数
+         * @note
+         *****************************************************************************/
+        static std::size_t unChunkOverhead() {
+            return k_unHeaderSize + 3 * (k_unKeyLengthSize + 2 + 1) + k_unBinaryLengthSize + 2 * k_unUInt64ValueSize;
+        }
+
+        /******************************************************************************
+         * @brief   データチャンクの生成
+         * @arg     unStreamId (in) ストリーム ID
+         * @arg     pData      (in) 断片の先頭
+         * @arg     unLength   (in) 断片の長さ
+         * @arg     bFinal     (in) true:最終チャンク
+         * @return  チャンクフレーム
+         * @note    EncodeMessage と同じキー順（"$d" "$e" "$s"）で直接組み立てる
+         *****************************************************************************/
+        static SharedFrame cBuildDataChunk(uint32_t unStreamId, const uint8_t* pData, std::size_t unLength,
+                                           bool bFinal) {
+            std::vector<uint8_t> vecChunk(k_unHeaderSize);
+            vecChunk.reserve(unChunkOverhead() + unLength);
+            vAppendKey(vecChunk, "$d", TYPE_BINARY);
+            AppendBytes(vecChunk, htonl(static_cast<uint32_t>(unLength)));
+            vecChunk.insert(vecChunk.end(), pData, pData + unLength);
+            if (bFinal) {
+                vAppendUInt64(vecChunk, "$e", 1);
+            }
+            vAppendUInt64(vecChunk, "$s", unStreamId);
+            vWriteHeader(vecChunk);
+            return SharedFrame(std::move(vecChunk));
+        }
+
+        /******************************************************************************
+         * @brief   窓更新の生成
+         * @arg     unStreamId (in) ストリーム ID
+         * @arg     unCredit   (in) 追加するクレジット(バイト)
+         * @return  窓更新フレーム
+         * @note
+         *****************************************************************************/
+        static SharedFrame cBuildWindowUpdate(uint32_t unStreamId, std::size_t unCredit) {
+            std::vector<uint8_t> vecUpdate(k_unHeaderSize);
+            vAppendUInt64(vecUpdate, "$s", unStreamId);
+            vAppendUInt64(vecUpdate, "$w", unCredit);
+            vWriteHeader(vecUpdate);
+            return SharedFrame(std::move(vecUpdate));
+        }
+
+        Socket&                                      m_cSocket;
+        StreamMuxConfig                              m_stConfig;
+        uint32_t                                     m_unNextStreamId;
+        std::unordered_map<uint32_t, SendStream>     m_mapSendStreams;
+        std::map<uint8_t, std::deque<uint32_t>>      m_mapReady;            // 優先度ごとの送信待ち
+        std::unordered_map<uint32_t, RecvStream>     m_mapRecvStreams;
+        std::deque<std::vector<uint8_t>>             m_deqCompleted;        // 組み立て済みフレーム
+        std::vector<uint8_t>                         m_vecChunk;            // 受信チャンクの作業領域
+        StreamMuxStats                               m_stStats;
+    };
+
+} // namespace sbdp
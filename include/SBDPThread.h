@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPThread.h
+ * @brief   SimpleBinaryDictionaryProtocol Thread Utilities
+ * @author  Satoh
+ * @note    ビジーポーリング用のスピン待ちヒントと CPU 固定
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace sbdp {
+
+    /******************************************************************************
+     * @brief   スピン待ちループ 1 回分のヒント
+     * @arg     なし
+     * @return  なし
+     * @note    x86 では PAUSE、AArch64 では YIELD を発行し、
+     *          同一コア上の他ハードウェアスレッドへ実行資源を譲る
+     *****************************************************************************/
+    inline void CpuRelax() {
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+    #elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+    #else
+        std::this_thread::yield();
+    #endif
+    }
+
+    /******************************************************************************
+     * @brief   呼び出し元スレッドを指定 CPU に固定
+     * @arg     unCpu (in) CPU 番号
+     * @return  結果 true:正常 false:異常（未対応環境を含む）
+     * @note    ビジーポーリングするスレッドを割り込み処理と同じ NUMA ノードの
+     *          専用コアへ固定すると、移動によるキャッシュミスを避けられる
+     *****************************************************************************/
+    inline bool PinCurrentThread(uint32_t unCpu) {
+    #if defined(_WIN32)
+        if (unCpu >= sizeof(DWORD_PTR) * 8) {
+            return false;
+        }
+        return (::SetThreadAffinityMask(::GetCurrentThread(),
+                                        static_cast<DWORD_PTR>(1) << unCpu) != 0);
+    #elif defined(__linux__)
+        if (unCpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t stCpuSet;
+        CPU_ZERO(&stCpuSet);
+        CPU_SET(unCpu, &stCpuSet);
+        return (::pthread_setaffinity_np(::pthread_self(), sizeof(stCpuSet), &stCpuSet) == 0);
+    #else
+        (void)unCpu;
+        return false;
+    #endif
+    }
+
+} // namespace sbdp
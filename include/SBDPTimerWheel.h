@@ -0,0 +1,337 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPTimerWheel.h
+ * @brief   SimpleBinaryDictionaryProtocol Hierarchical Timing Wheel
+ * @author  Satoh
+ * @note    接続ごとのタイムアウト用の階層タイミングホイール。
+ *          タイマーノードは接続オブジェクトに埋め込む侵入型リストで、
+ *          設定・取り消しはメモリ確保なしの O(1)
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace sbdp {
+
+    // ホイールの構成（1 段 256 スロット × 4 段 = 最大 2^32 ティック先まで）
+    constexpr uint32_t k_unTimerSlotBits  = 8;
+    constexpr uint32_t k_unTimerSlots     = 1U << k_unTimerSlotBits;
+    constexpr uint32_t k_unTimerLevels    = 4;
+    constexpr uint64_t k_unTimerMaxTicks  = (1ULL << (k_unTimerSlotBits * k_unTimerLevels)) - 1;
+
+    class TimerWheel;
+
+    // タイマーノード（所有オブジェクトに埋め込む。設定中に破棄した場合はホイールから外れる）
+    struct TimerNode {
+        TimerNode*            pRawPrev     = nullptr;   // nullptr:未設定
+        TimerNode*            pRawNext     = nullptr;
+        TimerWheel*           pRawWheel    = nullptr;   // 設定先のホイール（未設定・リスト先頭は nullptr）
+        uint64_t              unExpireTick = 0;
+        std::function<void()> fnCallback;               // 満了時の処理（設定は生成時に 1 回）
+
+        TimerNode() = default;
+        ~TimerNode();
+        TimerNode(const TimerNode&) = delete;
+        TimerNode& operator=(const TimerNode&) = delete;
+
+        /******************************************************************************
+         * @brief   設定中か判定
+         * @arg     なし
+         * @return  結果 true:設定中 false:未設定・満了済み
+         * @note
+         *****************************************************************************/
+        bool IsArmed() const {
+            return pRawPrev != nullptr;
+        }
+    };
+
+    // 階層タイミングホイール（スレッドセーフではない。イベントループのスレッドで使用する）
+    class TimerWheel {
+        friend struct TimerNode;
+
+    public:
+        /******************************************************************************
+         * @brief   コンストラクタ
+         * @arg     unTickMs (in) 1 ティックのミリ秒（0 は 1 とみなす）
+         * @arg     unNowMs  (in) 現在時刻(ミリ秒)
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        explicit TimerWheel(uint64_t unTickMs = 1, uint64_t unNowMs = 0)
+            : m_unTickMs(unTickMs == 0 ? 1 : unTickMs),
+              m_unCurrentTick(unNowMs / (unTickMs == 0 ? 1 : unTickMs)),
+              m_unArmedCount(0) {
+            for (uint32_t unLevel = 0; unLevel < k_unTimerLevels; ++unLevel) {
+                for (uint32_t unSlot = 0; unSlot < k_unTimerSlots; ++unSlot) {
+                    vInitList(m_stSlots[unLevel][unSlot]);
+                }
+            }
+        }
+
+        ~TimerWheel() {
+            for (uint32_t unLevel = 0; unLevel < k_unTimerLevels; ++unLevel) {
+                for (uint32_t unSlot = 0; unSlot < k_unTimerSlots; ++unSlot) {
+                    TimerNode& stHead = m_stSlots[unLevel][unSlot];
+                    while (stHead.pRawNext != &stHead) {
+                        vUnlink(*stHead.pRawNext);
+                    }
+                }
+            }
+        }
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        /******************************************************************************
+         * @brief   タイマーの設定
+         * @arg     stNode    (in) タイマーノード
+         * @arg     unDelayMs (in) 満了までのミリ秒
+         * @arg     unNowMs   (in) 現在時刻(ミリ秒)
+         * @return  なし
+         * @note    設定中のノードは再設定する。満了はティック単位に切り上げる。
+         *          Advance が現在時刻に追いついていなくても現在時刻から数える
+         *****************************************************************************/
+        void Arm(TimerNode& stNode, uint64_t unDelayMs, uint64_t unNowMs) {
+            if (stNode.IsArmed()) {
+                vUnlink(stNode);
+                --m_unArmedCount;
+            }
+            uint64_t unTicks = (unDelayMs + m_unTickMs - 1) / m_unTickMs;
+            if (unTicks == 0) {
+                unTicks = 1;
+            }
+            uint64_t unNowTick = std::max(m_unCurrentTick, unNowMs / m_unTickMs);
+            stNode.unExpireTick = unNowTick + std::min(unTicks, k_unTimerMaxTicks - (unNowTick - m_unCurrentTick));
+            vInsert(stNode);
+            ++m_unArmedCount;
+        }
+
+        /******************************************************************************
+         * @brief   タイマーの取り消し
+         * @arg     stNode (in) タイマーノード
+         * @return  なし
+         * @note    未設定のノードは何もしない
+         *****************************************************************************/
+        void Cancel(TimerNode& stNode) {
+            if (!stNode.IsArmed()) {
+                return;
+            }
+            vUnlink(stNode);
+            --m_unArmedCount;
+        }
+
+        /******************************************************************************
+         * @brief   現在時刻まで進め、満了したタイマーの処理を呼び出す
+         * @arg     unNowMs (in) 現在時刻(ミリ秒)
+         * @return  満了したタイマー数
+         * @note    処理の中でタイマーの設定・取り消しを行ってよい。
+         *          処理が例外を送出した場合はそこで止めて伝える（残りは次回の Advance で満了する）
+         *****************************************************************************/
+        std::size_t Advance(uint64_t unNowMs) {
+            uint64_t unTargetTick = unNowMs / m_unTickMs;
+            std::size_t unExpired = 0;
+            while (m_unCurrentTick < unTargetTick) {
+                if (m_unArmedCount == 0) {
+                    m_unCurrentTick = unTargetTick;
+                    break;
+                }
+                ++m_unCurrentTick;
+                vCascade();
+                unExpired += unExpireSlot(m_stSlots[0][m_unCurrentTick & (k_unTimerSlots - 1)]);
+            }
+            return unExpired;
+        }
+
+        /******************************************************************************
+         * @brief   次の満了までのミリ秒の取得
+         * @arg     unNowMs (in) 現在時刻(ミリ秒)
+         * @return  ミリ秒（-1:設定中のタイマーなし）
+         * @note    イベントループの待ち時間に使う。1 段目が空の場合は上位段の
+         *          繰り下げ時刻を返すため、実際の満了より早く起床することがある
+         *****************************************************************************/
+        int64_t GetNextTimeoutMs(uint64_t unNowMs) const {
+            if (m_unArmedCount == 0) {
+                return -1;
+            }
+            uint64_t unNowTick = unNowMs / m_unTickMs;
+            uint64_t unNextTick = (m_unCurrentTick | (k_unTimerSlots - 1)) + 1;   // 次の繰り下げ
+            for (uint64_t unTick = m_unCurrentTick + 1; unTick < unNextTick; ++unTick) {
+                const TimerNode& stHead = m_stSlots[0][unTick & (k_unTimerSlots - 1)];
+                if (stHead.pRawNext != &stHead) {
+                    unNextTick = unTick;
+                    break;
+                }
+            }
+            if (unNextTick <= unNowTick) {
+                return 0;
+            }
+            uint64_t unWaitMs = unNextTick * m_unTickMs - unNowMs;
+            return static_cast<int64_t>(unWaitMs);
+        }
+
+        /******************************************************************************
+         * @brief   設定中のタイマー数の取得
+         * @arg     なし
+         * @return  タイマー数
+         * @note
+         *****************************************************************************/
+        std::size_t GetArmedCount() const {
+            return m_unArmedCount;
+        }
+
+    private:
+        /******************************************************************************
+         * @brief   リストの先頭ノードの初期化（空の循環リスト）
+         * @arg     stHead (in) 先頭ノード
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vInitList(TimerNode& stHead) {
+            stHead.pRawPrev = &stHead;
+            stHead.pRawNext = &stHead;
+        }
+
+        /******************************************************************************
+         * @brief   リスト末尾へ連結
+         * @arg     stHead (in) 先頭ノード
+         * @arg     stNode (in) 連結するノード
+         * @return  なし
+         * @note
+         *****************************************************************************/
+        static void vLinkTail(TimerNode& stHead, TimerNode& stNode) {
+            stNode.pRawPrev = stHead.pRawPrev;
+            stNode.pRawNext = &stHead;
+            stHead.pRawPrev->pRawNext = &stNode;
+            stHead.pRawPrev = &stNode;
+        }
+
+        /******************************************************************************
+         * @brief   リストから切り離す
+         * @arg     stNode (in) 切り離すノード
+         * @return  なし
+         * @note    切り離したノードは未設定状態になる
+         *****************************************************************************/
+        static void vUnlink(TimerNode& stNode) {
+            stNode.pRawPrev->pRawNext = stNode.pRawNext;
+            stNode.pRawNext->pRawPrev = stNode.pRawPrev;
+            stNode.pRawPrev = nullptr;
+            stNode.pRawNext = nullptr;
+            stNode.pRawWheel = nullptr;
+        }
+
+        /******************************************************************************
+         * @brief   満了ティックに応じた段・スロットへ連結
+         * @arg     stNode (in) 連結するノード
+         * @return  なし
+         * @note    満了が近いほど下位段へ入る
+         *****************************************************************************/
+        void vInsert(TimerNode& stNode) {
+            uint64_t unDelta = stNode.unExpireTick - m_unCurrentTick;
+            uint32_t unLevel = 0;
+            while (unLevel + 1 < k_unTimerLevels &&
+                   unDelta >= (1ULL << (k_unTimerSlotBits * (unLevel + 1)))) {
+                ++unLevel;
+            }
+            uint64_t unSlot = (stNode.unExpireTick >> (k_unTimerSlotBits * unLevel)) & (k_unTimerSlots - 1);
+            vLinkTail(m_stSlots[unLevel][unSlot], stNode);
+            stNode.pRawWheel = this;
+        }
+
+        /******************************************************************************
+         * @brief   上位段のスロットを下位段へ繰り下げ
+         * @arg     なし
+         * @return  なし
+         * @note    現在ティックの下位ビットが 0 に戻った段ごとに、次の区間の
+         *          スロットを取り出して挿入し直す
+         *****************************************************************************/
+        void vCascade() {
+            for (uint32_t unLevel = 1; unLevel < k_unTimerLevels; ++unLevel) {
+                if ((m_unCurrentTick & ((1ULL << (k_unTimerSlotBits * unLevel)) - 1)) != 0) {
+                    return;
+                }
+                uint64_t unSlot = (m_unCurrentTick >> (k_unTimerSlotBits * unLevel)) & (k_unTimerSlots - 1);
+                TimerNode& stHead = m_stSlots[unLevel][unSlot];
+                while (stHead.pRawNext != &stHead) {
+                    TimerNode& stNode = *stHead.pRawNext;
+                    vUnlink(stNode);
+                    vInsert(stNode);
+                }
+            }
+        }
+
+        /******************************************************************************
+         * @brief   1 段目のスロットの全タイマーを満了させる
+         * @arg     stHead (in) スロットの先頭ノード
+         * @return  満了したタイマー数
+         * @note    一時リストへ移してから 1 件ずつ処理するため、処理中の
+         *          設定・取り消しでリストが壊れない。処理が例外を送出した場合、
+         *          未処理のタイマーは設定中のまま次のティックで満了するよう戻してから伝える
+         *****************************************************************************/
+        std::size_t unExpireSlot(TimerNode& stHead) {
+            if (stHead.pRawNext == &stHead) {
+                return 0;
+            }
+            TimerNode stExpired;
+            stExpired.pRawPrev = stHead.pRawPrev;
+            stExpired.pRawNext = stHead.pRawNext;
+            stExpired.pRawPrev->pRawNext = &stExpired;
+            stExpired.pRawNext->pRawPrev = &stExpired;
+            vInitList(stHead);
+
+            // 例外で抜けたときに一時リストへ残ったノードを戻す
+            struct RequeueGuard {
+                TimerWheel& cWheel;
+                TimerNode&  stExpired;
+                ~RequeueGuard() {
+                    while (stExpired.pRawNext != &stExpired) {
+                        TimerNode& stNode = *stExpired.pRawNext;
+                        vUnlink(stNode);
+                        stNode.unExpireTick = cWheel.m_unCurrentTick + 1;
+                        cWheel.vInsert(stNode);
+                    }
+                }
+            } stGuard {*this, stExpired};
+
+            std::size_t unExpired = 0;
+            while (stExpired.pRawNext != &stExpired) {
+                TimerNode& stNode = *stExpired.pRawNext;
+                vUnlink(stNode);
+                --m_unArmedCount;
+                ++unExpired;
+                if (stNode.fnCallback) {
+                    stNode.fnCallback();
+                }
+            }
+            return unExpired;
+        }
+
+        uint64_t    m_unTickMs;
+        uint64_t    m_unCurrentTick;
+        std::size_t m_unArmedCount;
+        TimerNode   m_stSlots[k_unTimerLevels][k_unTimerSlots];
+    };
+
+    /******************************************************************************
+     * @brief   デストラクタ
+     * @arg     なし
+     * @return  なし
+     * @note    設定中に破棄された場合はリストから外し、ホイールの設定数も減らす。
+     *          満了処理中のノード（自身のコールバック実行中）を破棄してはならない
+     *****************************************************************************/
+    inline TimerNode::~TimerNode() {
+        if (pRawPrev == nullptr) {
+            return;
+        }
+        pRawPrev->pRawNext = pRawNext;
+        pRawNext->pRawPrev = pRawPrev;
+        if (pRawWheel != nullptr) {
+            --pRawWheel->m_unArmedCount;
+        }
+    }
+
+} // namespace sbdp
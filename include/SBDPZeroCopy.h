@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LicenseRef-SBPD-1.0
+/******************************************************************************
+ * @file    SBDPZeroCopy.h
+ * @brief   SimpleBinaryDictionaryProtocol Zero-copy Send Tracker
+ * @author  Satoh
+ * @note    MSG_ZEROCOPY で送信したフレームの参照を、カーネルの完了通知を
+ *          受け取るまで保持する
+ * Copyright (c) 2026 Satoh(3103lab.com)
+ *****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "SBDPSharedFrame.h"
+
+namespace sbdp {
+
+    // ゼロコピー送信の統計
+    struct ZeroCopyStats {
+        uint64_t unSends       = 0;     // MSG_ZEROCOPY で送信したシステムコール数
+        uint64_t unCompletions = 0;     // 完了通知を受けた送信数
+        uint64_t unCopied      = 0;     // カーネルがコピー送信にフォールバックした送信数
+    };
+
+    // ゼロコピー送信の完了追跡
+    class ZeroCopyTracker {
+    public:
+        // 完了通知ハンドラ（送信番号の範囲と、コピーへのフォールバック有無）
+        using CompletionHandler = std::function<void(uint32_t unFirst, uint32_t unLast, bool bCopied)>;
+
+        ZeroCopyTracker() : m_unNextId(0), m_stStats() { }
+
+        /******************************************************************************
+         * @brief   送信の記録
+         * @arg     vecFrames (in) 送信に含まれたフレーム（完了まで参照を保持する）
+         * @return  送信番号（カーネルが送信ごとに振る番号と一致する）
+         * @note    MSG_ZEROCOPY 付きの送信が成功するたびに、送信順で呼び出すこと
+         *****************************************************************************/
+        uint32_t Record(std::vector<SharedFrame>&& vecFrames) {
+            uint32_t unId = m_unNextId++;
+            m_deqPending.push_back(Pending{unId, false, std::move(vecFrames)});
+            ++m_stStats.unSends;
+            return unId;
+        }
+
+        /******************************************************************************
+         * @brief   完了通知の反映
+         * @arg     unFirst (in) 完了した最初の送信番号
+         * @arg     unLast  (in) 完了した最後の送信番号
+         * @arg     bCopied (in) true:カーネルがコピー送信にフォールバックした
+         * @return  完了した送信数
+         * @note    範囲は送信番号の折り返しを考慮する。
+         *          先頭から連続して完了した送信のフレーム参照を解放する
+         *****************************************************************************/
+        std::size_t Complete(uint32_t unFirst, uint32_t unLast, bool bCopied) {
+            uint32_t unSpan = unLast - unFirst;
+            std::size_t unCompleted = 0;
+            for (Pending& stPending : m_deqPending) {
+                if (!stPending.bDone && static_cast<uint32_t>(stPending.unId - unFirst) <= unSpan) {
+                    stPending.bDone = true;
+                    ++unCompleted;
+                }
+            }
+            while (!m_deqPending.empty() && m_deqPending.front().bDone) {
+                m_deqPending.pop_front();
+            }
+            m_stStats.unCompletions += unCompleted;
+            if (bCopied) {
+                m_stStats.unCopied += unCompleted;
+            }
+            if (m_fnCompletion) {
+                m_fnCompletion(unFirst, unLast, bCopied);
+            }
+            return unCompleted;
+        }
+
+        /******************************************************************************
+         * @brief   完了通知ハンドラの設定
+         * @arg     fnCompletion (in) ハンドラ
+         * @return  なし
+         * @note    フレーム参照の解放後に呼び出される
+         *****************************************************************************/
+        void SetCompletionHandler(CompletionHandler fnCompletion) {
+            m_fnCompletion = std::move(fnCompletion);
+        }
+
+        /******************************************************************************
+         * @brief   完了待ちの送信数の取得
+         * @arg     なし
+         * @return  送信数（先頭が未完了のため解放を待っている送信を含む）
+         * @note
+         *****************************************************************************/
+        std::size_t GetPendingSends() const {
+            return m_deqPending.size();
+        }
+
+        /******************************************************************************
+         * @brief   統計の取得
+         * @arg     なし
+         * @return  統計
+         * @note
+         *****************************************************************************/
+        const ZeroCopyStats& GetStats() const {
+            return m_stStats;
+        }
+
+        /******************************************************************************
+         * @brief   完了待ちの送信の引き取り
+         * @arg     なし
+         * @return  完了待ちの送信と送信番号を引き継いだ追跡（ハンドラ・統計は引き継がない）
+         * @note    ソケットを閉じる際に使用する。送信番号はソケットごとに 0 から振られるため、
+         *          こちらは次のソケットに備えて 0 から数え直す
+         *****************************************************************************/
+        ZeroCopyTracker TakePending() {
+            ZeroCopyTracker cPending;
+            cPending.m_unNextId = m_unNextId;
+            cPending.m_deqPending.swap(m_deqPending);
+            m_unNextId = 0;
+            return cPending;
+        }
+
+    private:
+        struct Pending {
+            uint32_t                 unId;
+            bool                     bDone;
+            std::vector<SharedFrame> vecFrames;
+        };
+
+        uint32_t            m_unNextId;
+        std::deque<Pending> m_deqPending;
+        ZeroCopyStats       m_stStats;
+        CompletionHandler   m_fnCompletion;
+    };
+
+} // namespace sbdp